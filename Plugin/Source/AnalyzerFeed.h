@@ -0,0 +1,190 @@
+#pragma once
+
+#include <juce_core/juce_core.h>
+#include <atomic>
+#include <vector>
+
+//==============================================================================
+/**
+ * Audio thread -> analyzer thread feed
+ *
+ * Mono (L+R)/2 input-to-tape and final output, decimated to <= ~48kHz and
+ * written as aligned (input, output) frames into a single-producer /
+ * single-consumer juce::AbstractFifo. The audio thread never waits: when the
+ * FIFO is full the remaining frames of the block are dropped.
+ *
+ * Inactive (no analyzer open) the audio thread returns after one atomic load.
+ *
+ * Only the analyzer thread consumes from the FIFO, so prepare() never resets
+ * it: it bumps a generation count instead, and the analyzer discards what is
+ * queued (and its own history) when it sees the count change.
+ */
+class AnalyzerFeed
+{
+public:
+    static constexpr int fifoSize = 32768;
+
+    // Not concurrent with captureInput / pushOutput (prepareToPlay)
+    void prepare (double sampleRate, int maximumBlockSize)
+    {
+        // Decimate high host rates so the analysis bandwidth stays ~20kHz
+        decimation = juce::jmax (1, static_cast<int> (sampleRate / 44100.0));
+        analysisRate.store (sampleRate / decimation);
+
+        // 2nd-order Butterworth at 0.45 x the decimated Nyquist (only used when decimating)
+        const double w0 = juce::MathConstants<double>::twoPi * 0.45 * 0.5 / decimation;
+        const double cosw0 = std::cos (w0);
+        const double alpha = std::sin (w0) / (2.0 * 0.7071);
+        const double a0 = 1.0 + alpha;
+        antiAliasInput.setCoefficients ((1.0 - cosw0) / 2.0 / a0, (1.0 - cosw0) / a0, (1.0 - cosw0) / 2.0 / a0,
+                                        -2.0 * cosw0 / a0, (1.0 - alpha) / a0);
+        antiAliasOutput = antiAliasInput;
+
+        inputScratch.assign (static_cast<size_t> (maximumBlockSize / decimation + 1), 0.0f);
+
+        antiAliasInput.reset();
+        antiAliasOutput.reset();
+        phase = 0;
+        capturedFrames = 0;
+        generation.fetch_add (1);
+    }
+
+    // Message thread: the analyzer turns the feed on while it is open
+    void setActive (bool shouldBeActive)   { active.store (shouldBeActive); }
+    bool isActive() const                  { return active.load (std::memory_order_relaxed); }
+    double getAnalysisRate() const         { return analysisRate.load(); }
+
+    // Analyzer thread: changes on every prepare; frames queued before the
+    // change may be at the old rate
+    uint32_t getGeneration() const         { return generation.load(); }
+
+    // Audio thread: call with the input to tape (after trim), before processing
+    void captureInput (const float* left, const float* right, int numSamples)
+    {
+        capturedFrames = 0;
+        if (!isActive() || numSamples / decimation + 1 > static_cast<int> (inputScratch.size()))
+            return;
+
+        int inputPhase = phase;
+        capturedFrames = decimate (antiAliasInput, left, right, numSamples, inputPhase, inputScratch.data());
+    }
+
+    // Audio thread: call with the final output of the same block
+    void pushOutput (const float* left, const float* right, int numSamples)
+    {
+        if (capturedFrames == 0)
+            return;
+
+        float outputFrames[maxFramesPerWrite];
+        int written = 0;
+
+        // Same decimation phase as the input so the frames stay paired
+        int outputPhase = phase;
+        for (int offset = 0; offset < numSamples; offset += maxFramesPerWrite)
+        {
+            const int chunk = juce::jmin (maxFramesPerWrite, numSamples - offset);
+            const int frames = decimate (antiAliasOutput, left + offset,
+                                         right != nullptr ? right + offset : nullptr,
+                                         chunk, outputPhase, outputFrames);
+            const int count = juce::jmin (frames, capturedFrames - written);
+            write (inputScratch.data() + written, outputFrames, count);
+            written += count;
+        }
+
+        phase = outputPhase;
+        capturedFrames = 0;
+    }
+
+    // Analyzer thread: reads up to maxFrames aligned frames, returns the count
+    int pull (float* input, float* output, int maxFrames)
+    {
+        int start1, size1, start2, size2;
+        fifo.prepareToRead (maxFrames, start1, size1, start2, size2);
+
+        std::copy (inputBuffer + start1, inputBuffer + start1 + size1, input);
+        std::copy (outputBuffer + start1, outputBuffer + start1 + size1, output);
+        std::copy (inputBuffer + start2, inputBuffer + start2 + size2, input + size1);
+        std::copy (outputBuffer + start2, outputBuffer + start2 + size2, output + size1);
+
+        fifo.finishedRead (size1 + size2);
+        return size1 + size2;
+    }
+
+    // Analyzer thread: drops every queued frame
+    void discardQueued()
+    {
+        fifo.finishedRead (fifo.getNumReady());
+    }
+
+private:
+    static constexpr int maxFramesPerWrite = 512;
+
+    struct Biquad
+    {
+        double b0 = 1.0, b1 = 0.0, b2 = 0.0, a1 = 0.0, a2 = 0.0;
+        double z1 = 0.0, z2 = 0.0;
+
+        void setCoefficients (double nb0, double nb1, double nb2, double na1, double na2)
+        {
+            b0 = nb0; b1 = nb1; b2 = nb2; a1 = na1; a2 = na2;
+        }
+
+        void reset() { z1 = z2 = 0.0; }
+
+        float process (float input)
+        {
+            double output = b0 * input + z1;
+            z1 = b1 * input - a1 * output + z2;
+            z2 = b2 * input - a2 * output;
+            return static_cast<float> (output);
+        }
+    };
+
+    // Mono sum, anti-alias (when decimating) and keep every Nth sample
+    int decimate (Biquad& filter, const float* left, const float* right, int numSamples, int& decimationPhase, float* destination)
+    {
+        int frames = 0;
+        for (int i = 0; i < numSamples; ++i)
+        {
+            float mono = (right != nullptr) ? 0.5f * (left[i] + right[i]) : left[i];
+            if (decimation > 1)
+                mono = filter.process (mono);
+
+            if (decimationPhase == 0)
+                destination[frames++] = mono;
+            if (++decimationPhase == decimation)
+                decimationPhase = 0;
+        }
+        return frames;
+    }
+
+    void write (const float* input, const float* output, int numFrames)
+    {
+        if (numFrames <= 0)
+            return;
+
+        int start1, size1, start2, size2;
+        fifo.prepareToWrite (numFrames, start1, size1, start2, size2);
+
+        std::copy (input, input + size1, inputBuffer + start1);
+        std::copy (output, output + size1, outputBuffer + start1);
+        std::copy (input + size1, input + size1 + size2, inputBuffer + start2);
+        std::copy (output + size1, output + size1 + size2, outputBuffer + start2);
+
+        fifo.finishedWrite (size1 + size2);
+    }
+
+    juce::AbstractFifo fifo { fifoSize };
+    float inputBuffer[fifoSize] = {};
+    float outputBuffer[fifoSize] = {};
+
+    std::atomic<bool> active { false };
+    std::atomic<uint32_t> generation { 0 };
+    std::atomic<double> analysisRate { 48000.0 };
+    int decimation = 1;
+
+    Biquad antiAliasInput, antiAliasOutput;
+    int phase = 0;
+    std::vector<float> inputScratch;
+    int capturedFrames = 0;
+};
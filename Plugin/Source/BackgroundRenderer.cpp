@@ -0,0 +1,200 @@
+#include "BackgroundRenderer.h"
+
+//==============================================================================
+BackgroundRenderer::BackgroundRenderer (RenderFunction renderFunction)
+    : juce::Thread ("LowTHD Background Render"), render (std::move (renderFunction))
+{
+}
+
+BackgroundRenderer::~BackgroundRenderer()
+{
+    stop();
+}
+
+void BackgroundRenderer::prepare (int numChannelsToUse)
+{
+    stop();
+
+    numChannels = juce::jmax (1, numChannelsToUse);
+    inputRing.setSize (numChannels, fifoSize);
+    outputRing.setSize (numChannels, fifoSize);
+    chunk.setSize (numChannels, chunkSize);
+}
+
+void BackgroundRenderer::start()
+{
+    if (running || numChannels == 0)
+        return;
+
+    inputFifo.reset();
+    outputFifo.reset();
+    inputRing.clear();
+    outputRing.clear();
+
+    // Prime the output with the reported latency (the ring was just cleared)
+    int start1, size1, start2, size2;
+    outputFifo.prepareToWrite (latencySamples, start1, size1, start2, size2);
+    outputFifo.finishedWrite (size1 + size2);
+
+    framesOwed = 0;
+    silenceOwed = 0;
+    underruns.store (0);
+    outputReady.reset();
+
+    startThread (juce::Thread::Priority::high);
+    running = true;
+}
+
+void BackgroundRenderer::stop()
+{
+    if (!running)
+        return;
+
+    stopThread (1000);
+    running = false;
+}
+
+//==============================================================================
+void BackgroundRenderer::process (juce::AudioBuffer<float>& buffer, bool waitForWorker)
+{
+    const int numSamples = buffer.getNumSamples();
+
+    for (int start = 0; start < numSamples; start += maxFramesPerSwap)
+    {
+        const int numFrames = juce::jmin (maxFramesPerSwap, numSamples - start);
+        pushInput (buffer, start, numFrames);
+
+        // Offline: the output is always reachable (latencySamples >= chunkSize),
+        // the timeout only guards against a worker that has died
+        if (waitForWorker)
+        {
+            notify();
+            for (int attempt = 0; attempt < 100 && outputFifo.getNumReady() < framesOwed + numFrames; ++attempt)
+                outputReady.wait (50);
+        }
+
+        pullOutput (buffer, start, numFrames);
+    }
+}
+
+void BackgroundRenderer::pushInput (const juce::AudioBuffer<float>& buffer, int start, int numFrames)
+{
+    // A worker stalled for the whole ring: frames that don't fit are lost and
+    // go in as silence once there is room, so every later frame keeps its
+    // place on the timeline (and its output the reported latency)
+    if (silenceOwed > 0)
+    {
+        const int numSilent = juce::jmin (silenceOwed, inputFifo.getFreeSpace());
+        writeInput (nullptr, 0, numSilent);
+        silenceOwed -= numSilent;
+    }
+
+    const int numFitting = silenceOwed > 0 ? 0 : juce::jmin (numFrames, inputFifo.getFreeSpace());
+    silenceOwed += numFrames - numFitting;
+    writeInput (&buffer, start, numFitting);
+}
+
+void BackgroundRenderer::writeInput (const juce::AudioBuffer<float>* buffer, int start, int numFrames)
+{
+    if (numFrames == 0)
+        return;
+
+    int start1, size1, start2, size2;
+    inputFifo.prepareToWrite (numFrames, start1, size1, start2, size2);
+
+    for (int ch = 0; ch < numChannels; ++ch)
+    {
+        if (buffer != nullptr && ch < buffer->getNumChannels())
+        {
+            inputRing.copyFrom (ch, start1, *buffer, ch, start, size1);
+            inputRing.copyFrom (ch, start2, *buffer, ch, start + size1, size2);
+        }
+        else
+        {
+            inputRing.clear (ch, start1, size1);
+            inputRing.clear (ch, start2, size2);
+        }
+    }
+
+    inputFifo.finishedWrite (size1 + size2);
+}
+
+void BackgroundRenderer::pullOutput (juce::AudioBuffer<float>& buffer, int start, int numFrames)
+{
+    // Frames that already played as silence are dropped as soon as they exist
+    if (framesOwed > 0)
+    {
+        const int discarded = juce::jmin (framesOwed, outputFifo.getNumReady());
+        discardOutput (discarded);
+        framesOwed -= discarded;
+    }
+
+    int start1, size1, start2, size2;
+    outputFifo.prepareToRead (framesOwed > 0 ? 0 : numFrames, start1, size1, start2, size2);
+
+    const int available = size1 + size2;
+    const int channelsToCopy = juce::jmin (numChannels, buffer.getNumChannels());
+
+    for (int ch = 0; ch < channelsToCopy; ++ch)
+    {
+        buffer.copyFrom (ch, start, outputRing, ch, start1, size1);
+        buffer.copyFrom (ch, start + size1, outputRing, ch, start2, size2);
+    }
+
+    outputFifo.finishedRead (available);
+
+    // Worker behind: play silence, keep the timeline
+    const int missing = numFrames - available;
+    if (missing > 0)
+    {
+        for (int ch = 0; ch < buffer.getNumChannels(); ++ch)
+            buffer.clear (ch, start + available, missing);
+
+        framesOwed += missing;
+        underruns.fetch_add (missing);
+    }
+}
+
+void BackgroundRenderer::discardOutput (int numFrames)
+{
+    int start1, size1, start2, size2;
+    outputFifo.prepareToRead (numFrames, start1, size1, start2, size2);
+    outputFifo.finishedRead (size1 + size2);
+}
+
+//==============================================================================
+void BackgroundRenderer::run()
+{
+    juce::ScopedNoDenormals noDenormals;
+
+    while (!threadShouldExit())
+    {
+        if (inputFifo.getNumReady() < chunkSize || outputFifo.getFreeSpace() < chunkSize)
+        {
+            // Polled, so the audio thread never has to signal in realtime
+            wait (2);
+            continue;
+        }
+
+        int start1, size1, start2, size2;
+        inputFifo.prepareToRead (chunkSize, start1, size1, start2, size2);
+        for (int ch = 0; ch < numChannels; ++ch)
+        {
+            chunk.copyFrom (ch, 0, inputRing, ch, start1, size1);
+            chunk.copyFrom (ch, size1, inputRing, ch, start2, size2);
+        }
+        inputFifo.finishedRead (size1 + size2);
+
+        render (chunk);
+
+        outputFifo.prepareToWrite (chunkSize, start1, size1, start2, size2);
+        for (int ch = 0; ch < numChannels; ++ch)
+        {
+            outputRing.copyFrom (ch, start1, chunk, ch, 0, size1);
+            outputRing.copyFrom (ch, start2, chunk, ch, size1, size2);
+        }
+        outputFifo.finishedWrite (size1 + size2);
+
+        outputReady.signal();
+    }
+}
@@ -0,0 +1,90 @@
+#pragma once
+
+#include <juce_audio_basics/juce_audio_basics.h>
+#include <juce_core/juce_core.h>
+#include <functional>
+
+//==============================================================================
+/**
+ * Anticipative (high-latency) rendering for tracks nobody monitors live
+ *
+ * With a small host buffer the whole chain runs in tiny blocks on the host's
+ * realtime thread. In background mode the instance reports latencySamples of
+ * extra latency instead, and the audio thread only swaps samples through two
+ * lock-free rings:
+ *
+ *   audio thread:  block -> input ring          (then notifies the worker)
+ *   worker thread: input ring -> render (chunkSize frames) -> output ring
+ *   audio thread:  output ring -> block         (latencySamples later)
+ *
+ * The output ring is primed with latencySamples of silence, so the worker has
+ * that much headroom before the audio thread catches up with it. If it ever
+ * does (realtime only), the missing frames play as silence and are dropped
+ * from the ring once rendered, so the reported latency stays exact. Input
+ * that finds the ring full (a worker stalled for all of it) is rendered as
+ * silence in its place, for the same reason. Offline renders wait for the
+ * worker instead and are never lossy.
+ *
+ * prepare / start / stop must not overlap process() - call them from
+ * prepareToPlay / releaseResources or with processing suspended.
+ */
+class BackgroundRenderer : private juce::Thread
+{
+public:
+    static constexpr int latencySamples = 8192;
+    static constexpr int chunkSize = 2048;
+
+    // Renders one chunk in place; called on the worker thread only
+    using RenderFunction = std::function<void (juce::AudioBuffer<float>&)>;
+
+    explicit BackgroundRenderer (RenderFunction renderFunction);
+    ~BackgroundRenderer() override;
+
+    void prepare (int numChannelsToUse);
+    void start();
+    void stop();
+    bool isRunning() const { return running; }
+
+    // Audio thread: replace the block with the output rendered latencySamples
+    // ago. waitForWorker = true (offline) blocks until the frames exist.
+    void process (juce::AudioBuffer<float>& buffer, bool waitForWorker);
+
+    // Frames played as silence because the worker fell behind (since prepare)
+    int getUnderrunCount() const { return underruns.load(); }
+
+    // Rings and chunk allocated by prepare (telemetry footprint)
+    size_t getBufferBytes() const { return sizeof (float) * static_cast<size_t> (numChannels) * (2 * fifoSize + chunkSize); }
+
+private:
+    static constexpr int fifoSize = 4 * latencySamples;
+    static constexpr int maxFramesPerSwap = 1024;
+
+    void run() override;
+
+    void pushInput (const juce::AudioBuffer<float>& buffer, int start, int numFrames);
+    void writeInput (const juce::AudioBuffer<float>* buffer, int start, int numFrames);  // nullptr: silence
+    void pullOutput (juce::AudioBuffer<float>& buffer, int start, int numFrames);
+    void discardOutput (int numFrames);
+
+    RenderFunction render;
+    int numChannels = 0;
+    bool running = false;
+
+    // Rings: the audio thread writes input / reads output, the worker the reverse
+    juce::AbstractFifo inputFifo { fifoSize };
+    juce::AbstractFifo outputFifo { fifoSize };
+    juce::AudioBuffer<float> inputRing, outputRing;
+
+    // Worker thread state
+    juce::AudioBuffer<float> chunk;
+
+    // Audio thread state: frames played as silence, still to be dropped, and
+    // input frames lost to a full ring, still to be pushed as silence
+    int framesOwed = 0;
+    int silenceOwed = 0;
+
+    juce::WaitableEvent outputReady;
+    std::atomic<int> underruns { 0 };
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (BackgroundRenderer)
+};
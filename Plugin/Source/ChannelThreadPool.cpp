@@ -0,0 +1,109 @@
+#include "ChannelThreadPool.h"
+
+//==============================================================================
+ChannelThreadPool::Worker::Worker (ChannelThreadPool& ownerToUse)
+    : juce::Thread ("LowTHD Channel Worker"), owner (ownerToUse)
+{
+}
+
+void ChannelThreadPool::Worker::run()
+{
+    juce::ScopedNoDenormals noDenormals;
+
+    while (!threadShouldExit())
+    {
+        wait (-1);
+
+        if (threadShouldExit())
+            break;
+
+        owner.runTasks();
+    }
+}
+
+//==============================================================================
+ChannelThreadPool::~ChannelThreadPool()
+{
+    release();
+}
+
+void ChannelThreadPool::prepare (int numWorkers)
+{
+    numWorkers = juce::jmax (0, numWorkers);
+    if (numWorkers == getNumWorkers())
+        return;
+
+    release();
+
+    for (int i = 0; i < numWorkers; ++i)
+    {
+        workers.push_back (std::make_unique<Worker> (*this));
+        workers.back()->startThread();
+    }
+}
+
+void ChannelThreadPool::release()
+{
+    for (auto& worker : workers)
+        worker->signalThreadShouldExit();
+
+    for (auto& worker : workers)
+    {
+        worker->notify();
+        worker->stopThread (1000);
+    }
+
+    workers.clear();
+}
+
+//==============================================================================
+void ChannelThreadPool::runErased (int numTasks, TaskFunction function, void* context)
+{
+    if (numTasks <= 0)
+        return;
+
+    {
+        const juce::ScopedLock scopedLock (lock);
+        taskFunction = function;
+        taskContext = context;
+        taskCount = numTasks;
+        nextTask = 0;
+        pendingTasks.store (numTasks);
+    }
+
+    // One wake-up per task beyond the caller's own
+    const int numToWake = juce::jmin (getNumWorkers(), numTasks - 1);
+    for (int i = 0; i < numToWake; ++i)
+        workers[static_cast<size_t> (i)]->notify();
+
+    runTasks();
+
+    // Re-checked after every wake: a late signal from an earlier run is harmless
+    while (pendingTasks.load() > 0)
+        allDone.wait (1);
+}
+
+void ChannelThreadPool::runTasks()
+{
+    for (;;)
+    {
+        TaskFunction function;
+        void* context;
+        int index;
+
+        {
+            const juce::ScopedLock scopedLock (lock);
+            if (nextTask >= taskCount)
+                return;
+
+            function = taskFunction;
+            context = taskContext;
+            index = nextTask++;
+        }
+
+        function (context, index);
+
+        if (pendingTasks.fetch_sub (1) == 1)
+            allDone.signal();
+    }
+}
@@ -0,0 +1,65 @@
+#pragma once
+
+#include <juce_core/juce_core.h>
+#include <memory>
+#include <vector>
+
+//==============================================================================
+/**
+ * Small fork/join pool for independent per-channel work
+ *
+ * run (numTasks, task) calls task (0 .. numTasks - 1) and returns once every
+ * call has finished. The calling thread works too: it and the idle workers
+ * pull indices from one shared counter until none are left, so an uneven
+ * split (a channel that costs more, a worker that wakes late) balances
+ * itself. With no workers everything simply runs on the caller.
+ *
+ * Waking workers and claiming indices take locks - meant for offline
+ * renders with big blocks, never for the realtime path.
+ * Workers run with flush-to-zero set (the FP environment is per thread).
+ */
+class ChannelThreadPool
+{
+public:
+    ChannelThreadPool() = default;
+    ~ChannelThreadPool();
+
+    // Spawns / joins workers; never while run() is in progress
+    void prepare (int numWorkers);
+    void release();
+    int getNumWorkers() const { return static_cast<int> (workers.size()); }
+
+    template <typename Task>
+    void run (int numTasks, Task& task)
+    {
+        runErased (numTasks, [] (void* context, int index) { (*static_cast<Task*> (context)) (index); }, &task);
+    }
+
+private:
+    using TaskFunction = void (*) (void* context, int index);
+
+    struct Worker : public juce::Thread
+    {
+        explicit Worker (ChannelThreadPool& ownerToUse);
+        void run() override;
+
+        ChannelThreadPool& owner;
+    };
+
+    void runErased (int numTasks, TaskFunction function, void* context);
+    void runTasks();
+
+    std::vector<std::unique_ptr<Worker>> workers;
+
+    // Current job (guarded by lock; index claims go through it too)
+    juce::CriticalSection lock;
+    TaskFunction taskFunction = nullptr;
+    void* taskContext = nullptr;
+    int taskCount = 0;
+    int nextTask = 0;
+
+    std::atomic<int> pendingTasks { 0 };
+    juce::WaitableEvent allDone;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (ChannelThreadPool)
+};
@@ -0,0 +1,84 @@
+#pragma once
+
+#include <juce_core/juce_core.h>
+#include <atomic>
+#include "DSP/HybridTapeProcessor.h"
+
+//==============================================================================
+/**
+ * Audio thread -> B-H view feed
+ *
+ * Decimated snapshots of the left channel's core state (J-A field H,
+ * magnetization M, level envelope and the two blend amounts), taken in the
+ * oversampled loop and written into a single-producer / single-consumer
+ * juce::AbstractFifo. Every snapshot is a point on the loop, so plain
+ * decimation (no filtering) keeps the drawn curve exact.
+ *
+ * ~9600 points/s: about 320 per 30Hz frame. Inactive (view hidden) the audio
+ * thread reads one atomic per block and the core is never queried.
+ */
+class HysteresisProbe
+{
+public:
+    static constexpr int fifoSize = 4096;
+    static constexpr double pointsPerSecond = 9600.0;
+
+    struct Point
+    {
+        float H = 0.0f;
+        float M = 0.0f;
+        float envelope = 0.0f;
+        float jaBlend = 0.0f;
+        float atanBlend = 0.0f;
+    };
+
+    void prepare (double oversampledRate)
+    {
+        decimation = juce::jmax (1, juce::roundToInt (oversampledRate / pointsPerSecond));
+        reset();
+    }
+
+    void reset()
+    {
+        countdown = 0;
+        fifo.reset();
+    }
+
+    // Message thread: the view turns the probe on while it is showing
+    void setActive (bool shouldBeActive)   { active.store (shouldBeActive); }
+    bool isActive() const                  { return active.load (std::memory_order_relaxed); }
+
+    // Audio thread: call after each oversampled sample while active
+    void capture (const TapeHysteresis::HybridTapeProcessor& processor)
+    {
+        if (--countdown > 0)
+            return;
+        countdown = decimation;
+
+        if (fifo.getFreeSpace() == 0)
+            return;  // View is behind - drop rather than wait
+
+        const auto state = processor.getProbeState();
+        const auto scope = fifo.write (1);
+        points[scope.startIndex1] = { static_cast<float> (state.H), static_cast<float> (state.M),
+                                      static_cast<float> (state.envelope),
+                                      static_cast<float> (state.jaBlend), static_cast<float> (state.atanBlend) };
+    }
+
+    // Message thread: reads up to maxPoints, returns the count
+    int pull (Point* destination, int maxPoints)
+    {
+        const auto scope = fifo.read (juce::jmin (maxPoints, fifo.getNumReady()));
+        std::copy (points + scope.startIndex1, points + scope.startIndex1 + scope.blockSize1, destination);
+        std::copy (points + scope.startIndex2, points + scope.startIndex2 + scope.blockSize2, destination + scope.blockSize1);
+        return scope.blockSize1 + scope.blockSize2;
+    }
+
+private:
+    juce::AbstractFifo fifo { fifoSize };
+    Point points[fifoSize] = {};
+
+    std::atomic<bool> active { false };
+    int decimation = 10;
+    int countdown = 0;
+};
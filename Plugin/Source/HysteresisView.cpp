@@ -0,0 +1,127 @@
+#include "HysteresisView.h"
+
+//==============================================================================
+HysteresisView::HysteresisView (HysteresisProbe& probeToUse)
+    : probe (probeToUse)
+{
+    history.resize (displayPoints);
+    incoming.resize (HysteresisProbe::fifoSize);
+    setOpaque (true);
+}
+
+HysteresisView::~HysteresisView()
+{
+    stopProbe();
+}
+
+void HysteresisView::visibilityChanged()
+{
+    if (isVisible())
+        startProbe();
+    else
+        stopProbe();
+}
+
+void HysteresisView::startProbe()
+{
+    numValid = 0;
+    writeIndex = 0;
+    probe.setActive (true);
+    startTimerHz (refreshRateHz);
+}
+
+void HysteresisView::stopProbe()
+{
+    stopTimer();
+    probe.setActive (false);
+
+    // Discard anything left so a later start shows only fresh points
+    probe.pull (incoming.data(), HysteresisProbe::fifoSize);
+}
+
+//==============================================================================
+void HysteresisView::timerCallback()
+{
+    const int count = probe.pull (incoming.data(), static_cast<int> (incoming.size()));
+    if (count == 0)
+        return;
+
+    // Only the newest displayPoints can be drawn
+    for (int i = juce::jmax (0, count - displayPoints); i < count; ++i)
+    {
+        history[static_cast<size_t> (writeIndex)] = incoming[static_cast<size_t> (i)];
+        writeIndex = (writeIndex + 1) % displayPoints;
+    }
+    numValid = juce::jmin (displayPoints, numValid + count);
+
+    float peakH = 0.0f, peakM = 0.0f;
+    for (int i = 0; i < numValid; ++i)
+    {
+        peakH = juce::jmax (peakH, std::abs (history[static_cast<size_t> (i)].H));
+        peakM = juce::jmax (peakM, std::abs (history[static_cast<size_t> (i)].M));
+    }
+
+    auto track = [] (float& range, float peak)
+    {
+        range = juce::jmax (1.0e-3f, peak > range ? peak : 0.95f * range + 0.05f * peak);
+    };
+    track (rangeH, peakH);
+    track (rangeM, peakM);
+
+    repaint();
+}
+
+void HysteresisView::paint (juce::Graphics& g)
+{
+    const auto bounds = getLocalBounds().toFloat();
+    const auto plot = bounds.reduced (6.0f, 16.0f);
+
+    g.fillAll (juce::Colour (0xff1e1e1e));
+
+    // Axes through the origin
+    g.setColour (juce::Colours::white.withAlpha (0.08f));
+    g.drawVerticalLine (juce::roundToInt (plot.getCentreX()), plot.getY(), plot.getBottom());
+    g.drawHorizontalLine (juce::roundToInt (plot.getCentreY()), plot.getX(), plot.getRight());
+
+    g.setFont (juce::FontOptions (10.0f));
+    auto textArea = bounds.reduced (6.0f, 2.0f).removeFromTop (12.0f);
+
+    if (numValid < 2)
+    {
+        g.setColour (juce::Colours::white.withAlpha (0.7f));
+        g.drawText ("B-H: waiting for signal", textArea, juce::Justification::centredLeft);
+        return;
+    }
+
+    // Oldest -> newest, 10% headroom on each axis
+    const float scaleX = 0.45f * plot.getWidth() / rangeH;
+    const float scaleY = 0.45f * plot.getHeight() / rangeM;
+    const int oldest = (numValid < displayPoints) ? 0 : writeIndex;
+
+    juce::Path loop;
+    for (int i = 0; i < numValid; ++i)
+    {
+        const auto& point = history[static_cast<size_t> ((oldest + i) % displayPoints)];
+        const float x = plot.getCentreX() + point.H * scaleX;
+        const float y = plot.getCentreY() - point.M * scaleY;
+        if (i == 0)
+            loop.startNewSubPath (x, y);
+        else
+            loop.lineTo (x, y);
+    }
+
+    g.setColour (loopColour);
+    g.strokePath (loop, juce::PathStrokeType (1.2f));
+
+    // Readout from the newest point
+    const auto& latest = history[static_cast<size_t> ((oldest + numValid - 1) % displayPoints)];
+    g.setColour (loopColour);
+    g.drawText ("M vs H  (H +/-" + juce::String (rangeH, 3) + ", M +/-" + juce::String (rangeM, 4) + ")",
+                textArea, juce::Justification::centredLeft);
+
+    g.setColour (juce::Colours::white.withAlpha (0.7f));
+    g.drawText ("Env " + juce::String (juce::Decibels::gainToDecibels (latest.envelope, -96.0f), 1) + " dB"
+                    + "   J-A " + juce::String (juce::roundToInt (100.0f * latest.jaBlend)) + "%"
+                    + "   Atan " + juce::String (juce::roundToInt (100.0f * latest.atanBlend)) + "%",
+                textArea, juce::Justification::centredRight);
+}
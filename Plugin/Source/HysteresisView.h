@@ -0,0 +1,51 @@
+#pragma once
+
+#include <juce_gui_basics/juce_gui_basics.h>
+#include "HysteresisProbe.h"
+
+//==============================================================================
+/**
+ * Live hysteresis loop (H -> M) of the left channel's J-A core
+ *
+ * Draws the most recent displayPoints decimated (H, M) pairs from the
+ * processor's HysteresisProbe as a polyline, auto-scaled per axis, with the
+ * level envelope and J-A / atan blend amounts as a readout. Used to set drive
+ * by eye: a thin diagonal is the clean region, the loop opens and bends as
+ * the J-A and atan stages engage.
+ *
+ * The probe is only active while this component is showing.
+ */
+class HysteresisView : public juce::Component,
+                       private juce::Timer
+{
+public:
+    explicit HysteresisView (HysteresisProbe& probeToUse);
+    ~HysteresisView() override;
+
+    void paint (juce::Graphics&) override;
+    void visibilityChanged() override;
+
+private:
+    static constexpr int displayPoints = 384;
+    static constexpr int refreshRateHz = 30;
+
+    void timerCallback() override;
+    void startProbe();
+    void stopProbe();
+
+    HysteresisProbe& probe;
+
+    // Last displayPoints points (circular, oldest at writeIndex)
+    std::vector<HysteresisProbe::Point> history;
+    std::vector<HysteresisProbe::Point> incoming;
+    int writeIndex = 0;
+    int numValid = 0;
+
+    // Axis ranges: instant attack, slow release so the loop doesn't jitter
+    float rangeH = 1.0e-3f;
+    float rangeM = 1.0e-3f;
+
+    juce::Colour loopColour { 0xffcc8844 };
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (HysteresisView)
+};
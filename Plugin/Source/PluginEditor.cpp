@@ -3,7 +3,8 @@
 
 //==============================================================================
 LowTHDTapeSimulatorAudioProcessorEditor::LowTHDTapeSimulatorAudioProcessorEditor (LowTHDTapeSimulatorAudioProcessor& p)
-    : AudioProcessorEditor (&p), audioProcessor (p)
+    : AudioProcessorEditor (&p), audioProcessor (p), analyzer (p.getAnalyzerFeed()),
+      hysteresisView (p.getHysteresisProbe())
 {
     // Define color scheme (vintage tape aesthetic)
     backgroundColour = juce::Colour (0xff2b2b2b);  // Dark grey
@@ -83,11 +84,69 @@ LowTHDTapeSimulatorAudioProcessorEditor::LowTHDTapeSimulatorAudioProcessorEditor
         outputTrimSlider
     );
 
+    // Tape Hiss toggle
+    hissToggle.setButtonText ("Hiss");
+    hissToggle.setColour (juce::ToggleButton::textColourId, textColour);
+    hissToggle.setColour (juce::ToggleButton::tickColourId, accentColour);
+    hissToggle.setColour (juce::ToggleButton::tickDisabledColourId, backgroundColour.brighter (0.4f));
+    addAndMakeVisible (hissToggle);
+
+    hissAttachment = std::make_unique<juce::AudioProcessorValueTreeState::ButtonAttachment> (
+        audioProcessor.getValueTreeState(),
+        LowTHDTapeSimulatorAudioProcessor::PARAM_HISS,
+        hissToggle
+    );
+
+    // Background Render toggle
+    backgroundToggle.setButtonText ("Background");
+    backgroundToggle.setColour (juce::ToggleButton::textColourId, textColour);
+    backgroundToggle.setColour (juce::ToggleButton::tickColourId, accentColour);
+    backgroundToggle.setColour (juce::ToggleButton::tickDisabledColourId, backgroundColour.brighter (0.4f));
+    addAndMakeVisible (backgroundToggle);
+
+    backgroundAttachment = std::make_unique<juce::AudioProcessorValueTreeState::ButtonAttachment> (
+        audioProcessor.getValueTreeState(),
+        LowTHDTapeSimulatorAudioProcessor::PARAM_BACKGROUND,
+        backgroundToggle
+    );
+
+    // Cross-Instance Batch toggle
+    batchToggle.setButtonText ("Batch");
+    batchToggle.setColour (juce::ToggleButton::textColourId, textColour);
+    batchToggle.setColour (juce::ToggleButton::tickColourId, accentColour);
+    batchToggle.setColour (juce::ToggleButton::tickDisabledColourId, backgroundColour.brighter (0.4f));
+    addAndMakeVisible (batchToggle);
+
+    batchAttachment = std::make_unique<juce::AudioProcessorValueTreeState::ButtonAttachment> (
+        audioProcessor.getValueTreeState(),
+        LowTHDTapeSimulatorAudioProcessor::PARAM_BATCH,
+        batchToggle
+    );
+
+    addAndMakeVisible (analyzer);
+    addChildComponent (hysteresisView);
+
+    // Spectrum <-> B-H toggle: hiding one stops its feed
+    hysteresisViewButton.setButtonText ("B-H");
+    hysteresisViewButton.setClickingTogglesState (true);
+    hysteresisViewButton.setColour (juce::TextButton::buttonOnColourId, accentColour);
+    hysteresisViewButton.onClick = [this]
+    {
+        const bool showLoop = hysteresisViewButton.getToggleState();
+        analyzer.setVisible (!showLoop);
+        hysteresisView.setVisible (showLoop);
+    };
+    addAndMakeVisible (hysteresisViewButton);
+
+    // Background is fully painted from the cache - no need to repaint the host behind us
+    setOpaque (true);
+
     // Set window size
-    setSize (500, 400);
+    setSize (560, 520);
 
-    // Start timer for meter updates (30 fps)
-    startTimerHz (30);
+    // Start timer for meter updates (30 fps, throttled when idle or hidden)
+    lastTimerMs = juce::Time::getMillisecondCounterHiRes();
+    setTimerRate (activeRateHz);
 }
 
 LowTHDTapeSimulatorAudioProcessorEditor::~LowTHDTapeSimulatorAudioProcessorEditor()
@@ -126,8 +185,45 @@ juce::Colour LowTHDTapeSimulatorAudioProcessorEditor::getMeterColour (float leve
     return juce::Colour (0xffff0000);  // Red
 }
 
-void LowTHDTapeSimulatorAudioProcessorEditor::paint (juce::Graphics& g)
+int LowTHDTapeSimulatorAudioProcessorEditor::getMeterFillWidth (float levelDB) const
+{
+    // Meter fill scale from -48dB to -6dB
+    // This covers well below 0 VU (-18dBFS) up to hot digital levels
+    const float minDB = -48.0f;
+    const float maxDB = -6.0f;
+    float normalizedLevel = juce::jlimit (0.0f, 1.0f, juce::jmap (levelDB, minDB, maxDB, 0.0f, 1.0f));
+
+    if (normalizedLevel <= 0.001f)
+        return 0;
+
+    return juce::roundToInt (meterBounds.reduced (4.0f).getWidth() * normalizedLevel);
+}
+
+juce::Rectangle<float> LowTHDTapeSimulatorAudioProcessorEditor::getMeterBarBounds (int channel) const
 {
+    // L on top, R below, 1px gap
+    auto inner = meterBounds.reduced (4.0f);
+    const float barHeight = (inner.getHeight() - 1.0f) / numMeterChannels;
+    return inner.withHeight (barHeight).translated (0.0f, channel * (barHeight + 1.0f));
+}
+
+juce::String LowTHDTapeSimulatorAudioProcessorEditor::getMeterText() const
+{
+    return "L " + juce::String (meterLevel[0], 1)
+         + "   R " + juce::String (meterLevel[1], 1)
+         + "   RMS " + juce::String (rmsLevel, 1)
+         + "   TP " + juce::String (truePeakLevel, 1) + " dB";
+}
+
+void LowTHDTapeSimulatorAudioProcessorEditor::renderBackgroundCache (float scale)
+{
+    backgroundCache = juce::Image (juce::Image::RGB,
+                                   juce::jmax (1, juce::roundToInt (getWidth() * scale)),
+                                   juce::jmax (1, juce::roundToInt (getHeight() * scale)),
+                                   false);
+    juce::Graphics g (backgroundCache);
+    g.addTransform (juce::AffineTransform::scale (scale));
+
     // Background gradient
     juce::ColourGradient gradient (
         backgroundColour.brighter (0.1f), 0.0f, 0.0f,
@@ -145,7 +241,6 @@ void LowTHDTapeSimulatorAudioProcessorEditor::paint (juce::Graphics& g)
     g.setColour (accentColour.withAlpha (0.2f));
     g.drawLine (20.0f, 70.0f, static_cast<float> (getWidth() - 20), 70.0f, 1.0f);
 
-    // Draw PPM meter if bounds are set
     if (!meterBounds.isEmpty())
     {
         // Meter background
@@ -155,27 +250,40 @@ void LowTHDTapeSimulatorAudioProcessorEditor::paint (juce::Graphics& g)
         // Meter border
         g.setColour (accentColour.withAlpha (0.4f));
         g.drawRoundedRectangle (meterBounds, 4.0f, 2.0f);
+    }
+}
+
+void LowTHDTapeSimulatorAudioProcessorEditor::paint (juce::Graphics& g)
+{
+    // Static chrome from the cache (re-rendered on resize or display scale change)
+    const float scale = g.getInternalContext().getPhysicalPixelScaleFactor();
+    if (backgroundCache.isNull()
+        || backgroundCache.getWidth() != juce::jmax (1, juce::roundToInt (getWidth() * scale))
+        || backgroundCache.getHeight() != juce::jmax (1, juce::roundToInt (getHeight() * scale)))
+        renderBackgroundCache (scale);
 
-        // Meter fill (based on level) - scale from -48dB to -6dB range
-        // This covers well below 0 VU (-18dBFS) up to hot digital levels
-        const float minDB = -48.0f;
-        const float maxDB = -6.0f;
-        float normalizedLevel = juce::jmap (meterLevel, minDB, maxDB, 0.0f, 1.0f);
-        normalizedLevel = juce::jlimit (0.0f, 1.0f, normalizedLevel);
+    g.drawImage (backgroundCache, getLocalBounds().toFloat());
 
-        if (normalizedLevel > 0.001f)
+    // Dynamic part of the PPM meter
+    if (!meterBounds.isEmpty())
+    {
+        for (int ch = 0; ch < numMeterChannels; ++ch)
         {
-            g.setColour (getMeterColour (meterLevel));
-            auto fillBounds = meterBounds.reduced (4.0f);
-            float fillWidth = fillBounds.getWidth() * normalizedLevel;
-            fillBounds.setWidth (fillWidth);
-            g.fillRoundedRectangle (fillBounds, 2.0f);
+            const int fillWidth = getMeterFillWidth (meterLevel[ch]);
+
+            if (fillWidth > 0)
+            {
+                g.setColour (getMeterColour (meterLevel[ch]));
+                auto fillBounds = getMeterBarBounds (ch);
+                fillBounds.setWidth (static_cast<float> (fillWidth));
+                g.fillRoundedRectangle (fillBounds, 2.0f);
+            }
         }
 
         // Draw level marker text
         g.setColour (textColour.withAlpha (0.8f));
         g.setFont (juce::FontOptions (10.0f));
-        g.drawText (juce::String (meterLevel, 1) + " dB",
+        g.drawText (getMeterText(),
                     meterBounds.toNearestInt(),
                     juce::Justification::centred);
     }
@@ -199,6 +307,10 @@ void LowTHDTapeSimulatorAudioProcessorEditor::resized()
     auto machineModeArea = controlArea.removeFromTop (controlHeight + 10);
     machineModeLabel.setBounds (machineModeArea.removeFromLeft (80));
     machineModeCombo.setBounds (machineModeArea.removeFromLeft (120));
+    hissToggle.setBounds (machineModeArea.removeFromRight (80));
+    backgroundToggle.setBounds (machineModeArea.removeFromRight (105));
+    batchToggle.setBounds (machineModeArea.removeFromRight (70));
+    hysteresisViewButton.setBounds (machineModeArea.removeFromRight (50).reduced (0, 8));
 
     controlArea.removeFromTop (15);  // Spacing
 
@@ -220,21 +332,88 @@ void LowTHDTapeSimulatorAudioProcessorEditor::resized()
     // PPM Meter (horizontal bar)
     auto meterArea = controlArea.removeFromTop (40);
     meterBounds = meterArea.reduced (10, 5).toFloat();
+
+    controlArea.removeFromTop (10);  // Spacing
+
+    // Spectrum analyzer
+    analyzer.setBounds (controlArea.removeFromTop (170).reduced (10, 0));
+    hysteresisView.setBounds (analyzer.getBounds());
+
+    backgroundCache = {};
+    displayedFillWidth[0] = displayedFillWidth[1] = -1;
 }
 
-void LowTHDTapeSimulatorAudioProcessorEditor::timerCallback()
+void LowTHDTapeSimulatorAudioProcessorEditor::setTimerRate (int rateHz)
 {
-    // Get actual level from processor
-    float currentLevel = audioProcessor.getCurrentLevelDB();
+    if (getTimerInterval() != 1000 / rateHz)
+        startTimerHz (rateHz);
+}
 
+void LowTHDTapeSimulatorAudioProcessorEditor::timerCallback()
+{
     // PPM-style ballistics: 10ms integration time (attack), 2s return time (release)
     // At 30 fps (33.3ms per frame):
     // Attack: reach 99% in ~10ms → coefficient ≈ 1.0 (instant attack)
     // Release: reach 50% in ~2s → 60 frames → coefficient ≈ 0.988
-    if (currentLevel > meterLevel)
-        meterLevel = currentLevel;  // Instant attack (10ms integration)
-    else
-        meterLevel = meterLevel * 0.988f + currentLevel * (1.0f - 0.988f);  // 2s return time
+    // The release is scaled by the real elapsed time so throttled ticks keep the same ballistics.
+    const double nowMs = juce::Time::getMillisecondCounterHiRes();
+    const float frames = static_cast<float> (juce::jlimit (0.0, 30.0, (nowMs - lastTimerMs) / (1000.0 / activeRateHz)));
+    lastTimerMs = nowMs;
 
-    repaint();
+    const float release = std::pow (0.988f, frames);
+    auto applyBallistics = [release] (float& level, float current)
+    {
+        if (current > level)
+            level = current;  // Instant attack (10ms integration)
+        else
+            level = level * release + current * (1.0f - release);  // 2s return time
+    };
+
+    // Peaks are the max since the previous tick, so no transient between frames is lost
+    float truePeak = 0.0f, rms = 0.0f;
+    for (int ch = 0; ch < numMeterChannels; ++ch)
+    {
+        const auto reading = audioProcessor.readInputMeter (ch);
+        applyBallistics (meterLevel[ch], TapeHysteresis::LevelMeter::toDecibels (reading.peak));
+        truePeak = juce::jmax (truePeak, reading.truePeak);
+        rms = juce::jmax (rms, reading.rms);
+    }
+    applyBallistics (truePeakLevel, TapeHysteresis::LevelMeter::toDecibels (truePeak));
+    rmsLevel = TapeHysteresis::LevelMeter::toDecibels (rms);  // Already windowed
+
+    // Hidden / minimised: nothing to draw, just keep the ballistics ticking slowly
+    auto* peer = getPeer();
+    if (!isShowing() || peer == nullptr || peer->isMinimised())
+    {
+        setTimerRate (hiddenRateHz);
+        displayedFillWidth[0] = displayedFillWidth[1] = -1;  // Force a repaint once visible again
+        return;
+    }
+
+    // Repaint only the meter, and only when what it shows would change
+    bool changed = false;
+    for (int ch = 0; ch < numMeterChannels; ++ch)
+    {
+        const int fillWidth = getMeterFillWidth (meterLevel[ch]);
+        const juce::Colour colour = getMeterColour (meterLevel[ch]);
+        changed = changed || fillWidth != displayedFillWidth[ch] || colour != displayedColour[ch];
+        displayedFillWidth[ch] = fillWidth;
+        displayedColour[ch] = colour;
+    }
+
+    const juce::String text = getMeterText();
+    changed = changed || text != displayedText;
+    displayedText = text;
+
+    if (changed)
+    {
+        unchangedTicks = 0;
+
+        repaint (meterBounds.toNearestInt().expanded (2));
+        setTimerRate (activeRateHz);
+    }
+    else if (++unchangedTicks >= idleTicksBeforeThrottle)
+    {
+        setTimerRate (idleRateHz);
+    }
 }
@@ -3,6 +3,8 @@
 #include <juce_audio_processors/juce_audio_processors.h>
 #include <juce_gui_basics/juce_gui_basics.h>
 #include "PluginProcessor.h"
+#include "SpectrumAnalyzer.h"
+#include "HysteresisView.h"
 
 //==============================================================================
 /**
@@ -11,7 +13,15 @@
  * Simple but functional interface with:
  * - Machine mode selector (Ampex/Studer)
  * - Input trim slider
- * - PPM-style level meter with color gradient
+ * - Tape hiss toggle
+ * - Background render toggle
+ * - PPM-style L/R level meter with color gradient, true peak and RMS readout
+ * - Live output / added-harmonics spectrum with H2/H3 readout
+ * - Live B-H (hysteresis loop) view, sharing the analyzer area
+ *
+ * Rendering: static chrome is cached in an image; the timer repaints only the
+ * meter rectangle and only when the drawn value changes, and slows down when
+ * the meter is idle or the editor is hidden.
  */
 class LowTHDTapeSimulatorAudioProcessorEditor : public juce::AudioProcessorEditor,
                                                  public juce::Timer
@@ -47,10 +57,53 @@ private:
     juce::Slider outputTrimSlider;
     std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> outputTrimAttachment;
 
-    // PPM Meter
+    // Tape Hiss
+    juce::ToggleButton hissToggle;
+    std::unique_ptr<juce::AudioProcessorValueTreeState::ButtonAttachment> hissAttachment;
+
+    // Background Render (adds latency - for tracks nobody monitors live)
+    juce::ToggleButton backgroundToggle;
+    std::unique_ptr<juce::AudioProcessorValueTreeState::ButtonAttachment> backgroundAttachment;
+
+    // Cross-Instance Batch (adds one block of latency - renders with other instances)
+    juce::ToggleButton batchToggle;
+    std::unique_ptr<juce::AudioProcessorValueTreeState::ButtonAttachment> batchAttachment;
+
+    // PPM Meter (one bar per channel)
+    static constexpr int numMeterChannels = LowTHDTapeSimulatorAudioProcessor::numMeterChannels;
     juce::Rectangle<float> meterBounds;
-    float meterLevel = 0.0f;
+    float meterLevel[numMeterChannels] = { -100.0f, -100.0f };
+    float truePeakLevel = -100.0f;
+    float rmsLevel = -100.0f;
     juce::Colour getMeterColour (float levelDB) const;
+    juce::Rectangle<float> getMeterBarBounds (int channel) const;
+    juce::String getMeterText() const;
+
+    // Last drawn meter state - repaint only when it changes
+    int displayedFillWidth[numMeterChannels] = { -1, -1 };
+    juce::Colour displayedColour[numMeterChannels];
+    juce::String displayedText;
+
+    // Timer throttling: full rate while the meter moves, slower when idle/hidden
+    static constexpr int activeRateHz = 30;
+    static constexpr int idleRateHz = 10;
+    static constexpr int hiddenRateHz = 2;
+    static constexpr int idleTicksBeforeThrottle = 30;
+    int unchangedTicks = 0;
+    double lastTimerMs = 0.0;
+    void setTimerRate (int rateHz);
+
+    // Static chrome (gradient, border, divider, meter frame) rendered once
+    juce::Image backgroundCache;
+    void renderBackgroundCache (float scale);
+    int getMeterFillWidth (float levelDB) const;
+
+    // Spectrum analyzer (runs only while the editor is open)
+    SpectrumAnalyzer analyzer;
+
+    // B-H view (swapped in for the analyzer; only one of them runs at a time)
+    HysteresisView hysteresisView;
+    juce::TextButton hysteresisViewButton;
 
     // Styling
     juce::Colour backgroundColour;
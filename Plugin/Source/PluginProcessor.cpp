@@ -23,15 +23,32 @@ LowTHDTapeSimulatorAudioProcessor::LowTHDTapeSimulatorAudioProcessor()
     machineModeParam = parameters.getRawParameterValue (PARAM_MACHINE_MODE);
     inputTrimParam = parameters.getRawParameterValue (PARAM_INPUT_TRIM);
     outputTrimParam = parameters.getRawParameterValue (PARAM_OUTPUT_TRIM);
+    hissParam = parameters.getRawParameterValue (PARAM_HISS);
+    backgroundParam = parameters.getRawParameterValue (PARAM_BACKGROUND);
+    batchParam = parameters.getRawParameterValue (PARAM_BATCH);
+
+    // Unique hiss per instance (stacked tracks must not add coherently)
+    std::random_device rd;
+    tapeHiss.setSeed (rd());
+    wowFlutter.setSeed (rd());
 
     // Register parameter listener for auto-gain linking
     parameters.addParameterListener (PARAM_INPUT_TRIM, this);
     lastInputTrimValue = 0.5f;  // Match default
+
+    // Background / batch mode change the reported latency - applied on the message thread
+    parameters.addParameterListener (PARAM_BACKGROUND, this);
+    parameters.addParameterListener (PARAM_BATCH, this);
 }
 
 LowTHDTapeSimulatorAudioProcessor::~LowTHDTapeSimulatorAudioProcessor()
 {
     parameters.removeParameterListener (PARAM_INPUT_TRIM, this);
+    parameters.removeParameterListener (PARAM_BACKGROUND, this);
+    parameters.removeParameterListener (PARAM_BATCH, this);
+    cancelPendingUpdate();
+    backgroundRenderer.stop();
+    batchedCore.stop();
 }
 
 //==============================================================================
@@ -78,6 +95,33 @@ LowTHDTapeSimulatorAudioProcessor::createParameterLayout()
         }
     ));
 
+    // Tape Hiss (off by default - existing sessions keep their noise floor)
+    layout.add (std::make_unique<juce::AudioParameterBool> (
+        PARAM_HISS,
+        "Tape Hiss",
+        false
+    ));
+
+    // Background Render (off by default): trades a fixed extra latency for
+    // rendering on a worker thread - for tracks nobody monitors live.
+    // Not automatable: every switch changes the latency reported to the host.
+    layout.add (std::make_unique<juce::AudioParameterBool> (
+        PARAM_BACKGROUND,
+        "Background Render",
+        false,
+        juce::AudioParameterBoolAttributes().withAutomatable (false)
+    ));
+
+    // Cross-Instance Batch (off by default): the cores run one host block
+    // late, rendered together with other instances on the same thread.
+    // Not automatable: every switch changes the latency reported to the host.
+    layout.add (std::make_unique<juce::AudioParameterBool> (
+        PARAM_BATCH,
+        "Cross-Instance Batch",
+        false,
+        juce::AudioParameterBoolAttributes().withAutomatable (false)
+    ));
+
     return layout;
 }
 
@@ -145,28 +189,47 @@ void LowTHDTapeSimulatorAudioProcessor::changeProgramName (int index, const juce
 //==============================================================================
 void LowTHDTapeSimulatorAudioProcessor::prepareToPlay (double sampleRate, int samplesPerBlock)
 {
-    // Initialize 2x minimum phase oversampling
+    // Leave the batching service first: other instances must not render
+    // through the cores while they are reset
+    batchedCore.stop();
+
+    // Minimum phase oversampling to an internal rate of at least 88.2kHz:
+    // 2x at 44.1/48kHz, none from 88.2kHz up (order 0 = pass-through)
     // filterHalfBandPolyphaseIIR = minimum phase IIR filters (no linear phase latency)
-    constexpr int oversamplingOrder = 1;  // 2^1 = 2x oversampling
+    oversamplingFactor = TapeHysteresis::HybridTapeProcessor::getOversamplingFactor (sampleRate);
+    int oversamplingOrder = 0;  // factor = 2^order
+    while ((1 << oversamplingOrder) < oversamplingFactor)
+        ++oversamplingOrder;
     oversampler = std::make_unique<Oversampler> (
         2,  // numChannels (stereo)
         oversamplingOrder,
         Oversampler::filterHalfBandPolyphaseIIR,  // Minimum phase IIR
         false  // Not using maximum quality (faster)
     );
-    oversampler->initProcessing (static_cast<size_t> (samplesPerBlock));
+    // (background mode renders in chunks that may exceed the host block)
+    const int maximumBlockSize = juce::jmax (samplesPerBlock, BackgroundRenderer::chunkSize);
+    oversampler->initProcessing (static_cast<size_t> (maximumBlockSize));
+
+    // Wow & flutter runs at base rate around a fixed centre delay
+    wowFlutter.setSampleRate (sampleRate);
 
-    // Report latency to DAW (oversampler adds some latency)
-    setLatencySamples (static_cast<int> (oversampler->getLatencyInSamples()));
+    // Latency reported to the DAW: oversampler + wow/flutter centre delay
+    // (+ the background renderer's and the print-through pre-echo lookahead,
+    // set in applyBackgroundMode)
+    baseLatencySamples = static_cast<int> (oversampler->getLatencyInSamples())
+                       + wowFlutter.getLatencySamples();
 
-    // Initialize tape processors at OVERSAMPLED sample rate (2x)
-    const double oversampledRate = sampleRate * 2.0;
+    // Initialize tape processors at the OVERSAMPLED sample rate
+    const double oversampledRate = sampleRate * oversamplingFactor;
     tapeProcessorLeft.setSampleRate (oversampledRate);
     tapeProcessorRight.setSampleRate (oversampledRate);
 
     tapeProcessorLeft.reset();
     tapeProcessorRight.reset();
 
+    // B-H view probe samples the oversampled left-channel core
+    hysteresisProbe.prepare (oversampledRate);
+
     // Set default Ampex ATR-102 parameters (Master mode)
     const double defaultBias = 0.65;
     tapeProcessorLeft.setParameters (defaultBias, 1.0);
@@ -185,19 +248,59 @@ void LowTHDTapeSimulatorAudioProcessor::prepareToPlay (double sampleRate, int sa
     toleranceEQ.prepare (static_cast<float> (sampleRate), isStereo, true);
 
     // Initialize print-through (Studer mode only, but prepare always)
-    printThrough.prepare (static_cast<float> (sampleRate));
+    printThrough.setSampleRate (sampleRate);
+
+    // Input meters: peak hold + ~300ms RMS at base rate
+    for (auto& meter : inputMeters)
+        meter.prepare (sampleRate);
+    for (auto& interpolator : truePeakInterpolators)
+        interpolator.reset();
+
+    // Analyzer feed: decimated input/output frames for the editor
+    analyzerFeed.prepare (sampleRate, maximumBlockSize);
+
+    // Initialize tape hiss at base sample rate (added after downsampling)
+    tapeHiss.setSampleRate (sampleRate);
+    tapeHiss.setBreathing (0.5);  // Subtle modulation noise (+3.5dB at 0dB)
+    tapeHiss.reset();
+
+    // Channel pool for offline renders: one worker per channel beyond the caller's
+    const int numChannels = juce::jmax (getTotalNumInputChannels(), getTotalNumOutputChannels());
+    channelPool.prepare (juce::jmin (numChannels, juce::SystemStats::getNumCpus()) - 1);
+
+    // Batched core: one host block (oversampled) per chunk
+    batchedCore.prepare (juce::jmin (numChannels, 2), samplesPerBlock * oversamplingFactor);
+
+    // Background renderer / batched core (restarted here if the mode is on) + latency report
+    backgroundRenderer.prepare (numChannels);
+    applyBackgroundMode();
+    applyBatchMode();
+
+    // Telemetry footprint: the object plus the sample buffers prepared above
+    // (oversampled block, background rings, batch chunks, print-through rings)
+    telemetry.prepare (sampleRate, oversamplingFactor,
+                       sizeof (*this)
+                         + sizeof (float) * 2 * static_cast<size_t> (maximumBlockSize * oversamplingFactor)
+                         + backgroundRenderer.getBufferBytes() + batchedCore.getBufferBytes()
+                         + printThrough.getBufferBytes());
 }
 
 void LowTHDTapeSimulatorAudioProcessor::releaseResources()
 {
+    // The worker (or another instance) must not render while the processors are reset
+    backgroundRenderer.stop();
+    batchedCore.stop();
+
     // Reset processors when playback stops
     tapeProcessorLeft.reset();
     tapeProcessorRight.reset();
     oversampler->reset();
     crosstalkFilter.reset();
+    wowFlutter.reset();
     headBumpModulator.reset();
     toleranceEQ.reset();
     printThrough.reset();
+    tapeHiss.reset();
 }
 
 #ifndef JucePlugin_PreferredChannelConfigurations
@@ -227,6 +330,21 @@ void LowTHDTapeSimulatorAudioProcessor::processBlock (juce::AudioBuffer<float>&
 {
     juce::ScopedNoDenormals noDenormals;
 
+    // Background mode: the worker renders, this thread only swaps samples.
+    // Offline renders wait for the worker rather than drop out.
+    if (backgroundRenderer.isRunning())
+    {
+        backgroundRenderer.process (buffer, isNonRealtime());
+        return;
+    }
+
+    renderBlock (buffer);
+}
+
+void LowTHDTapeSimulatorAudioProcessor::renderBlock (juce::AudioBuffer<float>& buffer)
+{
+    const uint64_t telemetryStart = telemetry.beginBlock();
+
     auto totalNumInputChannels  = getTotalNumInputChannels();
     auto totalNumOutputChannels = getTotalNumOutputChannels();
 
@@ -238,6 +356,7 @@ void LowTHDTapeSimulatorAudioProcessor::processBlock (juce::AudioBuffer<float>&
     const int machineMode = static_cast<int> (*machineModeParam);
     const float inputTrimValue = *inputTrimParam;
     const float outputTrimValue = *outputTrimParam;
+    const bool hissEnabled = *hissParam > 0.5f;
 
     // Update processor parameters based on machine mode
     // Master mode (0) = Ampex ATR-102: bias=0.65, ultra-clean, E/O ~0.5
@@ -245,45 +364,123 @@ void LowTHDTapeSimulatorAudioProcessor::processBlock (juce::AudioBuffer<float>&
     // The bias value determines which internal parameters are used (threshold at 0.74)
     const double bias = (machineMode == 0) ? 0.65 : 0.82;
 
+    // Batch mode: another instance may still be rendering our last chunk.
+    // The cores are ours again only after this, so telemetry reads their
+    // J-A step count here (one chunk behind, like the audio).
+    const bool batched = batchedCore.isRunning();
+    if (batched)
+        batchedCore.finishPending();
+    uint64_t jaSteps = tapeProcessorLeft.getJaStepCount() + tapeProcessorRight.getJaStepCount();
+
     // Set processor parameters (input gain = 1.0, we apply drive externally via inputTrim)
     tapeProcessorLeft.setParameters (bias, 1.0);
     tapeProcessorRight.setParameters (bias, 1.0);
 
     const int numSamples = buffer.getNumSamples();
-    float peakLevel = 0.0f;
+    const int numMetered = juce::jmin (totalNumInputChannels, numMeterChannels);
+    float peakLevel[numMeterChannels] = { 0.0f, 0.0f };
+    float truePeakLevel[numMeterChannels] = { 0.0f, 0.0f };
+    double sumSquares[numMeterChannels] = { 0.0, 0.0 };
+
+    // Apply input trim (Drive) BEFORE oversampling and measure level for metering.
+    // Without oversampling (1x) there is no upsampled input for the true
+    // peak, so the loop interpolates the midpoints itself.
+    const bool interpolateTruePeak = oversamplingFactor == 1;
 
-    // Apply input trim (Drive) BEFORE oversampling and measure level for metering
     for (int ch = 0; ch < totalNumInputChannels; ++ch)
     {
         auto* channelData = buffer.getWritePointer (ch);
-        for (int sample = 0; sample < numSamples; ++sample)
+        float peak = 0.0f;
+        float squares = 0.0f;
+
+        if (interpolateTruePeak && ch < numMeterChannels)
         {
-            channelData[sample] *= inputTrimValue;
-            peakLevel = std::max (peakLevel, std::abs (channelData[sample]));
+            auto& interpolator = truePeakInterpolators[ch];
+            float truePeak = 0.0f;
+            for (int sample = 0; sample < numSamples; ++sample)
+            {
+                channelData[sample] *= inputTrimValue;
+                peak = std::max (peak, std::abs (channelData[sample]));
+                squares += channelData[sample] * channelData[sample];
+                truePeak = std::max (truePeak, interpolator.push (channelData[sample]));
+            }
+            truePeakLevel[ch] = truePeak;
+        }
+        else
+        {
+            for (int sample = 0; sample < numSamples; ++sample)
+            {
+                channelData[sample] *= inputTrimValue;
+                peak = std::max (peak, std::abs (channelData[sample]));
+                squares += channelData[sample] * channelData[sample];
+            }
+        }
+
+        if (ch < numMeterChannels)
+        {
+            peakLevel[ch] = peak;
+            sumSquares[ch] = squares;
         }
     }
 
-    // === OVERSAMPLING: Upsample to 2x rate ===
+    // Analyzer: keep the input to tape for pairing with this block's output
+    if (totalNumInputChannels >= 1)
+        analyzerFeed.captureInput (buffer.getReadPointer (0),
+                                   totalNumInputChannels >= 2 ? buffer.getReadPointer (1) : nullptr,
+                                   numSamples);
+
+    // === OVERSAMPLING: Upsample to the internal rate ===
     juce::dsp::AudioBlock<float> block (buffer);
     juce::dsp::AudioBlock<float> oversampledBlock = oversampler->processSamplesUp (block);
 
-    // Process at oversampled rate (2x sample rate)
+    // Process at the oversampled rate
     const int oversampledNumSamples = static_cast<int> (oversampledBlock.getNumSamples());
+    const int numCoreChannels = juce::jmin (static_cast<int> (oversampledBlock.getNumChannels()), 2);
+    const bool probeActive = hysteresisProbe.isActive();
+
+    // The upsampled input doubles as the true-peak estimate (at 1x the
+    // trim loop above has measured it)
+    auto measureTruePeak = [&] (int ch)
+    {
+        if (interpolateTruePeak)
+            return;
+
+        const float* data = oversampledBlock.getChannelPointer (static_cast<size_t> (ch));
+        for (int sample = 0; sample < oversampledNumSamples; ++sample)
+            truePeakLevel[ch] = std::max (truePeakLevel[ch], std::abs (data[sample]));
+    };
 
-    for (int sample = 0; sample < oversampledNumSamples; ++sample)
+    // L and R cores share nothing until downsampling, so each channel is one task
+    auto processCore = [&] (int ch)
     {
-        // Process left channel
-        float leftSample = oversampledBlock.getSample (0, sample);
-        float leftProcessed = static_cast<float> (tapeProcessorLeft.processSample (leftSample));
-        oversampledBlock.setSample (0, sample, leftProcessed);
+        measureTruePeak (ch);
+        processCoreChannel (oversampledBlock.getChannelPointer (static_cast<size_t> (ch)), oversampledNumSamples, ch);
+    };
 
-        // Process right channel (with azimuth delay)
-        if (oversampledBlock.getNumChannels() > 1)
+    if (batchedCore.isRunning())
+    {
+        // Batch mode: this block's cores run with the other instances';
+        // the block plays the previous one's output. The B-H probe needs
+        // the left core per sample, so those chunks are rendered solo.
+        float* channels[2] = {};
+        for (int ch = 0; ch < numCoreChannels; ++ch)
         {
-            float rightSample = oversampledBlock.getSample (1, sample);
-            float rightProcessed = static_cast<float> (tapeProcessorRight.processRightChannel (rightSample));
-            oversampledBlock.setSample (1, sample, rightProcessed);
+            measureTruePeak (ch);
+            channels[ch] = oversampledBlock.getChannelPointer (static_cast<size_t> (ch));
         }
+        batchedCore.process (channels, numCoreChannels, oversampledNumSamples, !probeActive);
+    }
+    else if (isNonRealtime() && numCoreChannels > 1 && numSamples >= parallelMinimumBlockSize
+             && channelPool.getNumWorkers() > 0)
+    {
+        // Offline bounces hand over big blocks: run the channels side by side.
+        // Realtime stays serial (waking workers costs more than it saves there).
+        channelPool.run (numCoreChannels, processCore);
+    }
+    else
+    {
+        for (int ch = 0; ch < numCoreChannels; ++ch)
+            processCore (ch);
     }
 
     // === OVERSAMPLING: Downsample back to original rate ===
@@ -309,6 +506,17 @@ void LowTHDTapeSimulatorAudioProcessor::processBlock (juce::AudioBuffer<float>&
         }
     }
 
+    // === WOW & FLUTTER: Both modes ===
+    // Transport speed modulation (pitch) - reel/capstan wow plus scrape flutter
+    // Ampex ATR-102: ~0.02% peak, Studer A820: ~0.03% peak at 30 IPS
+    if (totalNumInputChannels >= 1)
+    {
+        wowFlutter.setMachineMode (machineMode == 0);
+        wowFlutter.process (buffer.getWritePointer (0),
+                            totalNumInputChannels >= 2 ? buffer.getWritePointer (1) : nullptr,
+                            numSamples);
+    }
+
     // === HEAD BUMP MODULATION: Both modes ===
     // Simulates wow-induced amplitude variation in the head bump frequency region
     // Updates LFO once per block (efficient), applies sample-by-sample
@@ -380,29 +588,28 @@ void LowTHDTapeSimulatorAudioProcessor::processBlock (juce::AudioBuffer<float>&
     }
 
     // === PRINT-THROUGH: Studer mode only ===
-    // Simulates magnetic bleed between tape layers creating subtle pre-echo
+    // Simulates magnetic bleed between tape layers: echoes at 1-4 layer
+    // spacings (65ms at 30 IPS), each layer weaker, block-processed, plus
+    // the pre-echo one spacing ahead in background mode (its lookahead is
+    // part of the reported latency, so Ampex mode still delays by it)
     // Signal-dependent: louder passages create proportionally more print-through
     // Real-world multitrack tape (more layers, more print-through than 2-track)
-    // 65ms delay represents tape layer spacing at 30 IPS
-    if (machineMode == 1 && totalNumInputChannels >= 2)  // Studer mode, stereo only
+    if ((machineMode == 1 || printThrough.getPreEcho()) && totalNumInputChannels >= 1)
     {
-        float* leftData = buffer.getWritePointer (0);
-        float* rightData = buffer.getWritePointer (1);
-
-        for (int sample = 0; sample < numSamples; ++sample)
-        {
-            printThrough.processSample (leftData[sample], rightData[sample]);
-        }
+        printThrough.process (buffer.getWritePointer (0),
+                              totalNumInputChannels >= 2 ? buffer.getWritePointer (1) : nullptr,
+                              numSamples, machineMode == 1);
     }
-    else if (machineMode == 1 && totalNumInputChannels == 1)  // Studer mode, mono
-    {
-        float* monoData = buffer.getWritePointer (0);
-        float dummy = 0.0f;
 
-        for (int sample = 0; sample < numSamples; ++sample)
-        {
-            printThrough.processSample (monoData[sample], dummy);
-        }
+    // === TAPE HISS: Both modes, optional ===
+    // Machine-specific noise floor at the tape's operating level,
+    // so it follows the Volume control like real playback noise
+    if (hissEnabled && totalNumInputChannels >= 1)
+    {
+        tapeHiss.setMachineMode (machineMode == 0);
+        tapeHiss.process (buffer.getWritePointer (0),
+                          totalNumInputChannels >= 2 ? buffer.getWritePointer (1) : nullptr,
+                          numSamples);
     }
 
     // Apply output trim (Volume) and final makeup gain
@@ -413,18 +620,65 @@ void LowTHDTapeSimulatorAudioProcessor::processBlock (juce::AudioBuffer<float>&
     // This ensures unity gain with default settings
     constexpr float finalMakeupGain = 2.0f;  // +6dB
 
+    // x * 0 is 0 for every finite x and NaN for NaN / Inf: the sum flags a
+    // non-finite block for telemetry without a branch in the loop
+    float nonFiniteCheck = 0.0f;
+
     for (int ch = 0; ch < totalNumInputChannels; ++ch)
     {
         auto* channelData = buffer.getWritePointer (ch);
         for (int sample = 0; sample < numSamples; ++sample)
+        {
             channelData[sample] *= outputTrimValue * finalMakeupGain;
+            nonFiniteCheck += channelData[sample] * 0.0f;
+        }
+    }
+
+    // Analyzer: pair the final output with the captured input
+    if (totalNumInputChannels >= 1)
+        analyzerFeed.pushOutput (buffer.getReadPointer (0),
+                                 totalNumInputChannels >= 2 ? buffer.getReadPointer (1) : nullptr,
+                                 numSamples);
+
+    // Publish this block's meter values (mono feeds both meters)
+    for (int ch = 0; ch < numMeterChannels; ++ch)
+    {
+        const int source = juce::jmin (ch, juce::jmax (numMetered - 1, 0));
+        inputMeters[ch].publish (peakLevel[source], truePeakLevel[source], sumSquares[source], numSamples);
     }
 
-    // Update meter level (convert to dB)
-    if (peakLevel > 0.0001f)
-        currentLevelDB.store (20.0f * std::log10 (peakLevel));
+    // Telemetry (lowthd-top). Outside batch mode the cores ran in this block.
+    using Mode = InstanceTelemetry::Mode;
+    if (! batched)
+        jaSteps = tapeProcessorLeft.getJaStepCount() + tapeProcessorRight.getJaStepCount();
+
+    const Mode mode = batched ? Mode::batch
+                    : backgroundRenderer.isRunning() ? Mode::background
+                    : isNonRealtime() ? Mode::offline
+                    : Mode::realtime;
+    telemetry.endBlock (telemetryStart, numSamples, oversampledNumSamples * numCoreChannels, jaSteps,
+                        nonFiniteCheck != 0.0f, mode);
+}
+
+void LowTHDTapeSimulatorAudioProcessor::processCoreChannel (float* data, int numSamples, int channel)
+{
+    if (channel == 0 && hysteresisProbe.isActive())
+    {
+        for (int sample = 0; sample < numSamples; ++sample)
+        {
+            data[sample] = static_cast<float> (tapeProcessorLeft.processSample (data[sample]));
+            hysteresisProbe.capture (tapeProcessorLeft);
+        }
+    }
+    else if (channel == 0)
+    {
+        tapeProcessorLeft.processBlock (data, numSamples);
+    }
     else
-        currentLevelDB.store (-96.0f);
+    {
+        // Right channel (with azimuth delay)
+        tapeProcessorRight.processRightChannelBlock (data, numSamples);
+    }
 }
 
 //==============================================================================
@@ -457,6 +711,11 @@ void LowTHDTapeSimulatorAudioProcessor::setStateInformation (const void* data, i
             parameters.replaceState (juce::ValueTree::fromXml (*xmlState));
 }
 
+void LowTHDTapeSimulatorAudioProcessor::updateTrackProperties (const TrackProperties& properties)
+{
+    telemetry.setName (properties.name.value_or (juce::String()));
+}
+
 //==============================================================================
 // Parameter listener callback for auto-gain linking
 void LowTHDTapeSimulatorAudioProcessor::parameterChanged (const juce::String& parameterID, float newValue)
@@ -487,6 +746,67 @@ void LowTHDTapeSimulatorAudioProcessor::parameterChanged (const juce::String& pa
         // Remember current input trim for next delta calculation
         lastInputTrimValue = newValue;
     }
+    else if (parameterID == PARAM_BACKGROUND || parameterID == PARAM_BATCH)
+    {
+        // May arrive on any thread (state restore, host UI) - switch on the message thread
+        triggerAsyncUpdate();
+    }
+}
+
+//==============================================================================
+void LowTHDTapeSimulatorAudioProcessor::applyBackgroundMode()
+{
+    const bool wanted = *backgroundParam > 0.5f;
+
+    if (!wanted && backgroundRenderer.isRunning())
+        backgroundRenderer.stop();
+
+    // Print-through pre-echo looks ahead by its own latency, background mode
+    // only - switched while the worker (which renders it) is stopped
+    if (!backgroundRenderer.isRunning())
+        printThrough.setPreEcho (wanted);
+
+    if (wanted && !backgroundRenderer.isRunning())
+        backgroundRenderer.start();
+
+    updateLatency();
+}
+
+void LowTHDTapeSimulatorAudioProcessor::applyBatchMode()
+{
+    const bool wanted = *batchParam > 0.5f;
+
+    if (wanted && !batchedCore.isRunning())
+        batchedCore.start();
+    else if (!wanted && batchedCore.isRunning())
+        batchedCore.stop();
+
+    updateLatency();
+}
+
+void LowTHDTapeSimulatorAudioProcessor::updateLatency()
+{
+    // Batched core: one host block (the chunk is oversampled)
+    // Print-through: its pre-echo lookahead (background mode)
+    setLatencySamples (baseLatencySamples
+                       + (backgroundRenderer.isRunning() ? BackgroundRenderer::latencySamples : 0)
+                       + printThrough.getLatencySamples()
+                       + (batchedCore.isRunning() ? batchedCore.getChunkSize() / oversamplingFactor : 0));
+}
+
+void LowTHDTapeSimulatorAudioProcessor::handleAsyncUpdate()
+{
+    // Not prepared yet: prepareToPlay applies the mode
+    if (oversampler == nullptr)
+        return;
+
+    // Suspending takes the callback lock, so no processBlock is running
+    // while the worker starts or stops
+    const bool wasSuspended = isSuspended();
+    suspendProcessing (true);
+    applyBackgroundMode();
+    applyBatchMode();
+    suspendProcessing (wasSuspended);
 }
 
 //==============================================================================
@@ -3,7 +3,17 @@
 #include <juce_audio_processors/juce_audio_processors.h>
 #include <juce_dsp/juce_dsp.h>
 #include <random>
+#include "DSP/BatchingService.h"
 #include "DSP/HybridTapeProcessor.h"
+#include "DSP/LevelMeter.h"
+#include "DSP/PrintThrough.h"
+#include "DSP/TapeHiss.h"
+#include "DSP/WowFlutter.h"
+#include "AnalyzerFeed.h"
+#include "HysteresisProbe.h"
+#include "BackgroundRenderer.h"
+#include "ChannelThreadPool.h"
+#include "TelemetryService.h"
 
 //==============================================================================
 /**
@@ -15,11 +25,15 @@
  * - Machine mode selection (Ampex ATR-102 vs Studer A820)
  * - Input trim control
  * - Auto gain compensation on/off
- * - Zero latency
+ * - Reported latency: oversampler + wow/flutter centre delay
  * - Stereo processing (independent L/R channels)
+ * - Optional background render mode for non-monitored tracks (adds the
+ *   renderer's buffer and the print-through pre-echo lookahead)
+ * - Optional cross-instance batching (adds one block)
  */
 class LowTHDTapeSimulatorAudioProcessor : public juce::AudioProcessor,
-                                          private juce::AudioProcessorValueTreeState::Listener
+                                          private juce::AudioProcessorValueTreeState::Listener,
+                                          private juce::AsyncUpdater
 {
 public:
     //==============================================================================
@@ -59,17 +73,31 @@ public:
     void getStateInformation (juce::MemoryBlock& destData) override;
     void setStateInformation (const void* data, int sizeInBytes) override;
 
+    // Track name for the telemetry page (lowthd-top)
+    void updateTrackProperties (const TrackProperties& properties) override;
+
     //==============================================================================
     // Parameter IDs
     static constexpr const char* PARAM_MACHINE_MODE = "machineMode";
     static constexpr const char* PARAM_INPUT_TRIM = "inputTrim";
     static constexpr const char* PARAM_OUTPUT_TRIM = "outputTrim";
+    static constexpr const char* PARAM_HISS = "hiss";
+    static constexpr const char* PARAM_BACKGROUND = "background";
+    static constexpr const char* PARAM_BATCH = "batch";
 
     // Access to parameter tree state
     juce::AudioProcessorValueTreeState& getValueTreeState() { return parameters; }
 
-    // Get current output level in dB for metering
-    float getCurrentLevelDB() const { return currentLevelDB.load(); }
+    // Input-to-tape metering (after trim, before saturation), per channel.
+    // Peak / true peak are held until read - call once per GUI frame.
+    static constexpr int numMeterChannels = 2;
+    TapeHysteresis::LevelMeter::Reading readInputMeter (int channel) { return inputMeters[channel].read(); }
+
+    // Input/output frames for the editor's analyzer (inactive unless it is open)
+    AnalyzerFeed& getAnalyzerFeed() { return analyzerFeed; }
+
+    // Decimated left-channel core state for the editor's B-H view (inactive unless it is showing)
+    HysteresisProbe& getHysteresisProbe() { return hysteresisProbe; }
 
 private:
     //==============================================================================
@@ -87,14 +115,25 @@ private:
     std::atomic<float>* machineModeParam = nullptr;
     std::atomic<float>* inputTrimParam = nullptr;
     std::atomic<float>* outputTrimParam = nullptr;
+    std::atomic<float>* hissParam = nullptr;
+    std::atomic<float>* backgroundParam = nullptr;
+    std::atomic<float>* batchParam = nullptr;
+
+    // Level metering (one accumulator per channel, mono mirrors channel 0)
+    TapeHysteresis::LevelMeter inputMeters[numMeterChannels];
+    TapeHysteresis::TruePeakInterpolator truePeakInterpolators[numMeterChannels];   // 1x only
+
+    // Analyzer feed (lock-free FIFO to the editor's analysis thread)
+    AnalyzerFeed analyzerFeed;
 
-    // Level metering
-    std::atomic<float> currentLevelDB { -96.0f };
+    // Hysteresis probe (lock-free FIFO of core state to the editor's B-H view)
+    HysteresisProbe hysteresisProbe;
 
-    // 2x Minimum Phase Oversampling (hardcoded, always on)
+    // Minimum Phase Oversampling to >= 88.2kHz (2x at 44.1/48kHz, 1x from 88.2kHz)
     // Uses JUCE's IIR half-band polyphase filters for minimum phase response
     using Oversampler = juce::dsp::Oversampling<float>;
     std::unique_ptr<Oversampler> oversampler;
+    int oversamplingFactor = 2;
 
     // Crosstalk filter for Studer mode
     // Simulates adjacent track bleed on 24-track tape machines
@@ -174,6 +213,10 @@ private:
 
     CrosstalkFilter crosstalkFilter;
 
+    // Wow & flutter - true transport speed (pitch) modulation
+    // Modulated fractional delay, one control signal shared by L/R
+    TapeHysteresis::WowFlutter wowFlutter;
+
     // Head bump modulator - simulates wow-induced LF gain variation
     // Real tape transport wow causes subtle amplitude modulation in the head bump region
     // as the effective tape speed varies slightly
@@ -520,88 +563,16 @@ private:
     ToleranceEQ toleranceEQ;
 
     // Print-Through (Studer mode only)
-    // Simulates magnetic bleed between tape layers on the reel
-    // Creates subtle pre-echo ~65ms before the main signal
+    // Magnetic bleed from the layers wound around the tape on the reel:
+    // four layer echoes (65ms apart, each 8dB weaker) from one shared ring,
+    // plus the outer layer's pre-echo with 65ms lookahead in background mode
     // Signal-dependent: louder signals create stronger magnetic bleed
-    // Real print-through is proportional to the recorded flux level
-    struct PrintThrough
-    {
-        // Delay buffer for 65ms at up to 192kHz
-        static constexpr int MAX_DELAY_SAMPLES = 12480;  // 65ms @ 192kHz
-        float bufferL[MAX_DELAY_SAMPLES] = {0};
-        float bufferR[MAX_DELAY_SAMPLES] = {0};
-        int writeIndex = 0;
-        int delaySamples = 0;
-
-        // Base print-through coefficient (scales with signal level)
-        // At unity (0dBFS), this gives approximately -58dB of print-through
-        // GP9 tape has ~3dB less print-through than older formulations (456)
-        // Quieter signals produce proportionally less print-through
-        static constexpr float printCoeff = 0.00126f;  // -58dB at unity (GP9 spec)
-
-        // Minimum threshold - signals below this won't produce audible print-through
-        // Prevents noise floor from creating constant low-level artifacts
-        static constexpr float noiseFloor = 0.001f;  // -60dB
+    TapeHysteresis::PrintThrough printThrough;
 
-        float sampleRate = 48000.0f;
-
-        void prepare(float sr)
-        {
-            sampleRate = sr;
-            // 65ms delay for 30 IPS tape layer spacing
-            delaySamples = static_cast<int>(0.065f * sampleRate);
-            if (delaySamples >= MAX_DELAY_SAMPLES)
-                delaySamples = MAX_DELAY_SAMPLES - 1;
-            reset();
-        }
-
-        void reset()
-        {
-            for (int i = 0; i < MAX_DELAY_SAMPLES; ++i)
-            {
-                bufferL[i] = 0.0f;
-                bufferR[i] = 0.0f;
-            }
-            writeIndex = 0;
-        }
-
-        void processSample(float& left, float& right)
-        {
-            // Read from delay buffer (pre-echo from 65ms ago)
-            int readIndex = writeIndex - delaySamples;
-            if (readIndex < 0) readIndex += MAX_DELAY_SAMPLES;
-
-            float delayedL = bufferL[readIndex];
-            float delayedR = bufferR[readIndex];
-
-            // Signal-dependent print-through:
-            // The amount of magnetic bleed is proportional to the recorded signal level
-            // Louder passages create stronger magnetization, hence more print-through
-            float absL = std::abs(delayedL);
-            float absR = std::abs(delayedR);
-
-            // Apply soft knee above noise floor for natural response
-            // Print level scales quadratically with amplitude (magnetic flux relationship)
-            float printLevelL = (absL > noiseFloor) ? printCoeff * absL : 0.0f;
-            float printLevelR = (absR > noiseFloor) ? printCoeff * absR : 0.0f;
-
-            float preEchoL = delayedL * printLevelL;
-            float preEchoR = delayedR * printLevelR;
-
-            // Write current sample to delay buffer
-            bufferL[writeIndex] = left;
-            bufferR[writeIndex] = right;
-
-            // Advance write index
-            writeIndex = (writeIndex + 1) % MAX_DELAY_SAMPLES;
-
-            // Mix pre-echo into output
-            left += preEchoL;
-            right += preEchoR;
-        }
-    };
-
-    PrintThrough printThrough;
+    // Tape hiss (both modes, optional)
+    // Machine-specific noise floor from published 30 IPS S/N figures
+    // Seeded per instance so stacked tracks get uncorrelated hiss
+    TapeHysteresis::TapeHiss tapeHiss;
 
     // Auto-gain: Track the last input trim to detect changes
     float lastInputTrimValue = 0.5f;
@@ -610,6 +581,46 @@ private:
     // Parameter listener callback
     void parameterChanged (const juce::String& parameterID, float newValue) override;
 
+    // The whole chain, in place - called by processBlock, or by the
+    // background renderer's worker thread in background mode
+    void renderBlock (juce::AudioBuffer<float>& buffer);
+
+    // One oversampled channel through its core (B-H probe on channel 0)
+    void processCoreChannel (float* data, int numSamples, int channel);
+
+    // Background / batch mode: start/stop the worker or the batched core and
+    // report the matching latency. Switching goes through the message
+    // thread with processing suspended.
+    void applyBackgroundMode();
+    void applyBatchMode();
+    void updateLatency();
+    void handleAsyncUpdate() override;
+
+    int baseLatencySamples = 0;  // Oversampler + wow/flutter centre delay
+
+    // Offline only: per-channel core processing in parallel for blocks of at
+    // least parallelMinimumBlockSize (base rate) samples
+    static constexpr int parallelMinimumBlockSize = 512;
+    ChannelThreadPool channelPool;
+
+    // Batch mode: the cores run one host block late, rendered together with
+    // other instances' (one BatchingService per process). Leaves its slot
+    // before the cores are destroyed.
+    juce::SharedResourcePointer<TapeHysteresis::BatchingService> batchingService;
+    TapeHysteresis::BatchedCore batchedCore { *batchingService, tapeProcessorLeft, tapeProcessorRight,
+                                              [this] (float* const* channels, int numChannels, int numSamples)
+                                              {
+                                                  for (int ch = 0; ch < numChannels; ++ch)
+                                                      processCoreChannel (channels[ch], numSamples, ch);
+                                              } };
+
+    // Per-block counters in the process-wide telemetry page (lowthd-top)
+    InstanceTelemetry telemetry;
+
+    // Declared last: its worker renders through the members above, so it
+    // has to stop before any of them are destroyed
+    BackgroundRenderer backgroundRenderer { [this] (juce::AudioBuffer<float>& buffer) { renderBlock (buffer); } };
+
     //==============================================================================
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (LowTHDTapeSimulatorAudioProcessor)
 };
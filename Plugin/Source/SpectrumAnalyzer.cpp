@@ -0,0 +1,286 @@
+#include "SpectrumAnalyzer.h"
+
+//==============================================================================
+SpectrumAnalyzer::SpectrumAnalyzer (AnalyzerFeed& feedToUse)
+    : juce::Thread ("LowTHD Analyzer"), feed (feedToUse)
+{
+    window.resize (fftSize);
+    juce::dsp::WindowingFunction<float>::fillWindowingTables (window.data(), fftSize,
+                                                              juce::dsp::WindowingFunction<float>::hann, false);
+
+    historyInput.assign (fftSize, 0.0f);
+    historyOutput.assign (fftSize, 0.0f);
+    fftBufferInput.assign (2 * fftSize, 0.0f);
+    fftBufferOutput.assign (2 * fftSize, 0.0f);
+    sxx.assign (numBins, 0.0);
+    syy.assign (numBins, 0.0);
+    sxy.assign (numBins, {});
+
+    setOpaque (true);
+}
+
+SpectrumAnalyzer::~SpectrumAnalyzer()
+{
+    stopAnalysis();
+}
+
+void SpectrumAnalyzer::visibilityChanged()
+{
+    if (isVisible())
+        startAnalysis();
+    else
+        stopAnalysis();
+}
+
+void SpectrumAnalyzer::startAnalysis()
+{
+    if (isThreadRunning())
+        return;
+
+    feed.setActive (true);
+    startThread (juce::Thread::Priority::low);
+    startTimerHz (15);
+}
+
+void SpectrumAnalyzer::stopAnalysis()
+{
+    stopTimer();
+    feed.setActive (false);
+    stopThread (1000);
+}
+
+//==============================================================================
+void SpectrumAnalyzer::run()
+{
+    std::vector<float> input (hopSize), output (hopSize);
+    uint32_t feedGeneration = feed.getGeneration() - 1;   // Start by dropping stale frames
+
+    while (!threadShouldExit())
+    {
+        // The processor was re-prepared (or this is the first pull): start
+        // over at the new rate
+        const uint32_t generation = feed.getGeneration();
+        if (generation != feedGeneration)
+        {
+            feedGeneration = generation;
+            feed.discardQueued();
+            std::fill (historyInput.begin(), historyInput.end(), 0.0f);
+            std::fill (historyOutput.begin(), historyOutput.end(), 0.0f);
+            framesSinceAnalysis = 0;
+            spectraPrimed = false;
+        }
+
+        const int frames = feed.pull (input.data(), output.data(), hopSize - framesSinceAnalysis);
+
+        if (frames == 0)
+        {
+            wait (10);
+            continue;
+        }
+
+        // Slide the new frames into the analysis history
+        std::move (historyInput.begin() + frames, historyInput.end(), historyInput.begin());
+        std::move (historyOutput.begin() + frames, historyOutput.end(), historyOutput.begin());
+        std::copy (input.begin(), input.begin() + frames, historyInput.end() - frames);
+        std::copy (output.begin(), output.begin() + frames, historyOutput.end() - frames);
+
+        framesSinceAnalysis += frames;
+        if (framesSinceAnalysis >= hopSize)
+        {
+            framesSinceAnalysis = 0;
+            analyseFrame();
+            publishResult();
+        }
+    }
+}
+
+void SpectrumAnalyzer::analyseFrame()
+{
+    for (int i = 0; i < fftSize; ++i)
+    {
+        fftBufferInput[i] = historyInput[i] * window[i];
+        fftBufferOutput[i] = historyOutput[i] * window[i];
+    }
+
+    fft.performRealOnlyForwardTransform (fftBufferInput.data(), true);
+    fft.performRealOnlyForwardTransform (fftBufferOutput.data(), true);
+
+    // ~0.3s exponential average at 48kHz / 2048 hop
+    const double smoothing = spectraPrimed ? 0.75 : 0.0;
+    spectraPrimed = true;
+
+    for (int k = 0; k < numBins; ++k)
+    {
+        const std::complex<double> x (fftBufferInput[2 * k], fftBufferInput[2 * k + 1]);
+        const std::complex<double> y (fftBufferOutput[2 * k], fftBufferOutput[2 * k + 1]);
+
+        sxx[k] = smoothing * sxx[k] + (1.0 - smoothing) * std::norm (x);
+        syy[k] = smoothing * syy[k] + (1.0 - smoothing) * std::norm (y);
+        sxy[k] = smoothing * sxy[k] + (1.0 - smoothing) * (y * std::conj (x));
+    }
+}
+
+void SpectrumAnalyzer::publishResult()
+{
+    Result result;
+    result.sampleRate = feed.getAnalysisRate();
+    result.outputDB.resize (numBins);
+    result.addedDB.resize (numBins);
+
+    // Sine of amplitude A reads A at its bin (Hann coherent gain 0.5)
+    const double scale = 4.0 / fftSize;
+    auto toDB = [scale] (double power)
+    {
+        return static_cast<float> (10.0 * std::log10 (power * scale * scale + 1e-30));
+    };
+
+    for (int k = 0; k < numBins; ++k)
+    {
+        const double coherent = (sxx[k] > 1e-30) ? std::norm (sxy[k]) / sxx[k] : 0.0;
+        result.outputDB[k] = toDB (syy[k]);
+        result.addedDB[k] = toDB (juce::jmax (syy[k] - coherent, 0.0));
+    }
+
+    // H2 / H3: only when one input tone dominates (>50% of the input power)
+    const double binWidth = result.sampleRate / fftSize;
+    const int lowBin = juce::jmax (3, static_cast<int> (20.0 / binWidth));
+    const int highBin = static_cast<int> (result.sampleRate / 6.0 / binWidth) - 3;
+
+    int peakBin = lowBin;
+    double totalInput = 0.0;
+    for (int k = 1; k < numBins; ++k)
+    {
+        totalInput += sxx[k];
+        if (k >= lowBin && k <= highBin && sxx[k] > sxx[peakBin])
+            peakBin = k;
+    }
+
+    auto bandPower = [] (const std::vector<double>& spectrum, int centre)
+    {
+        double sum = 0.0;
+        for (int k = centre - 2; k <= centre + 2; ++k)
+            sum += spectrum[static_cast<size_t> (k)];
+        return sum;
+    };
+
+    if (totalInput > 1e-20 && bandPower (sxx, peakBin) > 0.5 * totalInput)
+    {
+        const double fundamental = bandPower (syy, peakBin);
+        result.fundamentalHz = static_cast<float> (peakBin * binWidth);
+        result.h2Percent = static_cast<float> (100.0 * std::sqrt (bandPower (syy, 2 * peakBin) / fundamental));
+        result.h3Percent = static_cast<float> (100.0 * std::sqrt (bandPower (syy, 3 * peakBin) / fundamental));
+    }
+
+    {
+        const juce::SpinLock::ScopedLockType lock (resultLock);
+        std::swap (pendingResult, result);
+    }
+    hasNewResult.store (true);
+}
+
+//==============================================================================
+void SpectrumAnalyzer::timerCallback()
+{
+    // Repaint only when the analysis thread produced something new
+    if (!hasNewResult.exchange (false))
+        return;
+
+    {
+        const juce::SpinLock::ScopedLockType lock (resultLock);
+        std::swap (displayedResult, pendingResult);
+    }
+
+    rebuildPaths();
+    repaint();
+}
+
+float SpectrumAnalyzer::frequencyToX (float frequency, juce::Rectangle<float> plot) const
+{
+    const float maxFrequency = static_cast<float> (juce::jmin (20000.0, displayedResult.sampleRate * 0.5));
+    const float position = std::log (frequency / 20.0f) / std::log (maxFrequency / 20.0f);
+    return plot.getX() + plot.getWidth() * position;
+}
+
+float SpectrumAnalyzer::decibelsToY (float decibels, juce::Rectangle<float> plot) const
+{
+    return juce::jmap (juce::jlimit (minDB, maxDB, decibels), minDB, maxDB, plot.getBottom(), plot.getY());
+}
+
+void SpectrumAnalyzer::rebuildPaths()
+{
+    outputPath.clear();
+    addedPath.clear();
+
+    if (displayedResult.outputDB.empty())
+        return;
+
+    const auto plot = getLocalBounds().toFloat().reduced (6.0f, 16.0f);
+    const double binWidth = displayedResult.sampleRate / fftSize;
+    const int firstBin = juce::jmax (1, static_cast<int> (std::ceil (20.0 / binWidth)));
+    const int lastBin = juce::jmin (numBins - 1, static_cast<int> (20000.0 / binWidth));
+
+    // One point per pixel column (max of the bins it covers)
+    auto buildPath = [&] (juce::Path& path, const std::vector<float>& decibels)
+    {
+        int column = -1;
+        float columnMax = minDB;
+        for (int k = firstBin; k <= lastBin; ++k)
+        {
+            const int x = static_cast<int> (frequencyToX (static_cast<float> (k * binWidth), plot));
+            if (x != column && column >= 0)
+            {
+                const float y = decibelsToY (columnMax, plot);
+                if (path.isEmpty())
+                    path.startNewSubPath (static_cast<float> (column), y);
+                else
+                    path.lineTo (static_cast<float> (column), y);
+                columnMax = minDB;
+            }
+            column = x;
+            columnMax = juce::jmax (columnMax, decibels[static_cast<size_t> (k)]);
+        }
+    };
+
+    buildPath (outputPath, displayedResult.outputDB);
+    buildPath (addedPath, displayedResult.addedDB);
+}
+
+void SpectrumAnalyzer::paint (juce::Graphics& g)
+{
+    const auto bounds = getLocalBounds().toFloat();
+    const auto plot = bounds.reduced (6.0f, 16.0f);
+
+    g.fillAll (juce::Colour (0xff1e1e1e));
+
+    // Grid: decades and 20dB steps
+    g.setColour (juce::Colours::white.withAlpha (0.08f));
+    for (float frequency : { 100.0f, 1000.0f, 10000.0f })
+        g.drawVerticalLine (juce::roundToInt (frequencyToX (frequency, plot)), plot.getY(), plot.getBottom());
+    for (float decibels = minDB + 20.0f; decibels < maxDB; decibels += 20.0f)
+        g.drawHorizontalLine (juce::roundToInt (decibelsToY (decibels, plot)), plot.getX(), plot.getRight());
+
+    g.setColour (outputColour);
+    g.strokePath (outputPath, juce::PathStrokeType (1.2f));
+    g.setColour (addedColour);
+    g.strokePath (addedPath, juce::PathStrokeType (1.2f));
+
+    // Legend and harmonic readout
+    g.setFont (juce::FontOptions (10.0f));
+    auto textArea = bounds.reduced (6.0f, 2.0f).removeFromTop (12.0f);
+    g.setColour (outputColour);
+    g.drawText ("Output", textArea, juce::Justification::centredLeft);
+    g.setColour (addedColour);
+    g.drawText ("Added (non-linear)", textArea.withTrimmedLeft (45.0f), juce::Justification::centredLeft);
+
+    g.setColour (juce::Colours::white.withAlpha (0.7f));
+    const juce::String harmonics = displayedResult.fundamentalHz > 0.0f
+        ? "H2 " + juce::String (displayedResult.h2Percent, 3) + "%   H3 " + juce::String (displayedResult.h3Percent, 3)
+              + "%   @ " + juce::String (juce::roundToInt (displayedResult.fundamentalHz)) + " Hz"
+        : juce::String ("H2/H3: play a steady tone");
+    g.drawText (harmonics, textArea, juce::Justification::centredRight);
+}
+
+void SpectrumAnalyzer::resized()
+{
+    rebuildPaths();
+}
@@ -0,0 +1,91 @@
+#pragma once
+
+#include <juce_gui_basics/juce_gui_basics.h>
+#include <juce_dsp/juce_dsp.h>
+#include <complex>
+#include "AnalyzerFeed.h"
+
+//==============================================================================
+/**
+ * Live output spectrum / added-harmonics analyzer
+ *
+ * A low-priority background thread pulls (input, output) frames from the
+ * processor's AnalyzerFeed and runs 4096-point Hann FFTs (50% overlap) with
+ * exponentially averaged auto/cross spectra:
+ *
+ *   Output spectrum:  Syy
+ *   Added content:    Syy - |Sxy|^2 / Sxx   (what is not a linear function
+ *                     of the input - harmonics, IMD, hiss)
+ *   H2 / H3:          relative to the dominant input tone, when there is one
+ *
+ * The feed is only active while this component exists and is showing, so
+ * with the editor closed the audio thread does no analysis work at all.
+ */
+class SpectrumAnalyzer : public juce::Component,
+                         private juce::Thread,
+                         private juce::Timer
+{
+public:
+    explicit SpectrumAnalyzer (AnalyzerFeed& feedToUse);
+    ~SpectrumAnalyzer() override;
+
+    void paint (juce::Graphics&) override;
+    void resized() override;
+    void visibilityChanged() override;
+
+private:
+    static constexpr int fftOrder = 12;
+    static constexpr int fftSize = 1 << fftOrder;
+    static constexpr int hopSize = fftSize / 2;
+    static constexpr int numBins = fftSize / 2 + 1;
+    static constexpr float minDB = -120.0f;
+    static constexpr float maxDB = 0.0f;
+
+    struct Result
+    {
+        std::vector<float> outputDB;
+        std::vector<float> addedDB;
+        double sampleRate = 48000.0;
+        float fundamentalHz = 0.0f;     // 0 = no dominant tone
+        float h2Percent = 0.0f;
+        float h3Percent = 0.0f;
+    };
+
+    // Analysis thread
+    void run() override;
+    void analyseFrame();
+    void publishResult();
+
+    // Message thread
+    void timerCallback() override;
+    void startAnalysis();
+    void stopAnalysis();
+    void rebuildPaths();
+    float frequencyToX (float frequency, juce::Rectangle<float> plot) const;
+    float decibelsToY (float decibels, juce::Rectangle<float> plot) const;
+
+    AnalyzerFeed& feed;
+    juce::dsp::FFT fft { fftOrder };
+    std::vector<float> window;
+
+    // Analysis thread state
+    std::vector<float> historyInput, historyOutput;   // Last fftSize frames
+    std::vector<float> fftBufferInput, fftBufferOutput;
+    std::vector<double> sxx, syy;
+    std::vector<std::complex<double>> sxy;
+    int framesSinceAnalysis = 0;
+    bool spectraPrimed = false;
+
+    // Hand-off (analysis thread -> message thread)
+    juce::SpinLock resultLock;
+    Result pendingResult;
+    std::atomic<bool> hasNewResult { false };
+
+    // Message thread state
+    Result displayedResult;
+    juce::Path outputPath, addedPath;
+    juce::Colour outputColour { 0xffcc8844 };
+    juce::Colour addedColour { 0xffff5544 };
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (SpectrumAnalyzer)
+};
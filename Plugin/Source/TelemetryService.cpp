@@ -0,0 +1,72 @@
+#include "TelemetryService.h"
+
+using TapeHysteresis::TelemetryPage;
+
+//==============================================================================
+TelemetryService::TelemetryService()
+{
+    const auto host = juce::File::getSpecialLocation (juce::File::hostApplicationPath).getFileNameWithoutExtension();
+    page.create (TelemetryPage::getDefaultDirectory(), host.toStdString());
+}
+
+//==============================================================================
+InstanceTelemetry::InstanceTelemetry()
+{
+    slot = service->acquire();
+}
+
+InstanceTelemetry::~InstanceTelemetry()
+{
+    service->release (slot);
+}
+
+void InstanceTelemetry::setName (const juce::String& name)
+{
+    if (slot != nullptr)
+        slot->setName (name.toStdString());
+}
+
+void InstanceTelemetry::prepare (double newSampleRate, int oversamplingFactor, size_t newMemoryBytes)
+{
+    sampleRate.store (newSampleRate, std::memory_order_relaxed);
+    oversampling.store (oversamplingFactor, std::memory_order_relaxed);
+    memoryBytes.store (static_cast<uint64_t> (newMemoryBytes), std::memory_order_relaxed);
+}
+
+void InstanceTelemetry::endBlock (uint64_t startTime, int numSamples, int coreSamples, uint64_t jaSteps, bool nonFinite, Mode mode)
+{
+    if (slot == nullptr)
+        return;
+
+    const uint64_t endTime = TelemetryPage::now();
+    const uint64_t busy = endTime - startTime;
+    const double rate = sampleRate.load (std::memory_order_relaxed);
+    const uint64_t audio = rate > 0.0 ? static_cast<uint64_t> (numSamples * 1.0e9 / rate) : 0;
+
+    // Longest block over the current and the previous window of audio
+    windowMax = juce::jmax (windowMax, busy);
+    windowAudio += audio;
+    if (windowAudio >= windowNanoseconds)
+    {
+        previousWindowMax = windowMax;
+        windowMax = 0;
+        windowAudio = 0;
+    }
+
+    counters.blocks += 1;
+    counters.busyNanoseconds += busy;
+    counters.audioNanoseconds += audio;
+    counters.maxBlockNanoseconds = juce::jmax (windowMax, previousWindowMax);
+    counters.coreSamples += static_cast<uint64_t> (coreSamples);
+    counters.activity = jaSteps != lastJaSteps ? TelemetryPage::Activity::saturating : TelemetryPage::Activity::linear;
+    counters.jaSteps += jaSteps - lastJaSteps;
+    counters.nonFiniteBlocks += nonFinite ? 1 : 0;
+    counters.memoryBytes = memoryBytes.load (std::memory_order_relaxed);
+    counters.lastBlockTime = endTime;
+    counters.sampleRate = static_cast<uint32_t> (rate + 0.5);
+    counters.oversampling = static_cast<uint32_t> (oversampling.load (std::memory_order_relaxed));
+    counters.mode = mode;
+    lastJaSteps = jaSteps;
+
+    slot->publish (counters);
+}
@@ -0,0 +1,81 @@
+#pragma once
+
+#include <juce_core/juce_core.h>
+#include <atomic>
+#include "DSP/TelemetryPage.h"
+
+//==============================================================================
+/**
+ * Process-wide telemetry page (TapeHysteresis::TelemetryPage)
+ *
+ * Created with the first instance, named after the host, and removed with
+ * the last one. Every instance publishes into a slot of it, so lowthd-top
+ * can list every instance of every host on the machine - 200 tracks
+ * without opening 200 editors. When the page can't be created (no temp
+ * directory, all slots taken) instances simply don't publish.
+ *
+ * One instance per process, shared through juce::SharedResourcePointer.
+ */
+class TelemetryService
+{
+public:
+    TelemetryService();
+
+    // Message thread. nullptr when there is no page or it is full.
+    TapeHysteresis::TelemetryPage::Slot* acquire() { return page.claim(); }
+    void release (TapeHysteresis::TelemetryPage::Slot* slot) { page.release (slot); }
+
+private:
+    TapeHysteresis::TelemetryPage page;
+
+    JUCE_DECLARE_NON_COPYABLE (TelemetryService)
+};
+
+//==============================================================================
+/**
+ * One instance's slot in the TelemetryService page.
+ *
+ * The rendering thread (host audio thread, or the background renderer's
+ * worker) wraps each block in beginBlock() / endBlock(): a steady-clock read
+ * at either end, a few additions and one sequence-locked store of the
+ * counters - no allocation, no locks, no system calls beyond the clock.
+ * The longest block is kept over windows of one second of audio and
+ * reported as the maximum of the current and the previous window.
+ */
+class InstanceTelemetry
+{
+public:
+    using Mode = TapeHysteresis::TelemetryPage::Mode;
+
+    InstanceTelemetry();
+    ~InstanceTelemetry();
+
+    // Any thread: the host's track name
+    void setName (const juce::String& name);
+
+    // prepareToPlay: host rate, oversampling and the instance's footprint
+    void prepare (double sampleRate, int oversamplingFactor, size_t memoryBytes);
+
+    // Rendering thread, once per block. jaSteps is the cores' cumulative
+    // HybridTapeProcessor::getJaStepCount().
+    uint64_t beginBlock() const { return TapeHysteresis::TelemetryPage::now(); }
+    void endBlock (uint64_t startTime, int numSamples, int coreSamples, uint64_t jaSteps, bool nonFinite, Mode mode);
+
+private:
+    static constexpr uint64_t windowNanoseconds = 1000000000;
+
+    juce::SharedResourcePointer<TelemetryService> service;
+    TapeHysteresis::TelemetryPage::Slot* slot = nullptr;
+
+    // Set by prepare, read by the rendering thread
+    std::atomic<double> sampleRate { 0.0 };
+    std::atomic<int> oversampling { 0 };
+    std::atomic<uint64_t> memoryBytes { 0 };
+
+    // Rendering thread state
+    TapeHysteresis::TelemetryPage::Counters counters;
+    uint64_t lastJaSteps = 0;
+    uint64_t windowAudio = 0, windowMax = 0, previousWindowMax = 0;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (InstanceTelemetry)
+};
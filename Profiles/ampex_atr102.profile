@@ -0,0 +1,58 @@
+# LOWTHD machine profile
+# Ampex ATR-102 (Master mode) - 30 IPS, 1/2" two-track
+# THD targets: -6dB=0.02%, 0dB=0.08%, +6dB=0.40%, MOL(3%)=+12dB, E/O ~0.5
+format = 1
+name = Ampex ATR-102
+
+# Layer 1: J-A hysteresis
+ja.Ms = 1
+ja.a = 50
+ja.k = 0.005
+ja.c = 0.96
+ja.alpha = 2e-07
+ja.inputScale = 1
+ja.outputScale = 50
+ja.blendMax = 0.005
+ja.blendThreshold = 0.05
+ja.blendWidth = 0.45
+
+# Layer 2: symmetric atan
+atan.mix = 0.25
+atan.threshold = 0.18
+atan.width = 2.2
+atan.drive = 0.6
+
+# Global DC bias (odd-dominant)
+inputBias = 0.06
+
+# AC bias shielding, 432 kHz bias: flat to 8kHz, -8dB at 20kHz
+hfCut1.freq = 8000
+hfCut1.gainDB = -4
+hfCut2.freq = 14000
+hfCut2.gainDB = -4
+
+# Self-erasure: engages above -6dB, -2dB shelf at +6dB
+selfErasure.threshold = 0.5
+selfErasure.width = 1.5
+selfErasure.maxCutDB = -2
+selfErasure.freq = 12000
+
+# Head geometry
+dispersive.cornerFreq = 10000
+azimuth.delayMicroseconds = 8
+
+# Machine EQ (Jack Endino / EMC measurements)
+# 20Hz=-2.7dB, 28Hz=0dB, 40Hz=+1.15dB, 70Hz=+0.17dB, 105Hz=+0.3dB, 150Hz=0dB,
+# 300Hz=-0.5dB, 1kHz=0dB, 3kHz=-0.45dB, 5kHz=0dB, 10kHz=0dB, 16kHz=-0.25dB
+eq = highpass 20.8 0.7071
+eq = bell 28 2.5 0.4
+eq = bell 40 1.8 0.95
+eq = bell 70 2 -0.3
+eq = bell 105 2 0.1
+eq = bell 150 2 -0.2
+eq = bell 300 0.7 -0.8
+eq = bell 1200 1.5 -0.25
+eq = bell 3000 1 -0.7
+eq = bell 7000 1 -0.3
+eq = bell 16000 1.5 -0.4
+eq = lowpass1 40000
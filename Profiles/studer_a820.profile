@@ -0,0 +1,56 @@
+# LOWTHD machine profile
+# Studer A820 (Tracks mode) - 30 IPS, 2" multitrack
+# THD targets: -6dB=0.07%, 0dB=0.25%, +6dB=1.25%, MOL(3%)=+9dB, E/O ~1.12
+format = 1
+name = Studer A820
+
+# Layer 1: J-A hysteresis
+ja.Ms = 1
+ja.a = 45
+ja.k = 0.008
+ja.c = 0.92
+ja.alpha = 5e-06
+ja.inputScale = 1
+ja.outputScale = 50
+ja.blendMax = 0.012
+ja.blendThreshold = 0.02
+ja.blendWidth = 0.48
+
+# Layer 2: symmetric atan
+atan.mix = 0.35
+atan.threshold = 0.2
+atan.width = 1.8
+atan.drive = 0.95
+
+# Global DC bias (even-dominant)
+inputBias = 0.22
+
+# AC bias shielding, 153.6 kHz bias: flat to 6kHz, -12dB at 20kHz
+hfCut1.freq = 6000
+hfCut1.gainDB = -6
+hfCut2.freq = 12000
+hfCut2.gainDB = -6
+
+# Self-erasure: engages above -9dB, -3.5dB shelf at +6dB
+selfErasure.threshold = 0.35
+selfErasure.width = 1.65
+selfErasure.maxCutDB = -3.5
+selfErasure.freq = 10000
+
+# Head geometry
+dispersive.cornerFreq = 2800
+azimuth.delayMicroseconds = 12
+
+# Machine EQ (Jack Endino / EMC measurements)
+# 20Hz=-5dB, 28Hz=-2.5dB, 40Hz=0dB, 50Hz=+0.55dB, 70Hz=+0.1dB, 110Hz=+1.2dB
+# 18dB/oct HP (2nd + 1st order at 22Hz) tuned to hit both 20Hz and 28Hz
+eq = highpass 22 1
+eq = highpass1 22
+eq = bell 28 1 -2
+eq = bell 40 2 0.9
+eq = bell 50 1.5 0.6
+eq = bell 70 2.5 -0.6
+eq = bell 110 1 1.5
+eq = bell 160 1.5 -0.5
+eq = bell 2000 1.5 0.05
+eq = bell 10000 2 -0.1
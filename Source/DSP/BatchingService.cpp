@@ -0,0 +1,263 @@
+#include "BatchingService.h"
+#include <algorithm>
+
+namespace TapeHysteresis
+{
+
+namespace
+{
+
+// This thread's batching cycle (see BatchingService)
+thread_local uint64_t threadCycle = 1;
+
+} // namespace
+
+BatchingService::Slot* BatchingService::acquire()
+{
+    for (int i = 0; i < MAX_SLOTS; ++i)
+    {
+        int expected = Slot::FREE;
+        if (slots[i].state.compare_exchange_strong(expected, Slot::IDLE))
+        {
+            int used = numSlotsUsed.load();
+            while (used < i + 1 && !numSlotsUsed.compare_exchange_weak(used, i + 1))
+            {
+            }
+            return &slots[i];
+        }
+    }
+
+    return nullptr;
+}
+
+void BatchingService::release(Slot* slot)
+{
+    if (slot == nullptr)
+        return;
+
+    for (;;)
+    {
+        int expected = slot->state.load();
+        if (expected != Slot::PROCESSING && slot->state.compare_exchange_strong(expected, Slot::FREE))
+            return;
+
+        std::this_thread::yield();
+    }
+}
+
+void BatchingService::submit(Slot& slot, int numSamples)
+{
+    slot.numSamples.store(numSamples, std::memory_order_relaxed);
+    slot.submitter.store(std::this_thread::get_id(), std::memory_order_relaxed);
+    slot.cycle.store(threadCycle, std::memory_order_relaxed);
+    slot.state.store(Slot::PENDING, std::memory_order_release);
+}
+
+void BatchingService::render(const HybridTapeBatch::Lane* lanes, int numLanes, int numSamples)
+{
+    HybridTapeBatch::process(lanes, numLanes, numSamples);
+    numBatches.fetch_add(1, std::memory_order_relaxed);
+    numLanesRendered.fetch_add(static_cast<uint64_t>(numLanes), std::memory_order_relaxed);
+}
+
+void BatchingService::processPending(std::thread::id thread, uint64_t cycle, int numSamples)
+{
+    HybridTapeBatch::Lane lanes[MAX_LANES_PER_CALL];
+    Slot* claimed[MAX_LANES_PER_CALL];
+    int numLanes = 0, numClaimed = 0;
+
+    auto flush = [&]
+    {
+        render(lanes, numLanes, numSamples);
+        for (int i = 0; i < numClaimed; ++i)
+            claimed[i]->state.store(Slot::IDLE, std::memory_order_release);
+        numLanes = numClaimed = 0;
+    };
+
+    const int numUsed = numSlotsUsed.load(std::memory_order_acquire);
+    for (int i = 0; i < numUsed; ++i)
+    {
+        Slot& slot = slots[i];
+        if (slot.state.load(std::memory_order_relaxed) != Slot::PENDING
+            || slot.submitter.load(std::memory_order_relaxed) != thread
+            || slot.cycle.load(std::memory_order_relaxed) >= cycle
+            || slot.numSamples.load(std::memory_order_relaxed) != numSamples)
+            continue;
+
+        int expected = Slot::PENDING;
+        if (!slot.state.compare_exchange_strong(expected, Slot::PROCESSING, std::memory_order_acquire))
+            continue;
+
+        // Freed and re-submitted with another size since the check
+        if (slot.numSamples.load(std::memory_order_relaxed) != numSamples)
+        {
+            render(slot.lanes, slot.numLanes, slot.numSamples.load(std::memory_order_relaxed));
+            slot.state.store(Slot::IDLE, std::memory_order_release);
+            continue;
+        }
+
+        if (numLanes + slot.numLanes > MAX_LANES_PER_CALL)
+            flush();
+
+        for (int lane = 0; lane < slot.numLanes; ++lane)
+            lanes[numLanes++] = slot.lanes[lane];
+        claimed[numClaimed++] = &slot;
+    }
+
+    if (numClaimed > 0)
+        flush();
+}
+
+void BatchingService::finish(Slot& slot)
+{
+    // Back at a block submitted this cycle: everyone on the thread has had
+    // a turn, so this is the first instance of the next cycle
+    if (slot.state.load(std::memory_order_acquire) == Slot::PENDING
+        && slot.cycle.load(std::memory_order_relaxed) == threadCycle)
+        ++threadCycle;
+
+    processPending(std::this_thread::get_id(), threadCycle, slot.numSamples.load(std::memory_order_relaxed));
+
+    for (;;)
+    {
+        int expected = Slot::PENDING;
+        if (slot.state.compare_exchange_strong(expected, Slot::PROCESSING, std::memory_order_acquire))
+        {
+            render(slot.lanes, slot.numLanes, slot.numSamples.load(std::memory_order_relaxed));
+            slot.state.store(Slot::IDLE, std::memory_order_release);
+            return;
+        }
+
+        if (expected != Slot::PROCESSING)
+            return;
+
+        std::this_thread::yield();
+    }
+}
+
+BatchedCore::BatchedCore(BatchingService& batchingService, HybridTapeProcessor& leftCore,
+                         HybridTapeProcessor& rightCore, SoloFunction soloFunction)
+    : service(batchingService), left(leftCore), right(rightCore), solo(std::move(soloFunction))
+{
+}
+
+BatchedCore::~BatchedCore()
+{
+    stop();
+}
+
+void BatchedCore::prepare(int numChannelsToUse, int chunkSizeToUse)
+{
+    stop();
+
+    numChannels = std::clamp(numChannelsToUse, 1, 2);
+    chunkSize = std::max(1, chunkSizeToUse);
+    collecting.assign(static_cast<size_t>(numChannels) * chunkSize, 0.0f);
+    playing.assign(collecting.size(), 0.0f);
+}
+
+void BatchedCore::start()
+{
+    if (running || chunkSize == 0)
+        return;
+
+    // Starts out playing chunkSize frames of silence: the reported latency
+    std::fill(collecting.begin(), collecting.end(), 0.0f);
+    std::fill(playing.begin(), playing.end(), 0.0f);
+    position = 0;
+    submitted = false;
+    soloPending = false;
+
+    // No free slot: every chunk is rendered solo, same latency
+    slot = service.acquire();
+    running = true;
+}
+
+void BatchedCore::stop()
+{
+    if (!running)
+        return;
+
+    service.release(slot);
+    slot = nullptr;
+    running = false;
+}
+
+void BatchedCore::finishPending()
+{
+    if (soloPending)
+    {
+        float* channels[2] = { playingChannel(0), numChannels > 1 ? playingChannel(1) : nullptr };
+        solo(channels, numChannels, chunkSize);
+        soloPending = false;
+    }
+
+    if (submitted)
+    {
+        // First in this cycle: render everything this thread queued last
+        // cycle, ours included. Later (or moved to another thread): ours
+        // may be done, claimed, or still ours to render.
+        service.finish(*slot);
+        submitted = false;
+    }
+}
+
+void BatchedCore::process(float* const* channels, int numChannelsToProcess, int numSamples, bool shareable)
+{
+    finishPending();
+
+    const int numToProcess = std::min(numChannelsToProcess, numChannels);
+
+    for (int start = 0; start < numSamples;)
+    {
+        const int numFrames = std::min(numSamples - start, chunkSize - position);
+
+        for (int ch = 0; ch < numToProcess; ++ch)
+        {
+            float* data = channels[ch] + start;
+            float* input = collecting.data() + static_cast<size_t>(ch) * chunkSize + position;
+            const float* output = playingChannel(ch) + position;
+
+            for (int i = 0; i < numFrames; ++i)
+            {
+                const float x = data[i];
+                data[i] = output[i];
+                input[i] = x;
+            }
+        }
+
+        start += numFrames;
+        position += numFrames;
+
+        if (position == chunkSize)
+        {
+            // The chunk just played out becomes the next one collected
+            std::swap(collecting, playing);
+            position = 0;
+            submit(shareable);
+
+            // More of this block to play: it needs the chunk now
+            if (start < numSamples)
+                finishPending();
+        }
+    }
+}
+
+void BatchedCore::submit(bool shareable)
+{
+    if (!shareable || slot == nullptr)
+    {
+        soloPending = true;
+        return;
+    }
+
+    slot->numLanes = numChannels;
+    slot->lanes[0] = { &left, playingChannel(0), false };
+    if (numChannels > 1)
+        slot->lanes[1] = { &right, playingChannel(1), true };
+
+    service.submit(*slot, chunkSize);
+    submitted = true;
+}
+
+} // namespace TapeHysteresis
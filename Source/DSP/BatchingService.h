@@ -0,0 +1,165 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <thread>
+#include <vector>
+#include "HybridTapeBatch.h"
+
+namespace TapeHysteresis
+{
+
+/**
+ * Batching Service - process-wide cross-instance batching (opt-in, the
+ * plugin's "Cross-Instance Batch")
+ *
+ * Every instance runs its own cores, and each core is one long serial
+ * dependency chain that leaves most of the CPU idle. In batch mode an
+ * instance defers its core work by one block (BatchedCore): the block it
+ * just upsampled is submitted to this service, and the first instance to
+ * reach the service in the next cycle renders every submitted block - its
+ * own and the other instances' - through HybridTapeBatch, several cores in
+ * lock step. Each instance then plays the block rendered for it, one block
+ * (reported as latency) after it went in.
+ *
+ * Cycles are counted per thread: a submission is stamped with its thread's
+ * current cycle, and the cycle advances when an instance comes back to a
+ * block it submitted in the current one (every instance on the thread has
+ * had its turn since). Only blocks from earlier cycles are claimed, so the
+ * first instance of a cycle renders all of the last cycle's blocks in one
+ * go instead of picking up the ones its neighbours submitted moments ago.
+ *
+ * Only blocks submitted from the caller's own thread with the same size are
+ * picked up: hosts that spread instances over threads keep that
+ * parallelism, and instances whose blocks don't line up render their own.
+ * Slots change hands by compare-and-swap; the only wait is an owner whose
+ * block another thread is rendering right then (the host moved it between
+ * threads), which yields until it is done.
+ *
+ * The plugin shares one instance per process (juce::SharedResourcePointer).
+ */
+class BatchingService
+{
+public:
+    static constexpr int MAX_SLOTS = 512;
+
+    struct Slot
+    {
+        enum State { FREE, IDLE, PENDING, PROCESSING };
+
+        std::atomic<int> state { FREE };
+        std::atomic<std::thread::id> submitter {};
+        std::atomic<uint64_t> cycle { 0 };
+        std::atomic<int> numSamples { 0 };
+
+        // Written by the owner while idle, read by whoever claims the slot
+        HybridTapeBatch::Lane lanes[2];
+        int numLanes = 0;
+    };
+
+    BatchingService() = default;
+
+    BatchingService(const BatchingService&) = delete;
+    BatchingService& operator=(const BatchingService&) = delete;
+
+    // Message thread. nullptr when every slot is taken.
+    Slot* acquire();
+
+    // Message thread: waits out a claim in progress, the slot is unused after
+    void release(Slot* slot);
+
+    // Audio thread: queues the slot's lanes (set while idle) for the next cycle
+    void submit(Slot& slot, int numSamples);
+
+    // Audio thread: renders every earlier-cycle block of this thread and
+    // size that nobody has claimed yet, then the slot's own if it is still
+    // pending; otherwise returns once whoever claimed it is done
+    void finish(Slot& slot);
+
+    // HybridTapeBatch::process calls made and lanes rendered by them
+    uint64_t getNumBatches() const { return numBatches.load(std::memory_order_relaxed); }
+    uint64_t getNumLanes() const { return numLanesRendered.load(std::memory_order_relaxed); }
+
+private:
+    static constexpr int MAX_LANES_PER_CALL = 32;
+
+    Slot slots[MAX_SLOTS];
+    std::atomic<int> numSlotsUsed { 0 };    // Every slot in use is below this
+    std::atomic<uint64_t> numBatches { 0 }, numLanesRendered { 0 };
+
+    void processPending(std::thread::id thread, uint64_t cycle, int numSamples);
+    void render(const HybridTapeBatch::Lane* lanes, int numLanes, int numSamples);
+};
+
+/**
+ * One instance's end of the BatchingService: the core stage with exactly
+ * chunkSize (oversampled) frames of latency.
+ *
+ * Input is collected into chunkSize-frame chunks; a full chunk is submitted
+ * and played back while the next one is collected. With host blocks of
+ * chunkSize frames every chunk is complete at the end of a block and is
+ * rendered at the start of the next cycle, batched with the other
+ * instances'. Other block sizes complete chunks mid-block, which are
+ * rendered on the spot (still batched with anything else pending on the
+ * thread) - the latency is the same either way.
+ *
+ * prepare / start / stop must not overlap process() - call them from
+ * prepareToPlay / releaseResources or with processing suspended.
+ */
+class BatchedCore
+{
+public:
+    // Renders one chunk in place on the calling thread - used instead of the
+    // service when the chunk must not be shared (B-H probe) or no slot is free
+    using SoloFunction = std::function<void(float* const* channels, int numChannels, int numSamples)>;
+
+    BatchedCore(BatchingService& service, HybridTapeProcessor& leftCore, HybridTapeProcessor& rightCore,
+                SoloFunction soloFunction);
+    ~BatchedCore();
+
+    BatchedCore(const BatchedCore&) = delete;
+    BatchedCore& operator=(const BatchedCore&) = delete;
+
+    void prepare(int numChannelsToUse, int chunkSizeToUse);
+    void start();
+    void stop();
+    bool isRunning() const { return running; }
+    int getChunkSize() const { return chunkSize; }
+
+    // Chunk buffers allocated by prepare (telemetry footprint)
+    size_t getBufferBytes() const { return sizeof(float) * static_cast<size_t>(numChannels) * 2 * static_cast<size_t>(chunkSize); }
+
+    // Audio thread: call before touching the cores (setParameters...) -
+    // returns once no other thread is rendering this instance's chunk
+    void finishPending();
+
+    // Audio thread: replaces the oversampled block with the core output of
+    // chunkSize frames ago. shareable = false renders this instance's
+    // chunks itself.
+    void process(float* const* channels, int numChannelsToProcess, int numSamples, bool shareable);
+
+private:
+    BatchingService& service;
+    HybridTapeProcessor& left;
+    HybridTapeProcessor& right;
+    SoloFunction solo;
+
+    BatchingService::Slot* slot = nullptr;
+    int numChannels = 0;
+    int chunkSize = 0;
+    bool running = false;
+
+    // Audio thread state: the chunk being collected, and the one playing
+    // (rendered by finishPending once submitted or marked solo), channels
+    // chunkSize apart
+    std::vector<float> collecting, playing;
+    int position = 0;
+    bool submitted = false;
+    bool soloPending = false;
+
+    float* playingChannel(int ch) { return playing.data() + static_cast<size_t>(ch) * chunkSize; }
+    void submit(bool shareable);
+};
+
+} // namespace TapeHysteresis
@@ -0,0 +1,423 @@
+#include "BiasReference.h"
+
+#define _USE_MATH_DEFINES
+#include <cmath>
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <numeric>
+#include <thread>
+
+namespace TapeHysteresis
+{
+
+namespace
+{
+
+constexpr int LANES = BiasReference::LANES;
+constexpr int MAX_STAGES = 24;
+
+long floorHalf(long n)
+{
+    return (n >= 0) ? n / 2 : -((1 - n) / 2);
+}
+
+struct Range
+{
+    long lo = 0, hi = 0;     // [lo, hi)
+};
+
+// Samples [start, start + data.size()) of a signal
+struct Span
+{
+    long start = 0;
+    std::vector<double> data;
+
+    double at(long n) const { return data[(size_t)(n - start)]; }
+};
+
+struct MediumState
+{
+    double M = 0.0;
+    double H = 0.0;      // Previous field
+
+    bool operator==(const MediumState& other) const { return M == other.M && H == other.H; }
+};
+
+// Modified Bessel function of the first kind, order 0 (Kaiser window)
+double besselI0(double x)
+{
+    double sum = 1.0, term = 1.0;
+    for (int i = 1; i < 100 && term > 1e-17 * sum; ++i)
+    {
+        const double t = x / (2.0 * i);
+        term *= t * t;
+        sum += term;
+    }
+    return sum;
+}
+
+// Halfband lowpass between lowRate and 2 lowRate, passing [0, passband].
+// Returns the odd taps c[k] = h[+/-(2k + 1)]; h[0] = 0.5, even taps are 0.
+std::vector<double> designHalfband(double lowRate, double passband)
+{
+    const double attenuation = BiasReference::STOPBAND_DB;
+    const double transition = 2.0 * M_PI * (lowRate - 2.0 * passband) / (2.0 * lowRate);
+    const double beta = 0.1102 * (attenuation - 8.7);
+    const double length = (attenuation - 7.95) / (2.285 * transition) + 1.0;
+    const int half = (int)std::ceil((length - 1.0) / 2.0);
+    const int numTaps = std::max(1, (half + 2) / 2);
+
+    std::vector<double> c((size_t)numTaps);
+    const double span = 2.0 * numTaps;
+    double sum = 0.0;
+    for (int k = 0; k < numTaps; ++k)
+    {
+        const double n = 2.0 * k + 1.0;
+        const double r = n / span;
+        const double window = besselI0(beta * std::sqrt(1.0 - r * r)) / besselI0(beta);
+        c[(size_t)k] = std::sin(M_PI * n / 2.0) / (M_PI * n) * window;
+        sum += c[(size_t)k];
+    }
+
+    // Unity DC gain: h[0] + 2 sum(c) = 1
+    for (double& tap : c)
+        tap *= 0.25 / sum;
+    return c;
+}
+
+// Upsampling stage: x at the low rate -> [out.lo, out.hi) at twice the rate.
+// Even outputs are the input samples (h[0] = 0.5, gain 2), odd outputs the
+// odd taps' FIR.
+Span upsample(const Span& x, const std::vector<double>& c, Range out)
+{
+    const long first = floorHalf(out.lo);
+    const long count = floorHalf(out.hi - 1) - first + 1;
+    std::vector<double> odd((size_t)count, 0.0);
+
+    // Tap-outer: the inner loop vectorizes, and each output still sums its
+    // taps in the same order wherever the chunk starts
+    for (size_t k = 0; k < c.size(); ++k)
+    {
+        const double tap = 2.0 * c[k];
+        const double* before = &x.data[(size_t)(first - (long)k - x.start)];
+        const double* after = &x.data[(size_t)(first + 1 + (long)k - x.start)];
+        for (long m = 0; m < count; ++m)
+            odd[(size_t)m] += tap * (before[m] + after[m]);
+    }
+
+    Span y;
+    y.start = out.lo;
+    y.data.resize((size_t)(out.hi - out.lo));
+    for (long n = out.lo; n < out.hi; ++n)
+    {
+        const long m = floorHalf(n);
+        y.data[(size_t)(n - out.lo)] = (n - 2 * m == 0) ? x.at(m) : odd[(size_t)(m - first)];
+    }
+    return y;
+}
+
+// Decimation stage: x at the high rate -> [out.lo, out.hi) at half the rate
+Span decimate(const Span& x, const std::vector<double>& c, Range out)
+{
+    Span y;
+    y.start = out.lo;
+    const long count = out.hi - out.lo;
+    y.data.resize((size_t)count);
+
+    const double* centre = &x.data[(size_t)(2 * out.lo - x.start)];
+    for (long m = 0; m < count; ++m)
+        y.data[(size_t)m] = 0.5 * centre[2 * m];
+
+    for (size_t k = 0; k < c.size(); ++k)
+    {
+        const double tap = c[k];
+        const long offset = 2 * (long)k + 1;
+        for (long m = 0; m < count; ++m)
+            y.data[(size_t)m] += tap * (centre[2 * m - offset] + centre[2 * m + offset]);
+    }
+    return y;
+}
+
+// sin(2 pi f n / rate) at exact phase: (n f) mod rate, periodic in n. A
+// table over the period when it is short (rates and bias in whole Hz).
+struct Oscillator
+{
+    int64_t frequency = 0, rate = 1, period = 1;
+    std::vector<double> table;
+
+    Oscillator(double f, double sampleRate)
+    {
+        frequency = std::llround(f);
+        rate = std::max<int64_t>(1, std::llround(sampleRate));
+        period = rate / std::gcd(frequency, rate);
+        if (period <= (1 << 20))
+        {
+            table.resize((size_t)period);
+            for (int64_t j = 0; j < period; ++j)
+                table[(size_t)j] = phaseValue(j);
+        }
+    }
+
+    double phaseValue(int64_t j) const
+    {
+        return std::sin(2.0 * M_PI * (double)((j * frequency) % rate) / (double)rate);
+    }
+
+    double operator()(long n) const
+    {
+        int64_t j = n % period;
+        if (j < 0) j += period;
+        return table.empty() ? phaseValue(j) : table[(size_t)j];
+    }
+};
+
+struct Context
+{
+    const std::vector<double>& input;
+    const BiasReference::Settings& settings;
+    int stages = 0;
+    long chunkLength = 0;
+    long warmUp = 0;                         // Internal samples
+    std::vector<std::vector<double>> taps;   // [s]: stage s-1 <-> s, s = 1..stages
+    Oscillator oscillator;
+    std::vector<double>& output;
+
+    struct Plan
+    {
+        Range up[MAX_STAGES + 1];      // Field needed at each rate, [stages] = medium run
+        Range down[MAX_STAGES + 1];    // Magnetization needed at each rate, [0] = the chunk
+    };
+
+    Plan plan(long chunkStart) const
+    {
+        Plan p;
+        p.down[0] = { chunkStart, chunkStart + chunkLength };
+        for (int s = 1; s <= stages; ++s)
+        {
+            const long reach = 2 * (long)taps[(size_t)s].size() - 1;
+            p.down[s] = { 2 * p.down[s - 1].lo - reach, 2 * p.down[s - 1].hi + reach - 1 };
+        }
+
+        p.up[stages] = { p.down[stages].lo - warmUp, p.down[stages].hi };
+        for (int s = stages; s >= 1; --s)
+        {
+            const long reach = (long)taps[(size_t)s].size();
+            p.up[s - 1] = { floorHalf(p.up[s].lo) - reach + 1, floorHalf(p.up[s].hi - 1) + reach + 1 };
+        }
+        return p;
+    }
+};
+
+using Parameters = JilesAthertonCore::Parameters;
+
+// JilesAthertonCore::solveNR8 on the field samples of numLanes lanes in lock
+// step (independent Newton chains interleaved), magnetization written over
+// the field. T H_d is the field step itself: newtonStep with T = 1.
+void runMedium(const Parameters& p, double* const* samples, int numLanes, long from, long to,
+               MediumState* state)
+{
+    const auto constants = JilesAthertonCore::makeConstants(p.M_s, p.a, p.k, p.c, p.alpha);
+    double M[LANES], Hprev[LANES];
+    for (int l = 0; l < numLanes; ++l)
+    {
+        M[l] = state[l].M;
+        Hprev[l] = state[l].H;
+    }
+
+    for (long i = from; i < to; ++i)
+    {
+        double H[LANES], dH[LANES], Mn[LANES];
+        for (int l = 0; l < numLanes; ++l)
+        {
+            H[l] = samples[l][i];
+            dH[l] = H[l] - Hprev[l];
+            Mn[l] = M[l];
+        }
+
+        for (int iteration = 0; iteration < BiasReference::NEWTON_ITERATIONS; ++iteration)
+            for (int l = 0; l < numLanes; ++l)
+                JilesAthertonCore::newtonStep(constants, 1.0, H[l], dH[l], M[l], Mn[l]);
+
+        for (int l = 0; l < numLanes; ++l)
+        {
+            samples[l][i] = Mn[l];
+            M[l] = Mn[l];
+            Hprev[l] = H[l];
+        }
+    }
+
+    for (int l = 0; l < numLanes; ++l)
+        state[l] = { M[l], Hprev[l] };
+}
+
+struct ChunkResult
+{
+    MediumState entry;      // At the end of the warm-up
+    MediumState exit;       // Where the next chunk's warm-up ends
+};
+
+// Renders up to LANES chunks side by side into the output. handedOver:
+// nullptr = each lane warms up demagnetized; otherwise the state at the end
+// of the warm-up, per lane.
+void renderChunks(const Context& context, const long* chunkStarts, int numLanes,
+                  const MediumState* handedOver, ChunkResult* results)
+{
+    const BiasReference::Settings& settings = context.settings;
+    const int stages = context.stages;
+    const long inputLength = (long)context.input.size();
+
+    Span field[LANES];
+    Context::Plan plans[LANES];
+    double* samples[LANES];
+    for (int l = 0; l < numLanes; ++l)
+    {
+        const Context::Plan& plan = plans[l] = context.plan(chunkStarts[l]);
+
+        // Input (silence past its ends) up to the internal rate
+        Span x;
+        x.start = plan.up[0].lo;
+        x.data.resize((size_t)(plan.up[0].hi - plan.up[0].lo));
+        for (long n = plan.up[0].lo; n < plan.up[0].hi; ++n)
+            x.data[(size_t)(n - x.start)] = (n >= 0 && n < inputLength) ? context.input[(size_t)n] : 0.0;
+        for (int s = 1; s <= stages; ++s)
+            x = upsample(x, context.taps[(size_t)s], plan.up[s]);
+
+        // Record field: audio + bias
+        const double audioScale = settings.medium.k * settings.audioField;
+        const double biasScale = settings.medium.k * settings.biasField;
+        for (size_t i = 0; i < x.data.size(); ++i)
+            x.data[i] = audioScale * x.data[i] + biasScale * context.oscillator(x.start + (long)i);
+
+        field[l] = std::move(x);
+        samples[l] = field[l].data.data();
+    }
+
+    // All lanes run the same lengths: chunks are equally long
+    const long warmUp = context.warmUp;
+    const long exit = warmUp + context.chunkLength * (1L << stages);
+    const long length = (long)field[0].data.size();
+
+    MediumState state[LANES];
+    if (handedOver == nullptr)
+    {
+        runMedium(settings.medium, samples, numLanes, 0, warmUp, state);
+    }
+    else
+    {
+        for (int l = 0; l < numLanes; ++l)
+            state[l] = handedOver[l];
+    }
+    for (int l = 0; l < numLanes; ++l)
+        results[l].entry = state[l];
+
+    runMedium(settings.medium, samples, numLanes, warmUp, exit, state);
+    for (int l = 0; l < numLanes; ++l)
+        results[l].exit = state[l];
+    runMedium(settings.medium, samples, numLanes, exit, length, state);
+
+    // Magnetization back down to the audio rate
+    const double scale = 1.0 / settings.medium.M_s;
+    for (int l = 0; l < numLanes; ++l)
+    {
+        Span m = std::move(field[l]);
+        for (int s = stages; s >= 1; --s)
+            m = decimate(m, context.taps[(size_t)s], plans[l].down[s - 1]);
+
+        const long end = std::min(m.start + (long)m.data.size(), (long)context.output.size());
+        for (long n = m.start; n < end; ++n)
+            context.output[(size_t)n] = m.at(n) * scale;
+    }
+}
+
+} // namespace
+
+BiasReference::Settings BiasReference::ampexATR102()
+{
+    Settings settings;
+    settings.biasFrequency = 432000.0;
+    return settings;
+}
+
+BiasReference::Settings BiasReference::studerA820()
+{
+    Settings settings;
+    settings.biasFrequency = 153600.0;
+    return settings;
+}
+
+std::vector<double> BiasReference::record(const std::vector<double>& input, double sampleRate,
+                                          const Settings& settings, Stats* stats)
+{
+    std::vector<double> output(input.size(), 0.0);
+
+    int stages = 0;
+    while (stages < MAX_STAGES && sampleRate * (double)(1L << stages) < settings.stepsPerCycle * settings.biasFrequency)
+        ++stages;
+    const double internalRate = sampleRate * (double)(1L << stages);
+
+    Context context { input, settings, stages, 0, 0, {}, Oscillator(settings.biasFrequency, internalRate), output };
+    context.chunkLength = (settings.chunkLength > 0) ? settings.chunkLength : std::max<long>(1, (long)input.size());
+    context.warmUp = (long)std::ceil(HANDOFF_CYCLES * internalRate / settings.biasFrequency);
+    context.taps.resize((size_t)stages + 1);
+    for (int s = 1; s <= stages; ++s)
+        context.taps[(size_t)s] = designHalfband(sampleRate * (double)(1L << (s - 1)), PASSBAND * sampleRate);
+
+    const long numChunks = input.empty() ? 0 : ((long)input.size() + context.chunkLength - 1) / context.chunkLength;
+    std::vector<long> chunkStarts((size_t)numChunks);
+    for (long i = 0; i < numChunks; ++i)
+        chunkStarts[(size_t)i] = i * context.chunkLength;
+    std::vector<ChunkResult> results((size_t)numChunks);
+
+    // Groups of LANES consecutive chunks, spread over the threads
+    const long numGroups = (numChunks + LANES - 1) / LANES;
+    std::atomic<long> nextGroup { 0 };
+    auto worker = [&]()
+    {
+        for (long g = nextGroup++; g < numGroups; g = nextGroup++)
+        {
+            const long first = g * LANES;
+            const int numLanes = (int)std::min<long>(LANES, numChunks - first);
+            renderChunks(context, &chunkStarts[(size_t)first], numLanes, nullptr, &results[(size_t)first]);
+        }
+    };
+
+    int numThreads = (settings.threads > 0) ? settings.threads : (int)std::thread::hardware_concurrency();
+    numThreads = (int)std::clamp<long>(numThreads, 1, std::max<long>(1, numGroups));
+    std::vector<std::thread> threads;
+    for (int t = 1; t < numThreads; ++t)
+        threads.emplace_back(worker);
+    worker();
+    for (std::thread& thread : threads)
+        thread.join();
+
+    // Verify the handoffs in order; a chunk whose warm-up did not reach its
+    // predecessor's state is rendered again from that state
+    int rerendered = 0;
+    for (long i = 1; i < numChunks; ++i)
+    {
+        if (!(results[(size_t)i].entry == results[(size_t)i - 1].exit))
+        {
+            const MediumState handedOver = results[(size_t)i - 1].exit;
+            renderChunks(context, &chunkStarts[(size_t)i], 1, &handedOver, &results[(size_t)i]);
+            ++rerendered;
+        }
+    }
+
+    if (stats != nullptr)
+    {
+        stats->oversampling = 1 << stages;
+        stats->internalRate = internalRate;
+        stats->stages = stages;
+        stats->chunks = (int)numChunks;
+        stats->rerendered = rerendered;
+    }
+    return output;
+}
+
+} // namespace TapeHysteresis
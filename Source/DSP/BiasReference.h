@@ -0,0 +1,84 @@
+#pragma once
+
+#include <vector>
+#include "JilesAthertonCore.h"
+
+namespace TapeHysteresis
+{
+
+/**
+ * Bias Reference - offline AC-bias recording simulator
+ *
+ * HFCut stands in for AC bias with two fixed shelves; this is the physics it
+ * replaces, for checking and re-fitting it. The audio is upsampled to a rate
+ * that resolves the bias oscillator (Settings::stepsPerCycle - 197 MHz for
+ * the ATR-102's 432 kHz at 48 or 96 kHz), the record field
+ *
+ *   H = k * (audioField * input + biasField * sin(2 pi biasFrequency t))
+ *
+ * drives a Jiles-Atherton medium (JilesAthertonCore's equations), and the
+ * magnetization M / M_s is decimated back. No realtime shortcuts: no HFCut,
+ * no blends, no level model - the bias alone linearizes.
+ *
+ * The medium reverses twice per bias cycle, somewhere between two steps;
+ * that timing error is what limits accuracy. H1 settles at a few dozen
+ * steps per cycle, the low-level harmonics (H3 at 0.01-0.1%) only from
+ * about 256 - below that they scatter by a factor of 2 or more.
+ *
+ * Resampling is a cascade of 2x halfband FIR stages, each designed (Kaiser,
+ * STOPBAND_DB) for its own transition band only - passband to PASSBAND of
+ * the audio rate, so every stage after the first is short. Halfband polyphase
+ * form: upsampling copies the even outputs and computes the odd ones from
+ * the nonzero odd taps, decimation touches only the odd taps and the centre.
+ * The filters are zero-phase (no latency); everything past the input's ends
+ * is silence.
+ *
+ * Rendering is split into chunks, LANES chunks stepped side by side through
+ * the medium (independent Newton chains interleaved, as HybridTapeBatch)
+ * and lane groups spread over threads. Each chunk starts demagnetized
+ * HANDOFF_CYCLES bias cycles early: the bias erases the medium's memory, so
+ * the warmed-up chunk reaches the state its predecessor hands over to the
+ * last bit. The handoff is verified - each chunk's state at its start is
+ * compared with the predecessor's, and a chunk that does not match (weak or
+ * no bias) is re-rendered from the handed-over state. The result is
+ * identical to one serial render, whatever the chunking or thread count.
+ */
+class BiasReference
+{
+public:
+    static constexpr int LANES = 4;
+    static constexpr int NEWTON_ITERATIONS = 4;      // Converged to rounding at MHz steps
+    static constexpr int HANDOFF_CYCLES = 64;
+    static constexpr double PASSBAND = 0.45;         // Of the audio rate
+    static constexpr double STOPBAND_DB = 140.0;
+
+    struct Settings
+    {
+        double biasFrequency = 432000.0;                 // Hz
+        double biasField = 1.0;                          // Peak, in units of the medium's k
+        double audioField = 0.3;                         // Field per unit input, in units of k
+        int stepsPerCycle = 256;                         // Per bias cycle, at least (see below)
+        JilesAthertonCore::Parameters medium;            // Defaults: tape medium
+        int chunkLength = 1024;                          // Audio samples per chunk, 0 = one chunk
+        int threads = 0;                                 // 0 = hardware concurrency
+    };
+
+    // Bias oscillators of the two machines (BiasShielding.h)
+    static Settings ampexATR102();
+    static Settings studerA820();
+
+    struct Stats
+    {
+        int oversampling = 0;          // Internal rate / audio rate
+        double internalRate = 0.0;
+        int stages = 0;                // Halfband stages each way
+        int chunks = 0;
+        int rerendered = 0;            // Chunks whose handoff did not match
+    };
+
+    // Normalized magnetization M / M_s for `input` recorded at sampleRate
+    static std::vector<double> record(const std::vector<double>& input, double sampleRate,
+                                      const Settings& settings, Stats* stats = nullptr);
+};
+
+} // namespace TapeHysteresis
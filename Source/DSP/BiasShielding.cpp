@@ -4,23 +4,6 @@
 namespace TapeHysteresis
 {
 
-// High shelf filter design
-static void designHighShelf(Biquad& filter, double fc, double gainDB, double Q, double fs)
-{
-    double A = std::pow(10.0, gainDB / 40.0);
-    double omega = 2.0 * M_PI * fc / fs;
-    double cosOmega = std::cos(omega);
-    double sinOmega = std::sin(omega);
-    double alpha = sinOmega / (2.0 * Q);
-
-    double a0 = (A + 1.0) - (A - 1.0) * cosOmega + 2.0 * std::sqrt(A) * alpha;
-    filter.b0 = (A * ((A + 1.0) + (A - 1.0) * cosOmega + 2.0 * std::sqrt(A) * alpha)) / a0;
-    filter.b1 = (-2.0 * A * ((A - 1.0) + (A + 1.0) * cosOmega)) / a0;
-    filter.b2 = (A * ((A + 1.0) + (A - 1.0) * cosOmega - 2.0 * std::sqrt(A) * alpha)) / a0;
-    filter.a1 = (2.0 * ((A - 1.0) - (A + 1.0) * cosOmega)) / a0;
-    filter.a2 = ((A + 1.0) - (A - 1.0) * cosOmega - 2.0 * std::sqrt(A) * alpha) / a0;
-}
-
 HFCut::HFCut()
 {
     updateCoefficients();
@@ -44,37 +27,87 @@ void HFCut::setMachineMode(bool isAmpex)
 
 void HFCut::reset()
 {
-    shelf1.reset();
-    shelf2.reset();
+    z1[0] = z1[1] = 0.0;
+    z2[0] = z2[1] = 0.0;
+}
+
+void HFCut::setCoefficients(const HFCutCoefficients* section)
+{
+    coefficients = section;
 }
 
 void HFCut::updateCoefficients()
 {
-    double nyquist = fs / 2.0;
+    // AMPEX ATR-102: 432 kHz bias / STUDER A820: 153.6 kHz bias
+    const MachineProfile profile = ampexMode ? MachineProfile::ampexATR102() : MachineProfile::studerA820();
+    CompiledProfile::compileHFCut(profile, fs, builtIn);
+}
 
-    if (ampexMode)
+double HFCut::processSample(double input)
+{
+    double x = input;
+    for (int i = 0; i < 2; ++i)
     {
-        // AMPEX ATR-102: 432 kHz bias
-        // Flat to 8kHz, -8dB at 20kHz
-        double shelf1Freq = std::min(8000.0, nyquist * 0.9);
-        double shelf2Freq = std::min(14000.0, nyquist * 0.85);
-        designHighShelf(shelf1, shelf1Freq, -4.0, 0.7, fs);
-        designHighShelf(shelf2, shelf2Freq, -4.0, 0.7, fs);
+        const BiquadCoefficients& c = coefficients->shelves[i];
+        double output = c.b0 * x + z1[i];
+        z1[i] = c.b1 * x - c.a1 * output + z2[i];
+        z2[i] = c.b2 * x - c.a2 * output;
+        x = output;
     }
-    else
+    return x;
+}
+
+SelfErasure::SelfErasure()
+{
+    updateCoefficients();
+    reset();
+}
+
+void SelfErasure::setSampleRate(double sampleRate)
+{
+    fs = sampleRate;
+    updateCoefficients();
+}
+
+void SelfErasure::setMachineMode(bool isAmpex)
+{
+    if (ampexMode != isAmpex)
     {
-        // STUDER A820: 153.6 kHz bias
-        // Flat to 6kHz, -12dB at 20kHz
-        double shelf1Freq = std::min(6000.0, nyquist * 0.9);
-        double shelf2Freq = std::min(12000.0, nyquist * 0.85);
-        designHighShelf(shelf1, shelf1Freq, -6.0, 0.7, fs);
-        designHighShelf(shelf2, shelf2Freq, -6.0, 0.7, fs);
+        ampexMode = isAmpex;
+        updateCoefficients();
     }
 }
 
-double HFCut::processSample(double input)
+void SelfErasure::reset()
+{
+    z1 = z2 = 0.0;
+}
+
+void SelfErasure::setCoefficients(const SelfErasureTable* section)
+{
+    table = section;
+}
+
+void SelfErasure::updateCoefficients()
+{
+    // AMPEX ATR-102: little self-erasure / STUDER A820: earlier and deeper
+    const MachineProfile profile = ampexMode ? MachineProfile::ampexATR102() : MachineProfile::studerA820();
+    CompiledProfile::compileSelfErasure(profile, fs, builtIn);
+}
+
+double SelfErasure::getShelfGainDB(double envelope) const
+{
+    return table->maxCutDB * table->control(envelope);
+}
+
+double SelfErasure::processSample(double input, double envelope)
+{
+    return table->process(table->control(envelope), input, z1, z2);
+}
+
+double SelfErasure::processFlat(double input)
 {
-    return shelf2.process(shelf1.process(input));
+    return table->process(0.0, input, z1, z2);
 }
 
 } // namespace TapeHysteresis
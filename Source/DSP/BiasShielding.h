@@ -7,26 +7,12 @@
 #define M_PI 3.14159265358979323846
 #endif
 
+#include "MachineProfile.h"
+
 namespace TapeHysteresis
 {
 
-// Biquad filter (Direct Form II Transposed)
-struct Biquad
-{
-    double b0 = 1.0, b1 = 0.0, b2 = 0.0;
-    double a1 = 0.0, a2 = 0.0;
-    double z1 = 0.0, z2 = 0.0;
-
-    void reset() { z1 = z2 = 0.0; }
-
-    double process(double input)
-    {
-        double output = b0 * input + z1;
-        z1 = b1 * input - a1 * output + z2;
-        z2 = b2 * input - a2 * output;
-        return output;
-    }
-};
+class HybridTapeBatch;
 
 // HFCut - Cut HF before saturation (models AC bias shielding)
 //
@@ -39,23 +25,84 @@ struct Biquad
 //   Ampex ATR-102: 432 kHz (excellent HF linearity)
 //   Studer A820:   153.6 kHz (good HF linearity)
 //
-// Target curves:
+// Target curves (MachineProfile::hfCut):
 //   ATR-102: Flat to 8kHz, -8dB at 20kHz
 //   A820:    Flat to 6kHz, -12dB at 20kHz
 class HFCut
 {
 public:
     HFCut();
+    HFCut(const HFCut&) = delete;
+    HFCut& operator=(const HFCut&) = delete;
+
     void setSampleRate(double sampleRate);
     void setMachineMode(bool isAmpex);
     void reset();
     double processSample(double input);
 
+    // Use an externally owned section (must outlive this object / the next call)
+    void setCoefficients(const HFCutCoefficients* section);
+
+private:
+    friend class HybridTapeBatch;
+
+    double fs = 48000.0;
+    bool ampexMode = true;
+
+    HFCutCoefficients builtIn;     // Standalone: current built-in machine
+    const HFCutCoefficients* coefficients = &builtIn;
+    double z1[2] = {};             // Shelf state - coefficients read from the section
+    double z2[2] = {};
+
+    void updateCoefficients();
+};
+
+// SelfErasure - Level-dependent HF loss (self-erasure / HF compression)
+//
+// At high record levels the HF bias-field interaction partially erases the
+// short wavelengths just written, so HF compresses as level rises. Modeled
+// as a high shelf that darkens with the saturation envelope (jaEnvelope).
+//
+// Coefficients come from a table of shelves precomputed per sample rate /
+// machine, indexed by the control value and linearly interpolated - no trig
+// per sample, cheap enough for the oversampled rate.
+//
+// Targets (max cut reached at +6dB, MachineProfile::selfErasure*):
+//   ATR-102: engages above -6dB, -2.0dB shelf @ 12kHz (432 kHz bias)
+//   A820:    engages above -9dB, -3.5dB shelf @ 10kHz (153.6 kHz bias)
+class SelfErasure
+{
+public:
+    SelfErasure();
+    SelfErasure(const SelfErasure&) = delete;
+    SelfErasure& operator=(const SelfErasure&) = delete;
+
+    void setSampleRate(double sampleRate);
+    void setMachineMode(bool isAmpex);
+    void reset();
+    double processSample(double input, double envelope);
+
+    // Envelope known to be under the threshold (linear fast path): the flat
+    // shelf, i.e. the input plus whatever is left of the last engagement
+    double processFlat(double input);
+
+    // Use an externally owned table (must outlive this object / the next call)
+    void setCoefficients(const SelfErasureTable* section);
+
+    // Shelf gain (dB) applied at a given envelope value
+    double getShelfGainDB(double envelope) const;
+
+    static constexpr int TABLE_SIZE = SelfErasureTable::TABLE_SIZE;
+
 private:
+    friend class HybridTapeBatch;
+
+    SelfErasureTable builtIn;      // Standalone: current built-in machine
+    const SelfErasureTable* table = &builtIn;
+    double z1 = 0.0, z2 = 0.0;
+
     double fs = 48000.0;
     bool ampexMode = true;
-    Biquad shelf1;
-    Biquad shelf2;
 
     void updateCoefficients();
 };
@@ -0,0 +1,85 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+
+namespace TapeHysteresis
+{
+
+// Normalized biquad coefficients (a0 = 1), Direct Form II Transposed
+struct BiquadCoefficients
+{
+    double b0 = 1.0, b1 = 0.0, b2 = 0.0;
+    double a1 = 0.0, a2 = 0.0;
+};
+
+// Periodic steady state of a DF2T biquad
+//
+// A DF2T biquad is the state-space system
+//   y[n]   = z1[n] + b0 x[n]
+//   z[n+1] = A z[n] + B x[n],   A = | -a1  1 |   B = | b1 - a1 b0 |
+//                                   | -a2  0 |       | b2 - a2 b0 |
+// Driven by `period` repeated forever, the state at the start of every
+// period converges to the fixed point s = A^N s + r (N: period length,
+// r: state after one period from rest), so
+//   s = (I - A^N)^-1 r
+// removes the start-up transient outright instead of waiting for it to
+// decay. A constant with N = 1 gives the DC steady state.
+//
+// In place: the period is replaced by the steady-state output, and z1 / z2
+// are left at s (where the period ends, the next one starts).
+inline void settleBiquad(const BiquadCoefficients& c, double* period, int numSamples, double& z1, double& z2)
+{
+    // r: one period from rest
+    double r1 = 0.0, r2 = 0.0;
+    for (int n = 0; n < numSamples; ++n)
+    {
+        const double output = c.b0 * period[n] + r1;
+        r1 = c.b1 * period[n] - c.a1 * output + r2;
+        r2 = c.b2 * period[n] - c.a2 * output;
+    }
+
+    // A^N by repeated squaring
+    double power[2][2] = { { 1.0, 0.0 }, { 0.0, 1.0 } };
+    double square[2][2] = { { -c.a1, 1.0 }, { -c.a2, 0.0 } };
+    for (int n = numSamples; n > 0; n >>= 1)
+    {
+        double next[2][2];
+        if (n & 1)
+        {
+            for (int i = 0; i < 2; ++i)
+                for (int j = 0; j < 2; ++j)
+                    next[i][j] = power[i][0] * square[0][j] + power[i][1] * square[1][j];
+            std::copy(&next[0][0], &next[0][0] + 4, &power[0][0]);
+        }
+        for (int i = 0; i < 2; ++i)
+            for (int j = 0; j < 2; ++j)
+                next[i][j] = square[i][0] * square[0][j] + square[i][1] * square[1][j];
+        std::copy(&next[0][0], &next[0][0] + 4, &square[0][0]);
+    }
+
+    // Solve (I - A^N) s = r; a pole on the unit circle has no steady state
+    const double m00 = 1.0 - power[0][0], m01 = -power[0][1];
+    const double m10 = -power[1][0], m11 = 1.0 - power[1][1];
+    const double det = m00 * m11 - m01 * m10;
+
+    double s1 = 0.0, s2 = 0.0;
+    if (std::abs(det) > 1e-15)
+    {
+        s1 = (m11 * r1 - m01 * r2) / det;
+        s2 = (m00 * r2 - m10 * r1) / det;
+    }
+
+    z1 = s1;
+    z2 = s2;
+    for (int n = 0; n < numSamples; ++n)
+    {
+        const double input = period[n];
+        const double output = c.b0 * input + s1;
+        s1 = c.b1 * input - c.a1 * output + s2;
+        s2 = c.b2 * input - c.a2 * output;
+        period[n] = output;
+    }
+}
+
+} // namespace TapeHysteresis
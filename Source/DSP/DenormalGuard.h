@@ -0,0 +1,91 @@
+#pragma once
+
+#include <cstdint>
+
+#if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+ #include <xmmintrin.h>
+ #define TAPEHYSTERESIS_DENORMALS_SSE 1
+#elif defined(__aarch64__) || (defined(__arm__) && defined(__ARM_FP))
+ #define TAPEHYSTERESIS_DENORMALS_ARM 1
+#endif
+
+namespace TapeHysteresis
+{
+
+// DenormalGuard - Flush-to-zero for the current thread, restored on exit
+//
+// Recursive filters (5Hz DC blocker, LF bells, the level envelope) decay into
+// denormals on silence, which costs 3-100x per operation on most CPUs. The
+// block-processing entry points of the core hold one of these so the core no
+// longer relies on the host (or JUCE's ScopedNoDenormals) to set FTZ:
+//   x86 (SSE):  MXCSR FTZ (bit 15) + DAZ (bit 6)
+//   ARM:        FPCR / FPSCR FZ (bit 24)
+//   other:      no-op
+//
+// The FP environment is per thread - worker threads need their own guard.
+// Cost is two control-register writes, so hold it per block, not per sample.
+class DenormalGuard
+{
+public:
+    DenormalGuard()
+    {
+#if defined(TAPEHYSTERESIS_DENORMALS_SSE)
+        saved = _mm_getcsr();
+        _mm_setcsr(static_cast<unsigned int>(saved) | 0x8040u);
+#elif defined(TAPEHYSTERESIS_DENORMALS_ARM)
+        saved = readControl();
+        writeControl(saved | (uint64_t(1) << 24));
+#endif
+    }
+
+    ~DenormalGuard()
+    {
+#if defined(TAPEHYSTERESIS_DENORMALS_SSE)
+        _mm_setcsr(static_cast<unsigned int>(saved));
+#elif defined(TAPEHYSTERESIS_DENORMALS_ARM)
+        writeControl(saved);
+#endif
+    }
+
+    DenormalGuard(const DenormalGuard&) = delete;
+    DenormalGuard& operator=(const DenormalGuard&) = delete;
+
+    // True when this platform actually flushes (otherwise the guard is a no-op)
+    static constexpr bool isSupported()
+    {
+#if defined(TAPEHYSTERESIS_DENORMALS_SSE) || defined(TAPEHYSTERESIS_DENORMALS_ARM)
+        return true;
+#else
+        return false;
+#endif
+    }
+
+private:
+    uint64_t saved = 0;
+
+#if defined(TAPEHYSTERESIS_DENORMALS_ARM)
+    static uint64_t readControl()
+    {
+ #if defined(__aarch64__)
+        uint64_t value;
+        asm volatile("mrs %0, fpcr" : "=r"(value));
+        return value;
+ #else
+        uint32_t value;
+        asm volatile("vmrs %0, fpscr" : "=r"(value));
+        return value;
+ #endif
+    }
+
+    static void writeControl(uint64_t value)
+    {
+ #if defined(__aarch64__)
+        asm volatile("msr fpcr, %0" : : "r"(value));
+ #else
+        asm volatile("vmsr fpscr, %0" : : "r"(static_cast<uint32_t>(value)));
+ #endif
+    }
+#endif
+};
+
+} // namespace TapeHysteresis
@@ -0,0 +1,128 @@
+#pragma once
+
+#include <cmath>
+
+namespace TapeHysteresis
+{
+
+/**
+ * Dual - forward-mode automatic differentiation
+ *
+ * A value carrying its partial derivatives with respect to N variables.
+ * Expressions templated on the scalar type (the core's nonlinearities, the
+ * harmonic-balance residuals) evaluated on Dual<N> return exact derivatives
+ * alongside the value. Comparisons look at the value only, so branches take
+ * the same side as the plain double evaluation.
+ */
+template <int N>
+struct Dual
+{
+    double value = 0.0;
+    double d[N] = {};
+
+    Dual() = default;
+    Dual(double v) : value(v) {}        // Constant: all partials zero
+
+    // Independent variable `index`: d/d(variable index) = 1
+    static Dual variable(double v, int index)
+    {
+        Dual x(v);
+        x.d[index] = 1.0;
+        return x;
+    }
+
+    Dual operator-() const
+    {
+        Dual r;
+        r.value = -value;
+        for (int i = 0; i < N; ++i)
+            r.d[i] = -d[i];
+        return r;
+    }
+
+    Dual& operator+=(const Dual& b) { return *this = *this + b; }
+    Dual& operator-=(const Dual& b) { return *this = *this - b; }
+    Dual& operator*=(const Dual& b) { return *this = *this * b; }
+    Dual& operator/=(const Dual& b) { return *this = *this / b; }
+
+    // Value with partials scaled by f'(value): the chain rule for f(x)
+    Dual chain(double f, double fPrime) const
+    {
+        Dual r;
+        r.value = f;
+        for (int i = 0; i < N; ++i)
+            r.d[i] = fPrime * d[i];
+        return r;
+    }
+
+    friend Dual operator+(const Dual& a, const Dual& b)
+    {
+        Dual r;
+        r.value = a.value + b.value;
+        for (int i = 0; i < N; ++i)
+            r.d[i] = a.d[i] + b.d[i];
+        return r;
+    }
+
+    friend Dual operator-(const Dual& a, const Dual& b)
+    {
+        Dual r;
+        r.value = a.value - b.value;
+        for (int i = 0; i < N; ++i)
+            r.d[i] = a.d[i] - b.d[i];
+        return r;
+    }
+
+    friend Dual operator*(const Dual& a, const Dual& b)
+    {
+        Dual r;
+        r.value = a.value * b.value;
+        for (int i = 0; i < N; ++i)
+            r.d[i] = a.d[i] * b.value + a.value * b.d[i];
+        return r;
+    }
+
+    friend Dual operator/(const Dual& a, const Dual& b)
+    {
+        Dual r;
+        r.value = a.value / b.value;
+        const double inverse = 1.0 / b.value;
+        for (int i = 0; i < N; ++i)
+            r.d[i] = (a.d[i] - r.value * b.d[i]) * inverse;
+        return r;
+    }
+
+    friend Dual operator+(const Dual& a, double b) { return a + Dual(b); }
+    friend Dual operator+(double a, const Dual& b) { return Dual(a) + b; }
+    friend Dual operator-(const Dual& a, double b) { return a - Dual(b); }
+    friend Dual operator-(double a, const Dual& b) { return Dual(a) - b; }
+    friend Dual operator*(const Dual& a, double b) { return a.chain(a.value * b, b); }
+    friend Dual operator*(double a, const Dual& b) { return b.chain(a * b.value, a); }
+    friend Dual operator/(const Dual& a, double b) { return a.chain(a.value / b, 1.0 / b); }
+    friend Dual operator/(double a, const Dual& b) { return Dual(a) / b; }
+
+    friend bool operator<(const Dual& a, const Dual& b) { return a.value < b.value; }
+    friend bool operator>(const Dual& a, const Dual& b) { return a.value > b.value; }
+    friend bool operator<=(const Dual& a, const Dual& b) { return a.value <= b.value; }
+    friend bool operator>=(const Dual& a, const Dual& b) { return a.value >= b.value; }
+
+    friend Dual abs(const Dual& x) { return x.chain(std::abs(x.value), x.value < 0.0 ? -1.0 : 1.0); }
+    friend Dual atan(const Dual& x) { return x.chain(std::atan(x.value), 1.0 / (1.0 + x.value * x.value)); }
+    friend Dual sqrt(const Dual& x)
+    {
+        const double root = std::sqrt(x.value);
+        return x.chain(root, 0.5 / root);
+    }
+    friend Dual tanh(const Dual& x)
+    {
+        const double t = std::tanh(x.value);
+        return x.chain(t, 1.0 - t * t);
+    }
+};
+
+// Plain value of a scalar, for branches and reporting
+inline double valueOf(double x) { return x; }
+template <int N>
+double valueOf(const Dual<N>& x) { return x.value; }
+
+} // namespace TapeHysteresis
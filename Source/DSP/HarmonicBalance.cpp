@@ -0,0 +1,705 @@
+#include "HarmonicBalance.h"
+#include "Dual.h"
+#include <algorithm>
+#include <complex>
+#include <functional>
+#include <vector>
+
+namespace TapeHysteresis
+{
+
+namespace
+{
+
+using Complex = std::complex<double>;
+using Real = Dual<HarmonicBalance::NUM_PARAMETERS>;     // Value + d/d(calibration parameters)
+constexpr int NUM_PARAMETERS = HarmonicBalance::NUM_PARAMETERS;
+
+// Frequency response of a DF2T biquad, omega in radians per sample
+Complex response(const BiquadCoefficients& c, double omega)
+{
+    const Complex z1 = std::polar(1.0, -omega);
+    const Complex z2 = z1 * z1;
+    return (c.b0 + c.b1 * z1 + c.b2 * z2) / (1.0 + c.a1 * z1 + c.a2 * z2);
+}
+
+// Real Fourier basis on the grid, at t and one sample earlier (t - T).
+// Coefficient 0 is DC, 2k - 1 / 2k the cosine / sine of harmonic k.
+struct Basis
+{
+    int numHarmonics = 0;
+    int gridSize = 0;
+    int size = 0;
+    std::vector<double> now, delayed;    // gridSize x size
+    std::vector<double> weight;          // Grid sum -> coefficient (projection)
+
+    Basis(int harmonics, int points, double omega)
+        : numHarmonics(harmonics), gridSize(points), size(2 * harmonics + 1),
+          now(static_cast<size_t>(points * size)), delayed(static_cast<size_t>(points * size)),
+          weight(static_cast<size_t>(size), 2.0 / points)
+    {
+        weight[0] = 1.0 / points;
+
+        for (int p = 0; p < gridSize; ++p)
+        {
+            double* row = now.data() + p * size;
+            double* delayedRow = delayed.data() + p * size;
+            row[0] = delayedRow[0] = 1.0;
+
+            for (int k = 1; k <= numHarmonics; ++k)
+            {
+                const double theta = 2.0 * M_PI * k * p / gridSize;
+                row[2 * k - 1] = std::cos(theta);
+                row[2 * k] = std::sin(theta);
+                delayedRow[2 * k - 1] = std::cos(theta - k * omega);
+                delayedRow[2 * k] = std::sin(theta - k * omega);
+            }
+        }
+    }
+
+    // s(t_p) and s(t_p - T) on the grid
+    void evaluate(const double* x, double* values, double* delayedValues) const
+    {
+        for (int p = 0; p < gridSize; ++p)
+        {
+            const double* row = now.data() + p * size;
+            const double* delayedRow = delayed.data() + p * size;
+            double value = 0.0, delayedValue = 0.0;
+            for (int j = 0; j < size; ++j)
+            {
+                value += row[j] * x[j];
+                delayedValue += delayedRow[j] * x[j];
+            }
+            values[p] = value;
+            delayedValues[p] = delayedValue;
+        }
+    }
+
+    void project(const double* values, double* x) const
+    {
+        for (int j = 0; j < size; ++j)
+        {
+            double sum = 0.0;
+            for (int p = 0; p < gridSize; ++p)
+                sum += now[p * size + j] * values[p];
+            x[j] = weight[j] * sum;
+        }
+    }
+
+    // Harmonic k of a coefficient vector as a phasor: a cos + b sin = Re(C e^(j theta))
+    Complex phasor(const double* x, int k) const
+    {
+        return (k == 0) ? Complex(x[0], 0.0) : Complex(x[2 * k - 1], -x[2 * k]);
+    }
+};
+
+// Residual of numStates recurrences at grid point p: r(s(t), s(t - T)),
+// with its derivatives (numStates x numStates, row-major)
+using PointResidual = std::function<void(int p, const double* s, const double* sDelayed,
+                                         double* r, double* dS, double* dSDelayed)>;
+
+// Gaussian elimination with partial pivoting, a: n x n row-major,
+// b: n x numColumns right-hand sides (row-major), replaced by the solution
+bool solveLinear(std::vector<double>& a, std::vector<double>& b, int n, int numColumns = 1)
+{
+    for (int col = 0; col < n; ++col)
+    {
+        int pivot = col;
+        for (int row = col + 1; row < n; ++row)
+            if (std::abs(a[row * n + col]) > std::abs(a[pivot * n + col]))
+                pivot = row;
+
+        if (std::abs(a[pivot * n + col]) < 1e-300)
+            return false;
+
+        if (pivot != col)
+        {
+            for (int j = 0; j < n; ++j)
+                std::swap(a[col * n + j], a[pivot * n + j]);
+            for (int m = 0; m < numColumns; ++m)
+                std::swap(b[col * numColumns + m], b[pivot * numColumns + m]);
+        }
+
+        for (int row = col + 1; row < n; ++row)
+        {
+            const double factor = a[row * n + col] / a[col * n + col];
+            if (factor == 0.0)
+                continue;
+            for (int j = col; j < n; ++j)
+                a[row * n + j] -= factor * a[col * n + j];
+            for (int m = 0; m < numColumns; ++m)
+                b[row * numColumns + m] -= factor * b[col * numColumns + m];
+        }
+    }
+
+    for (int row = n - 1; row >= 0; --row)
+    {
+        for (int m = 0; m < numColumns; ++m)
+        {
+            double sum = b[row * numColumns + m];
+            for (int j = row + 1; j < n; ++j)
+                sum -= a[row * n + j] * b[j * numColumns + m];
+            b[row * numColumns + m] = sum / a[row * n + row];
+        }
+    }
+    return true;
+}
+
+// Projected residual of numStates recurrences at coefficients c (x:
+// state-major), and its Jacobian (n x n) when given; returns |R|
+double assemble(const Basis& basis, int numStates, const PointResidual& residual,
+                const std::vector<double>& c, std::vector<double>& out, std::vector<double>* jacobian)
+{
+    const int size = basis.size;
+    const int gridSize = basis.gridSize;
+    const int n = numStates * size;
+
+    std::vector<double> values(static_cast<size_t>(numStates * gridSize));
+    std::vector<double> delayedValues(values.size());
+    std::vector<double> r(static_cast<size_t>(numStates)), dS(static_cast<size_t>(numStates * numStates));
+    std::vector<double> dSDelayed(dS.size()), s(r.size()), sDelayed(r.size());
+
+    for (int q = 0; q < numStates; ++q)
+        basis.evaluate(c.data() + q * size, values.data() + q * gridSize, delayedValues.data() + q * gridSize);
+
+    std::fill(out.begin(), out.end(), 0.0);
+    if (jacobian != nullptr)
+        std::fill(jacobian->begin(), jacobian->end(), 0.0);
+
+    for (int p = 0; p < gridSize; ++p)
+    {
+        for (int q = 0; q < numStates; ++q)
+        {
+            s[q] = values[q * gridSize + p];
+            sDelayed[q] = delayedValues[q * gridSize + p];
+        }
+        residual(p, s.data(), sDelayed.data(), r.data(), dS.data(), dSDelayed.data());
+
+        const double* row = basis.now.data() + p * size;
+        const double* delayedRow = basis.delayed.data() + p * size;
+
+        for (int i = 0; i < numStates; ++i)
+        {
+            for (int j = 0; j < size; ++j)
+            {
+                const double w = basis.weight[j] * row[j];
+                out[i * size + j] += w * r[i];
+
+                if (jacobian == nullptr)
+                    continue;
+
+                double* jRow = jacobian->data() + static_cast<size_t>(i * size + j) * n;
+                for (int q = 0; q < numStates; ++q)
+                {
+                    const double a = w * dS[i * numStates + q];
+                    const double b = w * dSDelayed[i * numStates + q];
+                    double* jBlock = jRow + q * size;
+                    for (int l = 0; l < size; ++l)
+                        jBlock[l] += a * row[l] + b * delayedRow[l];
+                }
+            }
+        }
+    }
+
+    double norm = 0.0;
+    for (double v : out)
+        norm += v * v;
+    return std::sqrt(norm);
+}
+
+// Newton on the Fourier coefficients of numStates states (x: state-major)
+// until the step is below tolerance. Backtracks, as the residuals are only
+// piecewise smooth (envelope attack / release, J-A field direction).
+// Returns the iterations used, or -1 without convergence.
+int solveStates(const Basis& basis, int numStates, const PointResidual& residual,
+                std::vector<double>& x, const HarmonicBalance::Options& options)
+{
+    const int n = numStates * basis.size;
+
+    std::vector<double> R(static_cast<size_t>(n)), J(static_cast<size_t>(n * n));
+    std::vector<double> trial(x.size()), trialR(R.size());
+
+    for (int iteration = 1; iteration <= options.maxIterations; ++iteration)
+    {
+        const double norm = assemble(basis, numStates, residual, x, R, &J);
+
+        std::vector<double> step(R.size());
+        for (int i = 0; i < n; ++i)
+            step[i] = -R[i];
+        if (!solveLinear(J, step, n))
+            return -1;
+
+        double scale = 1.0, trialNorm = 0.0;
+        for (int attempt = 0; attempt < 12; ++attempt)
+        {
+            for (int i = 0; i < n; ++i)
+                trial[i] = x[i] + scale * step[i];
+            trialNorm = assemble(basis, numStates, residual, trial, trialR, nullptr);
+            if (trialNorm <= norm)
+                break;
+            scale *= 0.5;
+        }
+
+        double stepSize = 0.0, size2 = 0.0;
+        for (int i = 0; i < n; ++i)
+        {
+            stepSize += (trial[i] - x[i]) * (trial[i] - x[i]);
+            size2 += trial[i] * trial[i];
+        }
+        x = trial;
+
+        if (std::sqrt(stepSize) <= options.tolerance * std::max(std::sqrt(size2), 1e-30) || trialNorm == 0.0)
+            return iteration;
+    }
+
+    return -1;
+}
+
+// Parameter sensitivity of converged coefficients x (implicit function
+// theorem): J dx/dp = -dR/dp. dR/dp is projected from the point residuals
+// evaluated on dual numbers at the solution (pointResiduals: gridSize x
+// numStates). dx: n x NUM_PARAMETERS, row-major.
+bool sensitivity(const Basis& basis, int numStates, const PointResidual& residual, const std::vector<double>& x,
+                 const std::vector<Real>& pointResiduals, std::vector<double>& dx)
+{
+    const int size = basis.size;
+    const int n = numStates * size;
+
+    std::vector<double> R(static_cast<size_t>(n)), J(static_cast<size_t>(n * n));
+    assemble(basis, numStates, residual, x, R, &J);
+
+    dx.assign(static_cast<size_t>(n * NUM_PARAMETERS), 0.0);
+    for (int p = 0; p < basis.gridSize; ++p)
+    {
+        const double* row = basis.now.data() + p * size;
+        for (int i = 0; i < numStates; ++i)
+        {
+            const Real& r = pointResiduals[p * numStates + i];
+            for (int j = 0; j < size; ++j)
+            {
+                const double w = basis.weight[j] * row[j];
+                double* out = dx.data() + static_cast<size_t>(i * size + j) * NUM_PARAMETERS;
+                for (int m = 0; m < NUM_PARAMETERS; ++m)
+                    out[m] -= w * r.d[m];
+            }
+        }
+    }
+
+    return solveLinear(J, dx, n, NUM_PARAMETERS);
+}
+
+// One state on the grid at t and t - T, with its parameter partials
+// (coefficients x, sensitivities dx: size x NUM_PARAMETERS)
+void evaluate(const Basis& basis, const double* x, const double* dx, Real* values, Real* delayedValues)
+{
+    for (int p = 0; p < basis.gridSize; ++p)
+    {
+        const double* row = basis.now.data() + p * basis.size;
+        const double* delayedRow = basis.delayed.data() + p * basis.size;
+        Real value, delayedValue;
+        for (int j = 0; j < basis.size; ++j)
+        {
+            value.value += row[j] * x[j];
+            delayedValue.value += delayedRow[j] * x[j];
+            for (int m = 0; m < NUM_PARAMETERS; ++m)
+            {
+                value.d[m] += row[j] * dx[j * NUM_PARAMETERS + m];
+                delayedValue.d[m] += delayedRow[j] * dx[j * NUM_PARAMETERS + m];
+            }
+        }
+        values[p] = value;
+        delayedValues[p] = delayedValue;
+    }
+}
+
+// === The core's per-sample expressions, templated on the scalar ===
+// Scalar = double solves; Scalar = Real differentiates at the solution.
+// parameters: indexed by HarmonicBalance::Parameter.
+
+// J-A field from the HFCut output
+template <typename Scalar>
+Scalar jaField(const Scalar* parameters, double hfCut)
+{
+    return (hfCut + parameters[HarmonicBalance::InputBias]) * parameters[HarmonicBalance::JaInputScale];
+}
+
+// NR8's residual, with T dM/dH H_d written as dM/dH (H - H')
+template <typename Scalar>
+Scalar jaResidual(const Scalar* parameters, const Scalar& M, const Scalar& Mprev, const Scalar& H, const Scalar& Hprev)
+{
+    const auto constants = JilesAthertonCore::makeConstants(parameters[HarmonicBalance::JaSaturation],
+                                                            parameters[HarmonicBalance::JaDomainDensity],
+                                                            parameters[HarmonicBalance::JaCoercivity],
+                                                            parameters[HarmonicBalance::JaReversibility],
+                                                            parameters[HarmonicBalance::JaMeanField]);
+    const double delta = (H - Hprev >= 0.0) ? 1.0 : -1.0;
+    return M - Mprev - JilesAthertonCore::slope(constants, H, M, delta).dM_dH * (H - Hprev);
+}
+
+// Blends, atan and the clean HF path (memoryless)
+template <typename Scalar>
+Scalar saturate(const Scalar* parameters, double envelope, double gained, double hfCut,
+                const Scalar& magnetization, double cleanHfBlend)
+{
+    const Scalar jaBlend = HybridTapeProcessor::levelBlend(parameters[HarmonicBalance::JaBlendMax],
+                                                           parameters[HarmonicBalance::JaBlendThreshold],
+                                                           parameters[HarmonicBalance::JaBlendWidth], envelope);
+    const Scalar atanBlend = HybridTapeProcessor::levelBlend(parameters[HarmonicBalance::AtanMix],
+                                                             parameters[HarmonicBalance::AtanThreshold],
+                                                             parameters[HarmonicBalance::AtanWidth], envelope);
+    const Scalar biased = hfCut + parameters[HarmonicBalance::InputBias];
+    const Scalar atanOut = HybridTapeProcessor::atanCurve(parameters[HarmonicBalance::AtanDrive], biased);
+    const Scalar jaPath = magnetization * parameters[HarmonicBalance::JaOutputScale];
+    const Scalar saturatedPath = HybridTapeProcessor::mixLayers(Scalar(hfCut), jaPath, atanOut, jaBlend, atanBlend);
+    return saturatedPath + (gained - hfCut) * cleanHfBlend;
+}
+
+// Self-erasure DF2T states z1, z2 at one point
+template <typename Scalar>
+void erasureResidual(const BiquadCoefficients& c, const Scalar& x, const Scalar* s, const Scalar* sDelayed, Scalar* r)
+{
+    const Scalar y = c.b0 * x + sDelayed[0];
+    r[0] = s[0] - (c.b1 * x - c.a1 * y + sDelayed[1]);
+    r[1] = s[1] - (c.b2 * x - c.a2 * y);
+}
+
+} // namespace
+
+double HarmonicBalance::Result::thdPercent(int highestHarmonic) const
+{
+    double sum = 0.0;
+    for (int k = 2; k <= std::min(highestHarmonic, NUM_REPORTED); ++k)
+        sum += amplitude[k] * amplitude[k];
+    return (amplitude[1] > 0.0) ? 100.0 * std::sqrt(sum) / amplitude[1] : 0.0;
+}
+
+double HarmonicBalance::Gradient::thdPercent(const Result& result, int parameter, int highestHarmonic) const
+{
+    // thd = 100 sqrt(S) / H1, S = H2^2 + ... + Hn^2
+    double sum = 0.0, dSum = 0.0;
+    for (int k = 2; k <= std::min(highestHarmonic, NUM_REPORTED); ++k)
+    {
+        sum += result.amplitude[k] * result.amplitude[k];
+        dSum += 2.0 * result.amplitude[k] * amplitude[parameter][k];
+    }
+    if (result.amplitude[1] <= 0.0 || sum <= 0.0)
+        return 0.0;
+
+    const double root = std::sqrt(sum);
+    return 100.0 * (0.5 * dSum / root - root * amplitude[parameter][1] / result.amplitude[1]) / result.amplitude[1];
+}
+
+const char* HarmonicBalance::getParameterName(int parameter)
+{
+    static const char* const names[NUM_PARAMETERS] = {
+        "ja.M_s", "ja.a", "ja.k", "ja.c", "ja.alpha", "jaInputScale", "jaOutputScale",
+        "jaBlendMax", "jaBlendThreshold", "jaBlendWidth",
+        "atanMix", "atanThreshold", "atanWidth", "atanDrive", "inputBias"
+    };
+    return (parameter >= 0 && parameter < NUM_PARAMETERS) ? names[parameter] : "";
+}
+
+double& HarmonicBalance::getParameter(MachineProfile& profile, int parameter)
+{
+    switch (parameter)
+    {
+        case JaSaturation:       return profile.ja.M_s;
+        case JaDomainDensity:    return profile.ja.a;
+        case JaCoercivity:       return profile.ja.k;
+        case JaReversibility:    return profile.ja.c;
+        case JaMeanField:        return profile.ja.alpha;
+        case JaInputScale:       return profile.jaInputScale;
+        case JaOutputScale:      return profile.jaOutputScale;
+        case JaBlendMax:         return profile.jaBlendMax;
+        case JaBlendThreshold:   return profile.jaBlendThreshold;
+        case JaBlendWidth:       return profile.jaBlendWidth;
+        case AtanMix:            return profile.atanMix;
+        case AtanThreshold:      return profile.atanThreshold;
+        case AtanWidth:          return profile.atanWidth;
+        case AtanDrive:          return profile.atanDrive;
+        default:                 return profile.inputBias;
+    }
+}
+
+HarmonicBalance::Result HarmonicBalance::solve(const HybridTapeProcessor& processor, double frequency, double amplitude)
+{
+    return balance(processor, frequency, amplitude, Options(), nullptr);
+}
+
+HarmonicBalance::Result HarmonicBalance::solve(const HybridTapeProcessor& processor, double frequency, double amplitude,
+                                               const Options& options)
+{
+    return balance(processor, frequency, amplitude, options, nullptr);
+}
+
+HarmonicBalance::Result HarmonicBalance::solve(const HybridTapeProcessor& processor, double frequency, double amplitude,
+                                               const Options& options, Gradient& gradient)
+{
+    return balance(processor, frequency, amplitude, options, &gradient);
+}
+
+HarmonicBalance::Result HarmonicBalance::balance(const HybridTapeProcessor& processor, double frequency,
+                                                 double amplitude, const Options& options, Gradient* gradient)
+{
+    Result result;
+
+    const int numHarmonics = std::max(options.numHarmonics, NUM_REPORTED);
+    const int gridSize = std::max(options.gridSize, 2 * numHarmonics + 2);
+    const double omega = 2.0 * M_PI * frequency / processor.fs;     // Radians per sample
+    const Basis basis(numHarmonics, gridSize, omega);
+    const CompiledProfile& profile = *processor.activeProfile;
+
+    // The calibration parameters as the core holds them
+    const JilesAthertonCore::Parameters& jaParams = processor.jaCore.params;
+    const double values[NUM_PARAMETERS] = {
+        jaParams.M_s, jaParams.a, jaParams.k, jaParams.c, jaParams.alpha,
+        processor.jaInputScale, processor.jaOutputScale,
+        processor.jaBlendMax, processor.jaBlendThreshold, processor.jaBlendWidth,
+        processor.atanMix, processor.atanThreshold, processor.atanWidth, processor.atanDrive,
+        processor.inputBias
+    };
+
+    // Input, and HFCut's (sinusoidal) output, on the grid at t and t - T
+    const double peak = amplitude * processor.currentInputGain;
+    const Complex hfCutGain = response(profile.hfCut.shelves[0], omega) * response(profile.hfCut.shelves[1], omega);
+
+    std::vector<double> gained(gridSize), hfCut(gridSize), hfCutDelayed(gridSize);
+    for (int p = 0; p < gridSize; ++p)
+    {
+        const double theta = 2.0 * M_PI * p / gridSize;
+        gained[p] = peak * std::sin(theta);
+        hfCut[p] = peak * std::abs(hfCutGain) * std::sin(theta + std::arg(hfCutGain));
+        hfCutDelayed[p] = peak * std::abs(hfCutGain) * std::sin(theta - omega + std::arg(hfCutGain));
+    }
+
+    // === 1. Envelope: e = e' + step(|g| > e') (|g| - e') ===
+    // (independent of the calibration parameters)
+    const double attack = processor.envelopeAttack;
+    const double release = processor.envelopeRelease;
+
+    // Start from the constant level where attack and release balance
+    double low = 0.0, high = peak;
+    for (int i = 0; i < 60; ++i)
+    {
+        const double level = 0.5 * (low + high);
+        double drift = 0.0;
+        for (double g : gained)
+            drift += (std::abs(g) > level ? attack : release) * (std::abs(g) - level);
+        (drift > 0.0 ? low : high) = level;
+    }
+
+    std::vector<double> envelopeCoefficients(static_cast<size_t>(basis.size), 0.0);
+    envelopeCoefficients[0] = 0.5 * (low + high);
+
+    const int envelopeIterations = solveStates(basis, 1,
+        [&](int p, const double* s, const double* sDelayed, double* r, double* dS, double* dSDelayed)
+        {
+            double next = sDelayed[0];
+            HybridTapeProcessor::followEnvelope(next, gained[p], attack, release);
+            r[0] = s[0] - next;
+            dS[0] = 1.0;
+            dSDelayed[0] = -1.0 + ((std::abs(gained[p]) > sDelayed[0]) ? attack : release);
+        },
+        envelopeCoefficients, options);
+
+    std::vector<double> envelope(gridSize), unused(gridSize);
+    basis.evaluate(envelopeCoefficients.data(), envelope.data(), unused.data());
+
+    // === 2. J-A magnetization: M = M' + dM/dH(M, direction) (H - H') ===
+    // Start from the bias operating point; if Newton misses, walk the AC
+    // field up in steps, each starting from the last solution
+    JilesAthertonCore restPoint = processor.jaCore;
+    restPoint.settleAt(processor.inputBias * processor.jaInputScale);
+    const double restM = restPoint.getM();
+
+    std::vector<double> jaCoefficients(static_cast<size_t>(basis.size), 0.0);
+    std::vector<double> field(gridSize), fieldDelayed(gridSize);
+    int jaIterations = -1;
+    int totalJaIterations = 0;
+
+    const PointResidual jaPointResidual =
+        [&](int p, const double* s, const double* sDelayed, double* r, double* dS, double* dSDelayed)
+        {
+            const double h = 1e-7 * std::max(std::abs(s[0]), 1e-3 * jaParams.M_s);
+            r[0] = jaResidual(values, s[0], sDelayed[0], field[p], fieldDelayed[p]);
+            dS[0] = (jaResidual(values, s[0] + h, sDelayed[0], field[p], fieldDelayed[p])
+                   - jaResidual(values, s[0] - h, sDelayed[0], field[p], fieldDelayed[p])) / (2.0 * h);
+            dSDelayed[0] = -1.0;
+        };
+
+    for (int numSteps = 1; numSteps <= 16 && jaIterations < 0; numSteps *= 4)
+    {
+        std::fill(jaCoefficients.begin(), jaCoefficients.end(), 0.0);
+        jaCoefficients[0] = restM;
+
+        for (int stepIndex = 1; stepIndex <= numSteps; ++stepIndex)
+        {
+            const double fraction = static_cast<double>(stepIndex) / numSteps;
+            for (int p = 0; p < gridSize; ++p)
+            {
+                field[p] = jaField(values, fraction * hfCut[p]);
+                fieldDelayed[p] = jaField(values, fraction * hfCutDelayed[p]);
+            }
+
+            jaIterations = solveStates(basis, 1, jaPointResidual, jaCoefficients, options);
+
+            if (jaIterations < 0)
+                break;
+            totalJaIterations += jaIterations;
+        }
+    }
+
+    std::vector<double> magnetization(gridSize);
+    basis.evaluate(jaCoefficients.data(), magnetization.data(), unused.data());
+
+    // === Memoryless part: blends, atan, clean HF path ===
+    std::vector<double> preErasure(gridSize);
+    for (int p = 0; p < gridSize; ++p)
+        preErasure[p] = saturate(values, envelope[p], gained[p], hfCut[p], magnetization[p], processor.cleanHfBlend);
+
+    // === 3. Self-erasure: DF2T shelf, coefficients interpolated per envelope ===
+    const SelfErasureTable& table = profile.selfErasure;
+    std::vector<BiquadCoefficients> shelf(gridSize);
+    bool anyActive = false;
+
+    for (int p = 0; p < gridSize; ++p)
+    {
+        const double control = table.control(envelope[p]);
+        anyActive = anyActive || control > 0.0;
+        shelf[p] = (control > 0.0) ? table.shelfAt(control) : table.shelves[0];
+    }
+
+    // States z1, z2; where the shelf is flat the state decays through it
+    // (SelfErasureTable::process). Never engaged, the state stays at rest.
+    const PointResidual erasurePointResidual =
+        [&](int p, const double* s, const double* sDelayed, double* r, double* dS, double* dSDelayed)
+        {
+            dS[0] = 1.0; dS[1] = 0.0; dS[2] = 0.0; dS[3] = 1.0;
+
+            const BiquadCoefficients& c = shelf[p];
+            erasureResidual(c, preErasure[p], s, sDelayed, r);
+            dSDelayed[0] = c.a1; dSDelayed[1] = -1.0;
+            dSDelayed[2] = c.a2; dSDelayed[3] = 0.0;
+        };
+
+    std::vector<double> output = preErasure;
+    std::vector<double> erasureCoefficients(static_cast<size_t>(2 * basis.size), 0.0);
+    int erasureIterations = 0;
+
+    if (anyActive)
+    {
+        erasureIterations = solveStates(basis, 2, erasurePointResidual, erasureCoefficients, options);
+
+        std::vector<double> z1(gridSize), z1Delayed(gridSize);
+        basis.evaluate(erasureCoefficients.data(), z1.data(), z1Delayed.data());
+        for (int p = 0; p < gridSize; ++p)
+            output[p] = shelf[p].b0 * preErasure[p] + z1Delayed[p];
+    }
+
+    // === Linear tail as transfer functions: machine EQ, allpasses, DC blockers ===
+    Complex tail[NUM_REPORTED + 1];
+    for (int k = 0; k <= NUM_REPORTED; ++k)
+    {
+        const double w = k * omega;
+        Complex gain(1.0, 0.0);
+        for (int i = 0; i < profile.eq.numStages; ++i)
+            gain *= response(profile.eq.stages[i], w);
+        for (int i = 0; i < CompiledProfile::NUM_DISPERSIVE_STAGES; ++i)
+        {
+            const double c = processor.dispersiveAllpass[i].coefficient;
+            gain *= response({ c, 1.0, 0.0, c, 0.0 }, w);
+        }
+        for (const auto* dcBlocker : { &processor.dcBlocker1, &processor.dcBlocker2 })
+            gain *= response({ dcBlocker->b0, dcBlocker->b1, dcBlocker->b2, dcBlocker->a1, dcBlocker->a2 }, w);
+        tail[k] = gain;
+    }
+
+    std::vector<double> outputCoefficients(static_cast<size_t>(basis.size));
+    basis.project(output.data(), outputCoefficients.data());
+
+    Complex harmonics[NUM_REPORTED + 1];
+    for (int k = 0; k <= NUM_REPORTED; ++k)
+    {
+        harmonics[k] = basis.phasor(outputCoefficients.data(), k) * tail[k];
+        result.amplitude[k] = std::abs(harmonics[k]);
+        result.phase[k] = std::arg(harmonics[k]) + 0.5 * M_PI;
+    }
+
+    result.converged = envelopeIterations >= 0 && jaIterations >= 0 && erasureIterations >= 0;
+    result.iterations = std::max(envelopeIterations, 0) + totalJaIterations + std::max(erasureIterations, 0);
+
+    if (gradient == nullptr || !result.converged)
+        return result;
+
+    // === Gradient: each state's sensitivity at the solution, in order ===
+    Real seeded[NUM_PARAMETERS];
+    for (int m = 0; m < NUM_PARAMETERS; ++m)
+        seeded[m] = Real::variable(values[m], m);
+
+    // J-A: the residual's direct dependence on the J-A constants and the field
+    std::vector<Real> magnetizationReal(gridSize), magnetizationDelayed(gridSize);
+    std::vector<Real> pointResiduals(static_cast<size_t>(gridSize));
+    std::vector<double> jaSensitivity;
+    {
+        std::vector<double> Mnow(gridSize), Mprev(gridSize);
+        basis.evaluate(jaCoefficients.data(), Mnow.data(), Mprev.data());
+        for (int p = 0; p < gridSize; ++p)
+            pointResiduals[p] = jaResidual<Real>(seeded, Mnow[p], Mprev[p], jaField(seeded, hfCut[p]),
+                                                 jaField(seeded, hfCutDelayed[p]));
+    }
+    if (!sensitivity(basis, 1, jaPointResidual, jaCoefficients, pointResiduals, jaSensitivity))
+        return result;
+    evaluate(basis, jaCoefficients.data(), jaSensitivity.data(), magnetizationReal.data(), magnetizationDelayed.data());
+
+    std::vector<Real> preErasureReal(gridSize);
+    for (int p = 0; p < gridSize; ++p)
+        preErasureReal[p] = saturate(seeded, envelope[p], gained[p], hfCut[p], magnetizationReal[p],
+                                     processor.cleanHfBlend);
+
+    // Self-erasure: driven by the (differentiated) saturation output
+    std::vector<Real> outputReal = preErasureReal;
+    if (anyActive)
+    {
+        std::vector<double> z(static_cast<size_t>(2 * gridSize)), zDelayed(z.size());
+        basis.evaluate(erasureCoefficients.data(), z.data(), zDelayed.data());
+        basis.evaluate(erasureCoefficients.data() + basis.size, z.data() + gridSize, zDelayed.data() + gridSize);
+
+        pointResiduals.assign(static_cast<size_t>(2 * gridSize), Real());
+        for (int p = 0; p < gridSize; ++p)
+        {
+            const Real s[2] = { z[p], z[gridSize + p] };
+            const Real sDelayed[2] = { zDelayed[p], zDelayed[gridSize + p] };
+            erasureResidual(shelf[p], preErasureReal[p], s, sDelayed, &pointResiduals[2 * p]);
+        }
+
+        std::vector<double> erasureSensitivity;
+        if (!sensitivity(basis, 2, erasurePointResidual, erasureCoefficients, pointResiduals, erasureSensitivity))
+            return result;
+
+        std::vector<Real> z1(gridSize), z1Delayed(gridSize);
+        evaluate(basis, erasureCoefficients.data(), erasureSensitivity.data(), z1.data(), z1Delayed.data());
+        for (int p = 0; p < gridSize; ++p)
+            outputReal[p] = shelf[p].b0 * preErasureReal[p] + z1Delayed[p];
+    }
+
+    // Tail: d|H| = Re(conj(H) dH) / |H|
+    std::vector<double> column(gridSize), columnCoefficients(static_cast<size_t>(basis.size));
+    for (int m = 0; m < NUM_PARAMETERS; ++m)
+    {
+        for (int p = 0; p < gridSize; ++p)
+            column[p] = outputReal[p].d[m];
+        basis.project(column.data(), columnCoefficients.data());
+
+        for (int k = 0; k <= NUM_REPORTED; ++k)
+        {
+            const Complex dHarmonic = basis.phasor(columnCoefficients.data(), k) * tail[k];
+            gradient->amplitude[m][k] = (result.amplitude[k] > 0.0)
+                ? std::real(std::conj(harmonics[k]) * dHarmonic) / result.amplitude[k]
+                : 0.0;
+        }
+    }
+
+    return result;
+}
+
+} // namespace TapeHysteresis
@@ -0,0 +1,117 @@
+#pragma once
+
+#include "HybridTapeProcessor.h"
+
+namespace TapeHysteresis
+{
+
+/**
+ * Harmonic Balance - periodic steady state of the core for a sine input
+ *
+ * Solves for the steady state directly instead of simulating until the
+ * start-up transient has gone. The core's states are periodic in steady
+ * state, so each is written as a truncated Fourier series (DC + numHarmonics)
+ * and the coefficients are found by Newton iteration on the projected
+ * residual of the state's recurrence, evaluated on gridSize points per
+ * period (alternating frequency / time). The one-sample delay of every
+ * recurrence is a phase shift per harmonic, so the solution is the
+ * sample-rate core's, not a continuous-time approximation of it.
+ *
+ * The core is feed-forward between its states, so they balance one after
+ * another:
+ *   1. Envelope follower (drives every level-dependent blend)
+ *   2. J-A magnetization, driven by HFCut(input) + bias
+ *   3. Self-erasure shelf (two states, coefficients following the envelope)
+ * The atan and blends are memoryless on the grid; HFCut, machine EQ,
+ * allpasses and DC blockers are LTI and enter as transfer functions at each
+ * harmonic. Being band-limited, the result carries no aliasing - time-domain
+ * renders at the same rate agree to within their aliases.
+ *
+ * Evaluates the processor's current machine, tuning, input gain and rate
+ * (left channel - no azimuth delay), the full path as with the linear fast
+ * path off. The J-A clamp to +/-M_s is not modelled (never reached at
+ * audio levels).
+ *
+ * Gradient: exact derivatives of the harmonics with respect to the
+ * saturation's calibration parameters, for gradient-based calibration.
+ * The residuals and the core's curves are templated on the scalar and
+ * evaluated on dual numbers (Dual.h) at the converged solution; implicit
+ * differentiation (J dx = -dR/dp) then gives each state's sensitivity with
+ * one more linear solve, factored once for all parameters - no re-solves,
+ * no finite differences. Exact for the solved steady state, away from the
+ * measure-zero kinks (attack / release switch, J-A field reversal, blend
+ * ends).
+ */
+class HarmonicBalance
+{
+public:
+    static constexpr int NUM_REPORTED = 9;      // H1-H9
+
+    // Calibration parameters of the gradient: the current machine's
+    // saturation constants (the MachineProfile fields of the same names)
+    enum Parameter
+    {
+        JaSaturation,         // ja.M_s
+        JaDomainDensity,      // ja.a
+        JaCoercivity,         // ja.k
+        JaReversibility,      // ja.c
+        JaMeanField,          // ja.alpha
+        JaInputScale,
+        JaOutputScale,
+        JaBlendMax,
+        JaBlendThreshold,
+        JaBlendWidth,
+        AtanMix,
+        AtanThreshold,
+        AtanWidth,
+        AtanDrive,
+        InputBias,
+        NUM_PARAMETERS
+    };
+
+    static const char* getParameterName(int parameter);
+    static double& getParameter(MachineProfile& profile, int parameter);
+
+    struct Options
+    {
+        int numHarmonics = 24;       // Per state
+        int gridSize = 96;           // Time points per period (> 2 numHarmonics)
+        int maxIterations = 40;      // Newton iterations per state
+        double tolerance = 1e-12;    // Newton step, relative to the state's size
+    };
+
+    struct Result
+    {
+        bool converged = false;
+        int iterations = 0;                        // Newton iterations, all states
+        double amplitude[NUM_REPORTED + 1] = {};   // Peak amplitude at the output, [k] = Hk (H0 = DC)
+        double phase[NUM_REPORTED + 1] = {};       // Radians, sine phase
+
+        // sqrt(H2^2 + ... + Hn^2) / H1, in percent
+        double thdPercent(int highestHarmonic = 5) const;
+    };
+
+    struct Gradient
+    {
+        double amplitude[NUM_PARAMETERS][NUM_REPORTED + 1] = {};   // d amplitude[k] / d parameter
+
+        // d thdPercent / d parameter, at the result solved with this gradient
+        double thdPercent(const Result& result, int parameter, int highestHarmonic = 5) const;
+    };
+
+    // Steady state for input amplitude * sin(2 pi frequency t) at the
+    // processor's input (before its input gain)
+    static Result solve(const HybridTapeProcessor& processor, double frequency, double amplitude,
+                        const Options& options);
+    static Result solve(const HybridTapeProcessor& processor, double frequency, double amplitude);
+
+    // Same, with the gradient of the harmonics (left at zero unless converged)
+    static Result solve(const HybridTapeProcessor& processor, double frequency, double amplitude,
+                        const Options& options, Gradient& gradient);
+
+private:
+    static Result balance(const HybridTapeProcessor& processor, double frequency, double amplitude,
+                          const Options& options, Gradient* gradient);
+};
+
+} // namespace TapeHysteresis
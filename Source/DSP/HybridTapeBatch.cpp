@@ -0,0 +1,350 @@
+#include "HybridTapeBatch.h"
+#include "DenormalGuard.h"
+#include <algorithm>
+
+namespace TapeHysteresis
+{
+
+namespace
+{
+
+constexpr int LANES = HybridTapeBatch::LANES;
+
+// One DF2T biquad per lane
+struct LaneBiquad
+{
+    double b0[LANES], b1[LANES], b2[LANES];
+    double a1[LANES], a2[LANES];
+    double z1[LANES], z2[LANES];
+
+    void load(int lane, const BiquadCoefficients& c, double state1, double state2)
+    {
+        b0[lane] = c.b0; b1[lane] = c.b1; b2[lane] = c.b2;
+        a1[lane] = c.a1; a2[lane] = c.a2;
+        z1[lane] = state1;
+        z2[lane] = state2;
+    }
+
+    // Identity (b0 = 1): passes the input through exactly, state stays 0
+    void loadIdentity(int lane)
+    {
+        load(lane, BiquadCoefficients(), 0.0, 0.0);
+    }
+
+    void process(double* x)
+    {
+        for (int l = 0; l < LANES; ++l)
+        {
+            double output = b0[l] * x[l] + z1[l];
+            z1[l] = b1[l] * x[l] - a1[l] * output + z2[l];
+            z2[l] = b2[l] * x[l] - a2[l] * output;
+            x[l] = output;
+        }
+    }
+};
+
+} // namespace
+
+// Lane-major copy of up to LANES processors. Lanes past numLanes mirror
+// lane 0 on silence and are never written back.
+struct HybridTapeBatch::Group
+{
+    using Processor = HybridTapeProcessor;
+    static constexpr int MAX_EQ_STAGES = MachineEQCoefficients::MAX_STAGES;
+    static constexpr int NUM_ALLPASSES = Processor::NUM_DISPERSIVE_STAGES;
+    static constexpr int DELAY_SIZE = Processor::DELAY_BUFFER_SIZE;
+
+    int numLanes = 0;
+    HybridTapeProcessor* processors[LANES] = {};
+    float* samples[LANES] = {};
+    bool rightChannel[LANES] = {};
+
+    // Saturation settings
+    double inputGain[LANES], linearThreshold[LANES], inputBias[LANES];
+    double jaInputScale[LANES], jaOutputScale[LANES], cleanHfBlend[LANES];
+    double jaBlendMax[LANES], jaBlendThreshold[LANES], jaBlendWidth[LANES];
+    double atanMix[LANES], atanThreshold[LANES], atanWidth[LANES], atanDrive[LANES];
+
+    // Envelope / fast path / DC tracker
+    double envelope[LANES], envelopeAttack[LANES], envelopeRelease[LANES], lastHfCutSignal[LANES];
+    bool jaIdle[LANES];
+    uint64_t jaSteps[LANES];
+    double eqInputDC[LANES], dcTrackCoefficient[LANES];
+
+    LaneBiquad hfCut[2];
+
+    // J-A
+    JilesAthertonCore::Constants<double> ja[LANES];
+    double T[LANES], M[LANES], H[LANES];
+
+    // Self-erasure
+    const SelfErasureTable* erasureTables[LANES];
+    double erasureZ1[LANES], erasureZ2[LANES];
+
+    // Linear stages
+    int numEqStages = 0;
+    LaneBiquad eq[MAX_EQ_STAGES];
+    double allpassCoefficient[NUM_ALLPASSES][LANES], allpassZ1[NUM_ALLPASSES][LANES];
+    LaneBiquad dcBlocker[2];
+
+    // Azimuth delay
+    double delayBuffer[LANES][DELAY_SIZE];
+    int delayWriteIndex[LANES];
+    double delaySamples[LANES];
+
+    void gather(int lane, const Processor& p)
+    {
+        inputGain[lane] = p.currentInputGain;
+        linearThreshold[lane] = p.linearThreshold;
+        inputBias[lane] = p.inputBias;
+        jaInputScale[lane] = p.jaInputScale;
+        jaOutputScale[lane] = p.jaOutputScale;
+        cleanHfBlend[lane] = p.cleanHfBlend;
+        jaBlendMax[lane] = p.jaBlendMax;
+        jaBlendThreshold[lane] = p.jaBlendThreshold;
+        jaBlendWidth[lane] = p.jaBlendWidth;
+        atanMix[lane] = p.atanMix;
+        atanThreshold[lane] = p.atanThreshold;
+        atanWidth[lane] = p.atanWidth;
+        atanDrive[lane] = p.atanDrive;
+
+        envelope[lane] = p.jaEnvelope;
+        envelopeAttack[lane] = p.envelopeAttack;
+        envelopeRelease[lane] = p.envelopeRelease;
+        lastHfCutSignal[lane] = p.lastHfCutSignal;
+        jaIdle[lane] = p.jaIdle;
+        jaSteps[lane] = 0;
+        eqInputDC[lane] = p.eqInputDC;
+        dcTrackCoefficient[lane] = p.dcTrackCoefficient;
+
+        for (int i = 0; i < 2; ++i)
+            hfCut[i].load(lane, p.hfCut.coefficients->shelves[i], p.hfCut.z1[i], p.hfCut.z2[i]);
+
+        ja[lane] = p.jaCore.constants;
+        T[lane] = p.jaCore.T;
+        M[lane] = p.jaCore.M_n1;
+        H[lane] = p.jaCore.H_n1;
+
+        erasureTables[lane] = p.selfErasure.table;
+        erasureZ1[lane] = p.selfErasure.z1;
+        erasureZ2[lane] = p.selfErasure.z2;
+
+        const MachineEQCoefficients& eqCoefficients = *p.machineEQ.coefficients;
+        for (int i = 0; i < MAX_EQ_STAGES; ++i)
+        {
+            if (i < eqCoefficients.numStages)
+                eq[i].load(lane, eqCoefficients.stages[i], p.machineEQ.z1[i], p.machineEQ.z2[i]);
+            else
+                eq[i].loadIdentity(lane);
+        }
+
+        for (int i = 0; i < NUM_ALLPASSES; ++i)
+        {
+            allpassCoefficient[i][lane] = p.dispersiveAllpass[i].coefficient;
+            allpassZ1[i][lane] = p.dispersiveAllpass[i].z1;
+        }
+
+        const Processor::Biquad* blockers[2] = { &p.dcBlocker1, &p.dcBlocker2 };
+        for (int i = 0; i < 2; ++i)
+        {
+            const Processor::Biquad& b = *blockers[i];
+            dcBlocker[i].load(lane, BiquadCoefficients { b.b0, b.b1, b.b2, b.a1, b.a2 }, b.z1, b.z2);
+        }
+
+        std::copy(p.delayBuffer, p.delayBuffer + DELAY_SIZE, delayBuffer[lane]);
+        delayWriteIndex[lane] = p.delayWriteIndex;
+        delaySamples[lane] = p.cachedDelaySamples;
+    }
+
+    void scatter(int lane, Processor& p) const
+    {
+        p.jaEnvelope = envelope[lane];
+        p.lastHfCutSignal = lastHfCutSignal[lane];
+        p.jaIdle = jaIdle[lane];
+        p.jaSteps += jaSteps[lane];
+        p.eqInputDC = eqInputDC[lane];
+
+        for (int i = 0; i < 2; ++i)
+        {
+            p.hfCut.z1[i] = hfCut[i].z1[lane];
+            p.hfCut.z2[i] = hfCut[i].z2[lane];
+        }
+
+        p.jaCore.M_n1 = M[lane];
+        p.jaCore.H_n1 = H[lane];
+
+        p.selfErasure.z1 = erasureZ1[lane];
+        p.selfErasure.z2 = erasureZ2[lane];
+
+        for (int i = 0; i < p.machineEQ.coefficients->numStages; ++i)
+        {
+            p.machineEQ.z1[i] = eq[i].z1[lane];
+            p.machineEQ.z2[i] = eq[i].z2[lane];
+        }
+
+        for (int i = 0; i < NUM_ALLPASSES; ++i)
+            p.dispersiveAllpass[i].z1 = allpassZ1[i][lane];
+
+        p.dcBlocker1.z1 = dcBlocker[0].z1[lane];
+        p.dcBlocker1.z2 = dcBlocker[0].z2[lane];
+        p.dcBlocker2.z1 = dcBlocker[1].z1[lane];
+        p.dcBlocker2.z2 = dcBlocker[1].z2[lane];
+
+        std::copy(delayBuffer[lane], delayBuffer[lane] + DELAY_SIZE, p.delayBuffer);
+        p.delayWriteIndex = delayWriteIndex[lane];
+    }
+
+    // HybridTapeProcessor::processSaturation for the listed lanes; hf holds
+    // the HFCut output already computed for every lane
+    void saturate(const int* active, int numActive, const double* gained, const double* hf, double* output)
+    {
+        double Hin[LANES], Hd[LANES], Mn[LANES], Mprev[LANES], biased[LANES];
+
+        for (int j = 0; j < numActive; ++j)
+        {
+            const int l = active[j];
+            if (jaIdle[l])
+            {
+                H[l] = (lastHfCutSignal[l] + inputBias[l]) * jaInputScale[l];
+                jaIdle[l] = false;
+            }
+
+            biased[j] = hf[l] + inputBias[l];
+            Hin[j] = biased[j] * jaInputScale[l];
+            Hd[j] = (Hin[j] - H[l]) / T[l];
+            Mprev[j] = M[l];
+            Mn[j] = M[l];
+            ++jaSteps[l];
+        }
+
+        // JilesAthertonCore::solveNR8, the lanes' iterations interleaved
+        for (int i = 0; i < JilesAthertonCore::NEWTON_ITERATIONS; ++i)
+            for (int j = 0; j < numActive; ++j)
+                JilesAthertonCore::newtonStep(ja[active[j]], T[active[j]], Hin[j], Hd[j], Mprev[j], Mn[j]);
+
+        for (int j = 0; j < numActive; ++j)
+        {
+            const int l = active[j];
+            H[l] = Hin[j];
+            M[l] = Mn[j];
+
+            double jaBlend = Processor::levelBlend(jaBlendMax[l], jaBlendThreshold[l], jaBlendWidth[l], envelope[l]);
+            double atanBlend = Processor::levelBlend(atanMix[l], atanThreshold[l], atanWidth[l], envelope[l]);
+            double jaPath = Mn[j] * jaOutputScale[l];
+            double atanOut = Processor::atanCurve(atanDrive[l], biased[j]);
+            double saturatedPath = Processor::mixLayers(hf[l], jaPath, atanOut, jaBlend, atanBlend);
+
+            double cleanHF = gained[l] - hf[l];
+            output[l] = selfErase(l, saturatedPath + cleanHF * cleanHfBlend[l]);
+        }
+    }
+
+    // SelfErasure::processSample
+    double selfErase(int l, double input)
+    {
+        const SelfErasureTable& table = *erasureTables[l];
+        return table.process(table.control(envelope[l]), input, erasureZ1[l], erasureZ2[l]);
+    }
+
+    void process(int numSamples)
+    {
+        for (int n = 0; n < numSamples; ++n)
+        {
+            double gained[LANES], hf[LANES], x[LANES];
+
+            for (int l = 0; l < LANES; ++l)
+            {
+                double input = (l < numLanes) ? static_cast<double>(samples[l][n]) : 0.0;
+                gained[l] = input * inputGain[l];
+
+                Processor::followEnvelope(envelope[l], gained[l], envelopeAttack[l], envelopeRelease[l]);
+
+                hf[l] = gained[l];
+            }
+
+            hfCut[0].process(hf);
+            hfCut[1].process(hf);
+
+            // Lanes with every blend closed are LTI this sample (bypassSaturation)
+            int active[LANES];
+            int numActive = 0;
+            for (int l = 0; l < LANES; ++l)
+            {
+                if (envelope[l] <= linearThreshold[l])
+                {
+                    x[l] = erasureTables[l]->process(0.0, gained[l], erasureZ1[l], erasureZ2[l]);
+                    lastHfCutSignal[l] = hf[l];
+                    jaIdle[l] = true;
+                }
+                else
+                {
+                    active[numActive++] = l;
+                }
+            }
+
+            if (numActive > 0)
+                saturate(active, numActive, gained, hf, x);
+
+            // processLinearStages
+            for (int l = 0; l < LANES; ++l)
+                eqInputDC[l] += dcTrackCoefficient[l] * (x[l] - eqInputDC[l]);
+
+            for (int i = 0; i < numEqStages; ++i)
+                eq[i].process(x);
+
+            for (int i = 0; i < NUM_ALLPASSES; ++i)
+            {
+                for (int l = 0; l < LANES; ++l)
+                {
+                    double output = allpassCoefficient[i][l] * x[l] + allpassZ1[i][l];
+                    allpassZ1[i][l] = x[l] - allpassCoefficient[i][l] * output;
+                    x[l] = output;
+                }
+            }
+
+            dcBlocker[0].process(x);
+            dcBlocker[1].process(x);
+
+            for (int l = 0; l < numLanes; ++l)
+            {
+                double output = rightChannel[l]
+                    ? Processor::azimuthDelay(delayBuffer[l], delayWriteIndex[l], delaySamples[l], x[l])
+                    : x[l];
+                samples[l][n] = static_cast<float>(output);
+            }
+        }
+    }
+};
+
+void HybridTapeBatch::process(const Lane* lanes, int numLanes, int numSamples)
+{
+    if (numLanes <= 0 || numSamples <= 0)
+        return;
+
+    DenormalGuard denormalGuard;
+    Group group;
+
+    for (int first = 0; first < numLanes; first += LANES)
+    {
+        group.numLanes = std::min(LANES, numLanes - first);
+        group.numEqStages = 0;
+
+        // Unused lanes copy lane 0 and run on silence
+        for (int l = 0; l < LANES; ++l)
+        {
+            const Lane& lane = lanes[first + (l < group.numLanes ? l : 0)];
+            group.processors[l] = lane.processor;
+            group.samples[l] = lane.samples;
+            group.rightChannel[l] = lane.rightChannel;
+            group.gather(l, *lane.processor);
+            group.numEqStages = std::max(group.numEqStages, lane.processor->machineEQ.coefficients->numStages);
+        }
+
+        group.process(numSamples);
+
+        for (int l = 0; l < group.numLanes; ++l)
+            group.scatter(l, *group.processors[l]);
+    }
+}
+
+} // namespace TapeHysteresis
@@ -0,0 +1,46 @@
+#pragma once
+
+#include "HybridTapeProcessor.h"
+
+namespace TapeHysteresis
+{
+
+/**
+ * Hybrid Tape Batch - several HybridTapeProcessors stepped side by side
+ *
+ * A session runs one core per track and channel. Each core is a long serial
+ * dependency chain (envelope -> J-A Newton iterations -> 20+ biquads), so a
+ * single core leaves most of the CPU's execution units idle. process() runs
+ * up to LANES cores in lock step instead: each block, the lanes' state and
+ * coefficients are gathered into lane-major arrays, every stage runs as a
+ * loop over the lanes (vectorizable for the filters, independent chains for
+ * the J-A solver), and the state is scattered back.
+ *
+ * The processors stay the owners of their state - nothing persists here, so
+ * a processor can move between batched and per-instance processing at any
+ * block boundary. Output is identical to each lane's own processBlock /
+ * processRightChannelBlock: every expression is evaluated in the same order,
+ * lanes take the linear fast path individually, and the padding (missing EQ
+ * stages, unused lanes) is exact identity.
+ *
+ * Lanes must not share a processor. Holds a DenormalGuard for the call.
+ */
+class HybridTapeBatch
+{
+public:
+    static constexpr int LANES = 4;
+
+    struct Lane
+    {
+        HybridTapeProcessor* processor = nullptr;
+        float* samples = nullptr;        // In place, numSamples long
+        bool rightChannel = false;       // processRightChannelBlock (azimuth delay)
+    };
+
+    static void process(const Lane* lanes, int numLanes, int numSamples);
+
+private:
+    struct Group;
+};
+
+} // namespace TapeHysteresis
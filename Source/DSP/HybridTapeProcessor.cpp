@@ -1,11 +1,15 @@
 #include "HybridTapeProcessor.h"
+#include "DenormalGuard.h"
 #include <algorithm>
+#include <vector>
 
 namespace TapeHysteresis
 {
 
 HybridTapeProcessor::HybridTapeProcessor()
 {
+    updateTimeConstants();
+    compileProfiles();
     updateCachedValues();
     reset();
 }
@@ -14,14 +18,13 @@ void HybridTapeProcessor::setSampleRate(double sampleRate)
 {
     fs = sampleRate;
     hfCut.setSampleRate(sampleRate);
+    selfErasure.setSampleRate(sampleRate);
     jaCore.setSampleRate(sampleRate);
     machineEQ.setSampleRate(sampleRate);
 
-    // Configure dispersive allpass cascade for HF phase smear
-    for (int i = 0; i < NUM_DISPERSIVE_STAGES; ++i) {
-        double freq = dispersiveCornerFreq * std::pow(2.0, i * 0.5);
-        dispersiveAllpass[i].setFrequency(freq, sampleRate);
-    }
+    // Machine-dependent coefficients (EQ, shelves, allpass, azimuth delay)
+    compileProfiles();
+    updateCachedValues();
 
     // Design 4th-order Butterworth high-pass at 5 Hz for DC blocking
     double fc = 5.0;
@@ -48,6 +51,30 @@ void HybridTapeProcessor::setSampleRate(double sampleRate)
     dcBlocker2.b2 = dcBlocker1.b2;
     dcBlocker2.a1 = dcBlocker1.a1;
     dcBlocker2.a2 = dcBlocker1.a2;
+
+    updateTimeConstants();
+}
+
+void HybridTapeProcessor::updateTimeConstants()
+{
+    // Envelope follower: calibrated as per-sample steps of 0.002 (attack)
+    // and 0.020 (release) at 96 kHz - kept as the same time constants
+    // (~5.2 ms / ~0.52 ms) at any rate, so the blends and THD don't move
+    // with the oversampled rate
+    const double samplesPerCalibrationSample = ENVELOPE_CALIBRATION_RATE / fs;
+    envelopeAttack = -std::expm1(std::log1p(-0.002) * samplesPerCalibrationSample);
+    envelopeRelease = -std::expm1(std::log1p(-0.020) * samplesPerCalibrationSample);
+
+    // DC estimate for machine switches: ~1 Hz one-pole
+    dcTrackCoefficient = 1.0 - std::exp(-2.0 * M_PI * 1.0 / fs);
+}
+
+int HybridTapeProcessor::getOversamplingFactor(double hostSampleRate)
+{
+    int factor = 1;
+    while (factor < 8 && hostSampleRate * factor < MIN_INTERNAL_RATE - 1.0)
+        factor *= 2;
+    return factor;
 }
 
 void HybridTapeProcessor::reset()
@@ -55,9 +82,13 @@ void HybridTapeProcessor::reset()
     dcBlocker1.reset();
     dcBlocker2.reset();
     hfCut.reset();
-    jaCore.reset();
+    selfErasure.reset();
     machineEQ.reset();
 
+    // At rest J-A sees only the input bias: park it at that operating point,
+    // so its first blended samples carry no magnetization transient
+    jaCore.settleAt(inputBias * jaInputScale);
+
     for (int i = 0; i < NUM_DISPERSIVE_STAGES; ++i) {
         dispersiveAllpass[i].reset();
     }
@@ -67,6 +98,68 @@ void HybridTapeProcessor::reset()
     }
     delayWriteIndex = 0;
     jaEnvelope = 0.0;
+    jaIdle = true;
+    lastHfCutSignal = 0.0;
+    eqInputDC = 0.0;
+}
+
+void HybridTapeProcessor::settle(const double* period, int numSamples)
+{
+    reset();
+    if (period == nullptr || numSamples <= 0)
+        return;
+
+    // Level-dependent front end: warm up on the end of the period (it leads
+    // into the start), then cycle whole periods until the envelope returns to
+    // where it started - bounded at ~2s of 96k samples for material that never
+    // repeats exactly. HFCut, J-A and self-erasure settle well within that.
+    std::vector<double> settled(static_cast<size_t>(numSamples));
+    auto runFrontEnd = [this](const double* input, int length, double* output) {
+        for (int i = 0; i < length; ++i) {
+            double gained = input[i] * currentInputGain;
+            updateEnvelope(gained);
+            output[i] = (jaEnvelope <= linearThreshold) ? bypassSaturation(gained) : processSaturation(gained);
+        }
+    };
+
+    const int warmup = std::min(numSamples, 16384);
+    runFrontEnd(period + numSamples - warmup, warmup, settled.data());
+
+    const int maxPasses = std::max(1, 200000 / numSamples);
+    for (int pass = 0; pass < maxPasses; ++pass)
+    {
+        const double startEnvelope = jaEnvelope;
+        runFrontEnd(period, numSamples, settled.data());
+
+        if (std::abs(jaEnvelope - startEnvelope) <= 1e-6 * std::max(jaEnvelope, 1e-6))
+            break;
+    }
+
+    double mean = 0.0;
+    for (double x : settled)
+        mean += x;
+    eqInputDC = mean / numSamples;
+
+    // Linear tail: periodic steady state of every section, stage by stage
+    machineEQ.settle(settled.data(), numSamples);
+
+    for (int i = 0; i < NUM_DISPERSIVE_STAGES; ++i) {
+        const double c = dispersiveAllpass[i].coefficient;
+        double unusedZ2 = 0.0;
+        settleBiquad({ c, 1.0, 0.0, c, 0.0 }, settled.data(), numSamples, dispersiveAllpass[i].z1, unusedZ2);
+    }
+
+    for (Biquad* dcBlocker : { &dcBlocker1, &dcBlocker2 }) {
+        const BiquadCoefficients c { dcBlocker->b0, dcBlocker->b1, dcBlocker->b2, dcBlocker->a1, dcBlocker->a2 };
+        settleBiquad(c, settled.data(), numSamples, dcBlocker->z1, dcBlocker->z2);
+    }
+
+    // Azimuth delay history: the end of the settled period
+    for (int i = 0; i < DELAY_BUFFER_SIZE; ++i) {
+        int source = ((numSamples - DELAY_BUFFER_SIZE + i) % numSamples + numSamples) % numSamples;
+        delayBuffer[i] = settled[static_cast<size_t>(source)];
+    }
+    delayWriteIndex = 0;
 }
 
 void HybridTapeProcessor::setParameters(double biasStrength, double inputGain)
@@ -83,87 +176,127 @@ void HybridTapeProcessor::setParameters(double biasStrength, double inputGain)
     }
 }
 
+void HybridTapeProcessor::setMachineProfile(Slot slot, const MachineProfile& profile)
+{
+    int index = (slot == Slot::Master) ? 0 : 1;
+    profiles[index] = profile;
+    CompiledProfile::compile(profiles[index], fs, compiledProfiles[index]);
+    updateCachedValues();
+}
+
+const MachineProfile& HybridTapeProcessor::getMachineProfile(Slot slot) const
+{
+    return profiles[(slot == Slot::Master) ? 0 : 1];
+}
+
+void HybridTapeProcessor::compileProfiles()
+{
+    CompiledProfile::compile(profiles[0], fs, compiledProfiles[0]);
+    CompiledProfile::compile(profiles[1], fs, compiledProfiles[1]);
+}
+
 void HybridTapeProcessor::updateCachedValues()
 {
     // Master (Ampex ATR-102): bias < 0.74
     // Tracks (Studer A820): bias >= 0.74
     isAmpexMode = (currentBiasStrength < 0.74);
 
-    JilesAthertonCore::Parameters jaParams;
-
-    if (isAmpexMode) {
-        // AMPEX ATR-102 (MASTER MODE)
-        // THD targets: -6dB=0.02%, 0dB=0.08%, +6dB=0.40%, MOL(3%)=+12dB
-        // E/O ratio ~0.5 (odd-dominant)
-
-        // === LAYER 1: J-A (hysteresis feel) ===
-        jaParams.M_s = 1.0;
-        jaParams.a = 50.0;
-        jaParams.k = 0.005;
-        jaParams.c = 0.96;
-        jaParams.alpha = 2.0e-7;
-        jaCore.setParameters(jaParams);
-        jaInputScale = 1.0;
-        jaOutputScale = 50.0;
-        jaBlendMax = 0.005;        // Very small - tune for -6dB ~0.02%
-        jaBlendThreshold = 0.05;
-        jaBlendWidth = 0.45;
-
-        // === LAYER 2: Atan (symmetric now - bias is global) ===
-        atanMix = 0.25;
-        atanThreshold = 0.18;
-        atanWidth = 2.2;
-        atanDrive = 0.6;
-
-        // Global input bias for E/O ~0.5 (odd-dominant)
-        inputBias = 0.06;           // Small bias for Ampex
-
-        dispersiveCornerFreq = 10000.0;
-    } else {
-        // STUDER A820 (TRACKS MODE)
-        // THD targets: -6dB=0.07%, 0dB=0.25%, +6dB=1.25%, MOL(3%)=+9dB
-        // E/O ratio ~1.12 (even-dominant)
-
-        // === LAYER 1: J-A (hysteresis feel) ===
-        jaParams.M_s = 1.0;
-        jaParams.a = 45.0;
-        jaParams.k = 0.008;
-        jaParams.c = 0.92;
-        jaParams.alpha = 5.0e-6;
-        jaCore.setParameters(jaParams);
-        jaInputScale = 1.0;
-        jaOutputScale = 50.0;
-        jaBlendMax = 0.012;        // More than Ampex - tune for -6dB ~0.07%
-        jaBlendThreshold = 0.02;
-        jaBlendWidth = 0.48;
-
-        // === LAYER 2: Atan (symmetric now - bias is global) ===
-        atanMix = 0.35;
-        atanThreshold = 0.20;
-        atanWidth = 1.8;
-        atanDrive = 0.95;
-
-        // Global input bias for E/O ~1.12 (even-dominant)
-        inputBias = 0.22;           // Larger bias for Studer's even-dominant character
-
-        dispersiveCornerFreq = 2800.0;
+    // Machine switch: point every stage at the other compiled block.
+    // The EQ curves share no history; the new one starts settled at the DC
+    // its input carries (the saturation's bias), so its HPs don't ring.
+    const CompiledProfile* newProfile = &compiledProfiles[isAmpexMode ? 0 : 1];
+    const bool machineSwitched = (newProfile != activeProfile);
+    activeProfile = newProfile;
+    const CompiledProfile& profile = *activeProfile;
+
+    // === LAYER 1: J-A (hysteresis feel) ===
+    jaCore.setParameters(profile.ja);
+    jaInputScale = profile.jaInputScale;
+    jaOutputScale = profile.jaOutputScale;
+    jaBlendMax = profile.jaBlendMax;
+    jaBlendThreshold = profile.jaBlendThreshold;
+    jaBlendWidth = profile.jaBlendWidth;
+
+    // === LAYER 2: Atan (symmetric - bias is global) ===
+    atanMix = profile.atanMix;
+    atanThreshold = profile.atanThreshold;
+    atanWidth = profile.atanWidth;
+    atanDrive = profile.atanDrive;
+
+    // Global input bias for E/O ratio
+    inputBias = profile.inputBias;
+
+    // Azimuth delay and dispersive allpass
+    cachedDelaySamples = profile.azimuthDelaySamples;
+    for (int i = 0; i < NUM_DISPERSIVE_STAGES; ++i) {
+        dispersiveAllpass[i].coefficient = profile.allpassCoefficients[i];
     }
 
-    // Azimuth delay: Ampex 8μs, Studer 12μs
-    double delayMicroseconds = isAmpexMode ? 8.0 : 12.0;
-    cachedDelaySamples = delayMicroseconds * 1e-6 * fs;
+    // AC bias shielding, self-erasure and machine EQ read their sections directly
+    hfCut.setCoefficients(&profile.hfCut);
+    selfErasure.setCoefficients(&profile.selfErasure);
+    machineEQ.setCoefficients(&profile.eq);
 
-    // Reconfigure allpass filters
-    for (int i = 0; i < NUM_DISPERSIVE_STAGES; ++i) {
-        double freq = dispersiveCornerFreq * std::pow(2.0, i * 0.5);
-        dispersiveAllpass[i].setFrequency(freq, fs);
+    if (machineSwitched) {
+        double dcLevel = eqInputDC;
+        machineEQ.settle(&dcLevel, 1);
     }
 
-    // Update machine EQ
-    machineEQ.setMachine(isAmpexMode ? MachineEQ::Machine::Ampex : MachineEQ::Machine::Studer);
+    updateLinearThreshold();
+}
+
+void HybridTapeProcessor::setLinearFastPath(bool enabled)
+{
+    linearFastPath = enabled;
+    updateLinearThreshold();
+}
+
+void HybridTapeProcessor::updateLinearThreshold()
+{
+    // Largest envelope at which J-A, atan and self-erasure all contribute
+    // exactly nothing. A constant J-A blend (width 0) never closes.
+    double threshold = activeProfile->selfErasure.threshold;
+
+    if (jaBlendMax != 0.0)
+        threshold = (jaBlendWidth <= 0.0) ? -1.0 : std::min(threshold, jaBlendThreshold);
+    if (atanMix != 0.0)
+        threshold = std::min(threshold, atanThreshold);
+
+    // The split only sums back to the input with all of the HF clean
+    linearThreshold = (linearFastPath && cleanHfBlend == 1.0) ? threshold : -1.0;
+}
+
+HybridTapeProcessor::Tuning HybridTapeProcessor::getTuning() const
+{
+    Tuning tuning;
+    tuning.jaBlendMax = jaBlendMax;
+    tuning.jaBlendThreshold = jaBlendThreshold;
+    tuning.jaBlendWidth = jaBlendWidth;
+    tuning.atanMix = atanMix;
+    tuning.atanThreshold = atanThreshold;
+    tuning.atanWidth = atanWidth;
+    tuning.atanDrive = atanDrive;
+    tuning.inputBias = inputBias;
+    return tuning;
+}
 
-    // Update AC bias shielding curve for selected machine
-    hfCut.setMachineMode(isAmpexMode);
+void HybridTapeProcessor::setTuning(const Tuning& tuning)
+{
+    jaBlendMax = tuning.jaBlendMax;
+    jaBlendThreshold = tuning.jaBlendThreshold;
+    jaBlendWidth = std::max(tuning.jaBlendWidth, 0.0);
+    atanMix = std::clamp(tuning.atanMix, 0.0, 1.0);
+    atanThreshold = tuning.atanThreshold;
+    atanWidth = std::max(tuning.atanWidth, 1e-6);
+    atanDrive = std::max(tuning.atanDrive, 0.0);
+    inputBias = tuning.inputBias;
+
+    updateLinearThreshold();
+}
+
+void HybridTapeProcessor::updateEnvelope(double gained)
+{
+    followEnvelope(jaEnvelope, gained, envelopeAttack, envelopeRelease);
 }
 
 double HybridTapeProcessor::processSample(double input)
@@ -171,21 +304,25 @@ double HybridTapeProcessor::processSample(double input)
     double gained = input * currentInputGain;
 
     // Envelope follower for level-dependent blend
-    double absGained = std::abs(gained);
-    if (absGained > jaEnvelope) {
-        jaEnvelope += 0.002 * (absGained - jaEnvelope);
-    } else {
-        jaEnvelope += 0.020 * (absGained - jaEnvelope);
+    updateEnvelope(gained);
+
+    // Every blend closed: the core is LTI for this sample
+    double output = (jaEnvelope <= linearThreshold) ? bypassSaturation(gained) : processSaturation(gained);
+
+    return processLinearStages(output);
+}
+
+double HybridTapeProcessor::processSaturation(double gained)
+{
+    // Back from the linear path: J-A resumes from where it was left, with
+    // its field history re-anchored to the last sample's (blend starts at 0)
+    if (jaIdle) {
+        jaCore.resumeAt((lastHfCutSignal + inputBias) * jaInputScale);
+        jaIdle = false;
     }
 
     // J-A blend - can be constant or level-dependent
-    double jaBlend;
-    if (jaBlendWidth > 0.0) {
-        double blendRatio = std::clamp((jaEnvelope - jaBlendThreshold) / jaBlendWidth, 0.0, 1.0);
-        jaBlend = jaBlendMax * blendRatio * blendRatio * (3.0 - 2.0 * blendRatio);
-    } else {
-        jaBlend = jaBlendMax;  // Constant blend when width = 0
-    }
+    double jaBlend = computeJaBlend(jaEnvelope);
 
     // === PARALLEL PATH PROCESSING (AC Bias Shielding) ===
     // The high bias frequency linearizes HF recording, so HF bypasses saturation
@@ -207,25 +344,43 @@ double HybridTapeProcessor::processSample(double input)
 
     // 1. J-A for hysteresis feel - processes biased signal
     double jaPath = jaCore.process(biasedSignal * jaInputScale) * jaOutputScale;
+    ++jaSteps;
 
     // 2. Atan for cubic character - processes biased signal (symmetric atan now)
     double atanOut = softAtan(biasedSignal);
 
-    // Blend J-A into signal
-    double mainPath = hfCutSignal * (1.0 - jaBlend) + jaPath * jaBlend;
-
-    // Level-dependent atan blend (engages at higher levels where J-A drops off)
-    double atanBlendRatio = std::clamp((jaEnvelope - atanThreshold) / atanWidth, 0.0, 1.0);
-    double atanBlend = atanMix * atanBlendRatio * atanBlendRatio * (3.0 - 2.0 * atanBlendRatio);
-    double saturatedPath = mainPath * (1.0 - atanBlend) + atanOut * atanBlend;
+    // Blend J-A into signal, then the level-dependent atan blend over it
+    // (engages at higher levels where J-A drops off)
+    double atanBlend = computeAtanBlend(jaEnvelope);
+    double saturatedPath = mixLayers(hfCutSignal, jaPath, atanOut, jaBlend, atanBlend);
 
     // === COMBINE PATHS ===
     // Sum saturated signal (with HF removed) + clean HF (bypassed saturation)
     // cleanHfBlend controls how much of the shielded HF is clean vs saturated
     double output = saturatedPath + cleanHF * cleanHfBlend;
 
+    // Self-erasure: HF darkens as record level rises
+    return selfErasure.processSample(output, jaEnvelope);
+}
+
+double HybridTapeProcessor::bypassSaturation(double gained)
+{
+    // With jaBlend = atanBlend = 0 the saturated path is the HFCut signal
+    // itself, so saturated + clean HF is the input and self-erasure is flat
+    // (its state from the last engagement rings out, then it is identity).
+    // HFCut still runs so its state is current when the envelope crosses back.
+    lastHfCutSignal = hfCut.processSample(gained);
+    jaIdle = true;
+
+    return selfErasure.processFlat(gained);
+}
+
+double HybridTapeProcessor::processLinearStages(double input)
+{
+    eqInputDC += dcTrackCoefficient * (input - eqInputDC);
+
     // Machine-specific EQ (always on)
-    output = machineEQ.processSample(output);
+    double output = machineEQ.processSample(input);
 
     // HF dispersive allpass (tape head phase smear)
     for (int i = 0; i < NUM_DISPERSIVE_STAGES; ++i) {
@@ -239,30 +394,91 @@ double HybridTapeProcessor::processSample(double input)
     return output;
 }
 
-double HybridTapeProcessor::softAtan(double x)
+template <typename Sample>
+void HybridTapeProcessor::processBlockInPlace(Sample* samples, int numSamples, bool rightChannel)
+{
+    DenormalGuard denormalGuard;
+
+    // The envelope never leaves [its current value, the block's peak], so a
+    // block peaking under linearThreshold is linear from start to end and
+    // skips the per-sample regime test
+    double peak = jaEnvelope;
+    for (int i = 0; i < numSamples; ++i)
+        peak = std::max(peak, std::abs(static_cast<double>(samples[i]) * currentInputGain));
+
+    if (peak <= linearThreshold) {
+        for (int i = 0; i < numSamples; ++i) {
+            double gained = static_cast<double>(samples[i]) * currentInputGain;
+            updateEnvelope(gained);
+            double output = processLinearStages(bypassSaturation(gained));
+            samples[i] = static_cast<Sample>(rightChannel ? applyAzimuthDelay(output) : output);
+        }
+        return;
+    }
+
+    if (rightChannel) {
+        for (int i = 0; i < numSamples; ++i)
+            samples[i] = static_cast<Sample>(processRightChannel(samples[i]));
+    } else {
+        for (int i = 0; i < numSamples; ++i)
+            samples[i] = static_cast<Sample>(processSample(samples[i]));
+    }
+}
+
+void HybridTapeProcessor::processBlock(double* samples, int numSamples)
 {
-    if (atanDrive < 0.001) return x;
-    return std::atan(atanDrive * x) / atanDrive;
+    processBlockInPlace(samples, numSamples, false);
 }
 
-double HybridTapeProcessor::processRightChannel(double input)
+void HybridTapeProcessor::processBlock(float* samples, int numSamples)
+{
+    processBlockInPlace(samples, numSamples, false);
+}
+
+void HybridTapeProcessor::processRightChannelBlock(double* samples, int numSamples)
+{
+    processBlockInPlace(samples, numSamples, true);
+}
+
+void HybridTapeProcessor::processRightChannelBlock(float* samples, int numSamples)
+{
+    processBlockInPlace(samples, numSamples, true);
+}
+
+double HybridTapeProcessor::computeJaBlend(double envelope) const
 {
-    double processed = processSample(input);
+    return levelBlend(jaBlendMax, jaBlendThreshold, jaBlendWidth, envelope);
+}
 
-    // Azimuth delay
-    delayBuffer[delayWriteIndex] = processed;
+double HybridTapeProcessor::computeAtanBlend(double envelope) const
+{
+    return levelBlend(atanMix, atanThreshold, atanWidth, envelope);
+}
 
-    double readPos = static_cast<double>(delayWriteIndex) - cachedDelaySamples;
-    if (readPos < 0.0) readPos += DELAY_BUFFER_SIZE;
+HybridTapeProcessor::ProbeState HybridTapeProcessor::getProbeState() const
+{
+    ProbeState state;
+    state.H = jaCore.getH();
+    state.M = jaCore.getM();
+    state.envelope = jaEnvelope;
+    state.jaBlend = computeJaBlend(jaEnvelope);
+    state.atanBlend = computeAtanBlend(jaEnvelope);
+    return state;
+}
 
-    int readIndex0 = static_cast<int>(readPos);
-    int readIndex1 = (readIndex0 + 1) % DELAY_BUFFER_SIZE;
-    double frac = readPos - static_cast<double>(readIndex0);
+double HybridTapeProcessor::softAtan(double x)
+{
+    return atanCurve(atanDrive, x);
+}
 
-    double delayed = delayBuffer[readIndex0] * (1.0 - frac) + delayBuffer[readIndex1] * frac;
-    delayWriteIndex = (delayWriteIndex + 1) % DELAY_BUFFER_SIZE;
+double HybridTapeProcessor::processRightChannel(double input)
+{
+    return applyAzimuthDelay(processSample(input));
+}
 
-    return delayed;
+double HybridTapeProcessor::applyAzimuthDelay(double processed)
+{
+    return azimuthDelay(delayBuffer, delayWriteIndex, cachedDelaySamples, processed);
 }
 
 } // namespace TapeHysteresis
@@ -2,6 +2,8 @@
 
 #define _USE_MATH_DEFINES
 #include <cmath>
+#include <algorithm>
+#include <cstdint>
 
 #ifndef M_PI
 #define M_PI 3.14159265358979323846
@@ -10,10 +12,14 @@
 #include "BiasShielding.h"
 #include "JilesAthertonCore.h"
 #include "MachineEQ.h"
+#include "MachineProfile.h"
 
 namespace TapeHysteresis
 {
 
+class HybridTapeBatch;
+class HarmonicBalance;
+
 /**
  * Hybrid Tape Saturation Processor
  *
@@ -22,23 +28,55 @@ namespace TapeHysteresis
  *   2. J-A Hysteresis - Physics-based magnetic domain model for tape compression
  *   3. Symmetric Atan - Smooth cubic saturation at higher levels
  *   4. Clean HF Path - Bypasses saturation (AC bias shielding)
+ *   5. Self-Erasure - Level-dependent HF shelf driven by the same envelope
  *
  * MASTER MODE (Ampex ATR-102):
  *   - THD: -12dB=0.005%, -6dB=0.02%, 0dB=0.08%, +6dB=0.40%
  *   - E/O ratio ~0.54 (odd-dominant), inputBias=0.06
  *
  * TRACKS MODE (Studer A820):
- *   - THD: -12dB=0.02%, -6dB=0.07%, 0dB=0.28%, +6dB=1.13%
- *   - E/O ratio ~1.17 (even-dominant), inputBias=0.22
+ *   - THD: -12dB=0.02%, -6dB=0.07%, 0dB=0.28%, +6dB=1.16%
+ *   - E/O ratio ~1.15 (even-dominant), inputBias=0.22
  */
 class HybridTapeProcessor
 {
 public:
+    // Bump whenever the output for identical input and settings changes -
+    // render caches (RenderCache) key on it
+    static constexpr int ENGINE_VERSION = 5;
+
     HybridTapeProcessor();
     ~HybridTapeProcessor() = default;
 
+    // Stages read coefficients from this object's compiled profiles
+    HybridTapeProcessor(const HybridTapeProcessor&) = delete;
+    HybridTapeProcessor& operator=(const HybridTapeProcessor&) = delete;
+
     void setSampleRate(double sampleRate);
+
+    /**
+     * Oversampling factor for a host rate: the smallest power of two (up to
+     * 8x) that brings the core to at least MIN_INTERNAL_RATE - 2x at
+     * 44.1/48 kHz, 1x from 88.2 kHz up. Coefficients and time constants
+     * follow setSampleRate(), so the calibration holds at any of these rates.
+     */
+    static constexpr double MIN_INTERNAL_RATE = 88200.0;
+    static int getOversamplingFactor(double hostSampleRate);
+
+    /**
+     * reset() leaves the core in its steady state for silence: filters at
+     * rest, J-A at the bias operating point. settle() instead installs the
+     * steady state for `period` repeated forever (one or more whole periods
+     * of a test signal, or a stretch of stationary material, at the
+     * processor's rate): the envelope, HFCut, J-A and self-erasure are cycled
+     * over it until the envelope converges (a few ms of signal), then the
+     * slow linear stages - machine EQ, allpasses, 5 Hz DC blocker - are
+     * solved for their periodic steady state directly (settleBiquad). A
+     * render starting with that period is settled from sample 0.
+     * Allocates - call from prepare / offline code.
+     */
     void reset();
+    void settle(const double* period, int numSamples);
 
     /**
      * @param biasStrength - < 0.74 = Master (Ampex), >= 0.74 = Tracks (Studer)
@@ -49,13 +87,144 @@ public:
     double processSample(double input);
     double processRightChannel(double input);  // With azimuth delay
 
+    /**
+     * In-place block processing. Sets flush-to-zero / denormals-are-zero for
+     * the block (DenormalGuard), so silence tails stay at full speed without
+     * relying on the host. Per-sample callers should hold their own guard.
+     */
+    void processBlock(double* samples, int numSamples);
+    void processBlock(float* samples, int numSamples);
+    void processRightChannelBlock(double* samples, int numSamples);
+    void processRightChannelBlock(float* samples, int numSamples);
+
+    /**
+     * Machine profiles: the Master (bias < 0.74) and Tracks slots default to
+     * the built-in Ampex ATR-102 / Studer A820. Both slots are compiled for
+     * the current sample rate, so a mode change only swaps the active block.
+     * Compiles coefficients - call from prepare / the message thread.
+     */
+    enum class Slot { Master, Tracks };
+    void setMachineProfile(Slot slot, const MachineProfile& profile);
+    const MachineProfile& getMachineProfile(Slot slot) const;
+
+    /**
+     * Saturation tuning - exposed for the calibration tools.
+     * setTuning() overrides the current machine's values; the calibrated
+     * defaults are restored on the next machine mode / input gain / sample
+     * rate change.
+     */
+    struct Tuning {
+        double jaBlendMax = 0.0;
+        double jaBlendThreshold = 0.0;
+        double jaBlendWidth = 0.0;
+        double atanMix = 0.0;
+        double atanThreshold = 0.0;
+        double atanWidth = 0.0;
+        double atanDrive = 0.0;
+        double inputBias = 0.0;
+    };
+
+    Tuning getTuning() const;
+    void setTuning(const Tuning& tuning);
+
+    /**
+     * Linear fast path (on by default): while the envelope keeps every
+     * level-dependent blend closed the core is LTI - the saturation layers
+     * are skipped and only HFCut runs alongside to stay warm. Off = always
+     * run the full path (reference for tests and benchmarks).
+     */
+    void setLinearFastPath(bool enabled);
+
+    /**
+     * Operating point after the last processed sample (for visualization).
+     * Computed on demand - costs nothing unless called.
+     */
+    struct ProbeState {
+        double H = 0.0;           // J-A input field
+        double M = 0.0;           // J-A magnetization (normalized, M_s = 1)
+        double envelope = 0.0;    // Level envelope driving the blends
+        double jaBlend = 0.0;
+        double atanBlend = 0.0;
+    };
+
+    ProbeState getProbeState() const;
+
+    /**
+     * Samples that ran the J-A core (JilesAthertonCore::NEWTON_ITERATIONS
+     * Newton steps each) since construction - linear fast path samples
+     * don't count. One increment per saturated sample, for telemetry.
+     */
+    uint64_t getJaStepCount() const { return jaSteps; }
+
+    /**
+     * The per-sample steps of the core, shared with HybridTapeBatch (lanes)
+     * and HarmonicBalance (steady state), so there is one copy of each.
+     * The saturation's memoryless curves - level blend (amount x smoothstep
+     * of the envelope over threshold .. threshold + width; width 0 = the
+     * constant amount), the atan and the layer mix - are templated on the
+     * scalar so HarmonicBalance can differentiate them on dual numbers
+     * (Dual.h). The J-A step is JilesAthertonCore::newtonStep.
+     */
+    template <typename Scalar>
+    static Scalar levelBlend(const Scalar& amount, const Scalar& threshold, const Scalar& width, double envelope)
+    {
+        if (width <= 0.0) return amount;
+        Scalar ratio = std::clamp((envelope - threshold) / width, Scalar(0.0), Scalar(1.0));
+        return amount * ratio * ratio * (3.0 - 2.0 * ratio);
+    }
+
+    template <typename Scalar>
+    static Scalar atanCurve(const Scalar& drive, const Scalar& x)
+    {
+        using std::atan;
+        if (drive < 0.001) return x;
+        return atan(drive * x) / drive;
+    }
+
+    // J-A blended into the HFCut signal, then the atan over that
+    template <typename Scalar>
+    static Scalar mixLayers(const Scalar& hfCutSignal, const Scalar& jaPath, const Scalar& atanOut,
+                            const Scalar& jaBlend, const Scalar& atanBlend)
+    {
+        Scalar mainPath = hfCutSignal * (1.0 - jaBlend) + jaPath * jaBlend;
+        return mainPath * (1.0 - atanBlend) + atanOut * atanBlend;
+    }
+
 private:
+    friend class HybridTapeBatch;     // Steps several processors side by side
+    friend class HarmonicBalance;     // Solves the steady state from the same state
+
     // Azimuth delay buffer (supports up to 384kHz)
     static constexpr int DELAY_BUFFER_SIZE = 8;
     double delayBuffer[DELAY_BUFFER_SIZE] = {0.0};
     int delayWriteIndex = 0;
     double cachedDelaySamples = 0.0;
 
+    // Envelope follower: attack above the envelope, release below
+    static void followEnvelope(double& envelope, double gained, double attack, double release)
+    {
+        double level = std::abs(gained);
+        envelope += ((level > envelope) ? attack : release) * (level - envelope);
+    }
+
+    // Right-channel azimuth delay: fractional read from a DELAY_BUFFER_SIZE ring
+    static double azimuthDelay(double* buffer, int& writeIndex, double delaySamples, double processed)
+    {
+        buffer[writeIndex] = processed;
+
+        double readPos = static_cast<double>(writeIndex) - delaySamples;
+        if (readPos < 0.0) readPos += DELAY_BUFFER_SIZE;
+
+        int readIndex0 = static_cast<int>(readPos);
+        int readIndex1 = (readIndex0 + 1) % DELAY_BUFFER_SIZE;
+        double frac = readPos - static_cast<double>(readIndex0);
+
+        double delayed = buffer[readIndex0] * (1.0 - frac) + buffer[readIndex1] * frac;
+        writeIndex = (writeIndex + 1) % DELAY_BUFFER_SIZE;
+
+        return delayed;
+    }
+
     // Parameters
     double currentBiasStrength = 0.5;
     double currentInputGain = 1.0;
@@ -78,6 +247,24 @@ private:
     double jaBlendWidth = 2.5;
     double jaEnvelope = 0.0;
 
+    // Envelope follower steps per sample (updateTimeConstants)
+    static constexpr double ENVELOPE_CALIBRATION_RATE = 96000.0;
+    double envelopeAttack = 0.002;
+    double envelopeRelease = 0.020;
+
+    // Linear fast path: envelope at or under linearThreshold = LTI sample
+    // (negative = never). jaIdle: J-A skipped since it last ran.
+    bool linearFastPath = true;
+    double linearThreshold = -1.0;
+    bool jaIdle = false;
+    double lastHfCutSignal = 0.0;
+    uint64_t jaSteps = 0;
+
+    // Slow DC estimate at the machine EQ input: a machine switch installs
+    // the new curve already settled at this level
+    double eqInputDC = 0.0;
+    double dcTrackCoefficient = 0.0;
+
     // DC blocking (4th-order Butterworth @ 5Hz)
     struct Biquad {
         double b0 = 1.0, b1 = 0.0, b2 = 0.0;
@@ -97,15 +284,13 @@ private:
     HFCut hfCut;
     double cleanHfBlend = 1.0;
 
+    // Dynamic HF self-erasure (shares jaEnvelope)
+    SelfErasure selfErasure;
+
     // Dispersive allpass (HF phase smear)
     struct AllpassFilter {
-        double coefficient = 0.0;
+        double coefficient = 0.0;     // From the active CompiledProfile
         double z1 = 0.0;
-        void setFrequency(double freq, double sampleRate) {
-            double w0 = 2.0 * M_PI * freq / sampleRate;
-            double tanHalf = std::tan(w0 / 2.0);
-            coefficient = (1.0 - tanHalf) / (1.0 + tanHalf);
-        }
         void reset() { z1 = 0.0; }
         double process(double input) {
             double output = coefficient * input + z1;
@@ -113,9 +298,8 @@ private:
             return output;
         }
     };
-    static constexpr int NUM_DISPERSIVE_STAGES = 4;
+    static constexpr int NUM_DISPERSIVE_STAGES = CompiledProfile::NUM_DISPERSIVE_STAGES;
     AllpassFilter dispersiveAllpass[NUM_DISPERSIVE_STAGES];
-    double dispersiveCornerFreq = 10000.0;
 
     // Jiles-Atherton hysteresis
     JilesAthertonCore jaCore;
@@ -125,8 +309,26 @@ private:
     // Machine EQ
     MachineEQ machineEQ;
 
+    // Machine profiles (Master, Tracks) and their compiled blocks at fs
+    MachineProfile profiles[2] = { MachineProfile::ampexATR102(), MachineProfile::studerA820() };
+    CompiledProfile compiledProfiles[2];
+    const CompiledProfile* activeProfile = &compiledProfiles[0];
+
+    void compileProfiles();
     void updateCachedValues();
+    void updateLinearThreshold();
+    void updateTimeConstants();
+
+    template <typename Sample>
+    void processBlockInPlace(Sample* samples, int numSamples, bool rightChannel);
+    void updateEnvelope(double gained);
+    double bypassSaturation(double gained);
+    double processSaturation(double gained);
+    double processLinearStages(double input);
+    double applyAzimuthDelay(double input);
     double softAtan(double x);
+    double computeJaBlend(double envelope) const;
+    double computeAtanBlend(double envelope) const;
 };
 
 } // namespace TapeHysteresis
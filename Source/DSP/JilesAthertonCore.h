@@ -5,6 +5,9 @@
 
 namespace TapeHysteresis {
 
+class HybridTapeBatch;
+class HarmonicBalance;
+
 // Jiles-Atherton Hysteresis Model
 // Based on "Real-Time Physical Modelling for Analog Tape Machines" (DAFx 2019)
 class JilesAthertonCore {
@@ -17,12 +20,14 @@ public:
         double alpha = 1.6e-3;   // Mean field parameter
     };
 
+    // Fixed Newton steps per sample (no early exit - constant cost)
+    static constexpr int NEWTON_ITERATIONS = 8;
+
     JilesAthertonCore() { reset(); }
 
     void setParameters(const Parameters& p) {
         params = p;
-        oneOverA = 1.0 / params.a;
-        cAlpha = params.c * params.alpha;
+        constants = makeConstants(p.M_s, p.a, p.k, p.c, p.alpha);
     }
 
     void setSampleRate(double sr) {
@@ -34,6 +39,10 @@ public:
         H_n1 = 0.0;
     }
 
+    // Last processed operating point (for visualization)
+    double getH() const { return H_n1; }
+    double getM() const { return M_n1; }
+
     double process(double H) {
         double H_d = (H - H_n1) / T;
         double M = solveNR8(H, H_d);
@@ -42,52 +51,106 @@ public:
         return M;
     }
 
+    // Demagnetized, then brought up to field H along the initial
+    // magnetization curve - where a constant H leaves the core
+    void settleAt(double H) {
+        reset();
+        for (int i = 1; i <= 64; ++i)
+            process(H * i / 64.0);
+    }
+
+    // Re-anchor the field history after the caller skipped samples, so the
+    // next H_d is a one-sample difference again (M keeps its last value)
+    void resumeAt(double H) {
+        H_n1 = H;
+    }
+
+    // The constants in the form the Newton step uses them. Templated on
+    // the scalar: HarmonicBalance differentiates the model on dual numbers
+    template <typename Scalar>
+    struct Constants {
+        Scalar M_s, oneOverA, k, c, alpha;
+        Scalar denom;            // 1 - c alpha
+    };
+
+    template <typename Scalar>
+    static Constants<Scalar> makeConstants(const Scalar& M_s, const Scalar& a, const Scalar& k,
+                                           const Scalar& c, const Scalar& alpha)
+    {
+        return { M_s, 1.0 / a, k, c, alpha, 1.0 - c * alpha };
+    }
+
+    // Langevin function L(x) and its derivative, sharing one coth
+    template <typename Scalar>
+    static void langevin(const Scalar& x, Scalar& L, Scalar& dL) {
+        using std::abs; using std::tanh;
+        if (abs(x) < 1e-4) {
+            L = x / 3.0;
+            dL = Scalar(1.0 / 3.0);
+            return;
+        }
+        Scalar cothX = 1.0 / tanh(x);
+        L = cothX - 1.0 / x;
+        dL = 1.0 / (x * x) - cothX * cothX + 1.0;
+    }
+
+    // dM/dH at (H, M) for a field moving in direction delta (+1 / -1), and
+    // its partial in M as the Newton step approximates it
+    template <typename Scalar>
+    struct Slope {
+        Scalar dM_dH;
+        Scalar dM_dH_dM;
+    };
+
+    template <typename Scalar>
+    static Slope<Scalar> slope(const Constants<Scalar>& p, const Scalar& H, const Scalar& M, double delta) {
+        using std::abs;
+        Scalar L, dL;
+        langevin((H + p.alpha * M) * p.oneOverA, L, dL);
+
+        Scalar M_an = p.M_s * L;
+        Scalar dM_an_dM = p.M_s * dL * p.oneOverA * p.alpha;
+        Scalar M_diff = M_an - M;
+        Scalar delta_k = delta * p.k;
+        Scalar df_denom = delta_k - p.alpha * M_diff;
+
+        Slope<Scalar> s;
+        s.dM_dH = (abs(M_diff) > 1e-12 && delta * M_diff > 0.0)
+            ? (M_diff / df_denom + p.c * dM_an_dM) / p.denom
+            : p.c * dM_an_dM / p.denom;
+        s.dM_dH_dM = (abs(df_denom) > 1e-12)
+            ? (dM_an_dM - 1.0) / df_denom / p.denom
+            : Scalar(0.0);
+        return s;
+    }
+
+    // One Newton step on M for the implicit update
+    // M = Mprev + T dM/dH(H, M) H_d (solveNR8 runs NEWTON_ITERATIONS of them)
+    template <typename Scalar>
+    static void newtonStep(const Constants<Scalar>& p, double T, const Scalar& H, const Scalar& H_d,
+                           const Scalar& Mprev, Scalar& M) {
+        using std::abs;
+        Slope<Scalar> s = slope(p, H, M, (H_d >= 0.0) ? 1.0 : -1.0);
+        Scalar f = M - Mprev - T * s.dM_dH * H_d;
+        Scalar f_prime = 1.0 - T * H_d * s.dM_dH_dM;
+        if (abs(f_prime) > 1e-12) M -= f / f_prime;
+        M = std::clamp(M, -p.M_s, p.M_s);
+    }
+
 private:
+    friend class HybridTapeBatch;
+    friend class HarmonicBalance;
+
     Parameters params;
+    Constants<double> constants = makeConstants(params.M_s, params.a, params.k, params.c, params.alpha);
     double T = 1.0 / 48000.0;
     double M_n1 = 0.0;
     double H_n1 = 0.0;
-    double oneOverA = 1.0 / 22000.0;
-    double cAlpha = 0.0;
-
-    double langevin(double x) const {
-        if (std::abs(x) < 1e-4) return x / 3.0;
-        return 1.0 / std::tanh(x) - 1.0 / x;
-    }
-
-    double langevinD(double x) const {
-        if (std::abs(x) < 1e-4) return 1.0 / 3.0;
-        double cothX = 1.0 / std::tanh(x);
-        return 1.0 / (x * x) - cothX * cothX + 1.0;
-    }
 
     double solveNR8(double H, double H_d) {
-        double delta = (H_d >= 0.0) ? 1.0 : -1.0;
         double M = M_n1;
-        double denom = 1.0 - cAlpha;
-
-        for (int i = 0; i < 8; ++i) {
-            double H_eff = H + params.alpha * M;
-            double x = H_eff * oneOverA;
-            double M_an = params.M_s * langevin(x);
-            double dM_an_dM = params.M_s * langevinD(x) * oneOverA * params.alpha;
-            double M_diff = M_an - M;
-            double delta_k = delta * params.k;
-
-            double dM_dH = (std::abs(M_diff) > 1e-12 && delta * M_diff > 0)
-                ? (M_diff / (delta_k - params.alpha * M_diff) + params.c * dM_an_dM) / denom
-                : params.c * dM_an_dM / denom;
-
-            double f = M - M_n1 - T * dM_dH * H_d;
-            double df_denom = delta_k - params.alpha * M_diff;
-            double df_dM = (std::abs(df_denom) > 1e-12)
-                ? (dM_an_dM - 1.0) / df_denom / denom
-                : 0.0;
-            double f_prime = 1.0 - T * H_d * df_dM;
-
-            if (std::abs(f_prime) > 1e-12) M -= f / f_prime;
-            M = std::clamp(M, -params.M_s, params.M_s);
-        }
+        for (int i = 0; i < NEWTON_ITERATIONS; ++i)
+            newtonStep(constants, T, H, H_d, M_n1, M);
         return M;
     }
 };
@@ -0,0 +1,136 @@
+#pragma once
+
+#define _USE_MATH_DEFINES
+#include <cmath>
+#include <atomic>
+#include <algorithm>
+#include <iterator>
+
+namespace TapeHysteresis
+{
+
+// LevelMeter - Max-since-last-read channel meter, audio thread -> GUI
+//
+// The audio thread measures in the loops it already runs and publishes one
+// summary per block; nothing here touches the sample buffer:
+//   - Peak:      block max |x|, held until the GUI reads it (atomic max,
+//                cleared by exchange on read), so no transient is missed
+//                however small the host buffer or slow the GUI timer
+//   - True peak: same hold, fed from the oversampled input, or from a
+//                TruePeakInterpolator where the core runs at the host rate
+//   - RMS:       ~300ms exponential window of the block mean square
+//
+// Single writer (audio thread), single reader (GUI). No locks; the max
+// update only retries when the reader cleared the value in between.
+class LevelMeter
+{
+public:
+    struct Reading
+    {
+        float peak = 0.0f;       // Linear, max since last read
+        float truePeak = 0.0f;   // Linear, max since last read
+        float rms = 0.0f;        // Linear, windowed
+    };
+
+    void prepare(double sampleRate, double rmsWindowSeconds = 0.3)
+    {
+        fs = sampleRate;
+        rmsWindow = rmsWindowSeconds;
+        reset();
+    }
+
+    void reset()
+    {
+        meanSquare = 0.0;
+        peakHold.store(0.0f, std::memory_order_relaxed);
+        truePeakHold.store(0.0f, std::memory_order_relaxed);
+        rmsLevel.store(0.0f, std::memory_order_relaxed);
+    }
+
+    // Audio thread: one call per block with values measured in the existing passes
+    void publish(float blockPeak, float blockTruePeak, double blockSumSquares, int numSamples)
+    {
+        if (numSamples <= 0)
+            return;
+
+        storeMax(peakHold, blockPeak);
+        storeMax(truePeakHold, std::max(blockTruePeak, blockPeak));
+
+        double coeff = std::exp(-numSamples / (rmsWindow * fs));
+        meanSquare = meanSquare * coeff + (blockSumSquares / numSamples) * (1.0 - coeff);
+        rmsLevel.store(static_cast<float>(std::sqrt(meanSquare)), std::memory_order_relaxed);
+    }
+
+    // GUI thread: peak values since the previous read
+    Reading read()
+    {
+        Reading reading;
+        reading.peak = peakHold.exchange(0.0f, std::memory_order_relaxed);
+        reading.truePeak = truePeakHold.exchange(0.0f, std::memory_order_relaxed);
+        reading.rms = rmsLevel.load(std::memory_order_relaxed);
+        return reading;
+    }
+
+    static float toDecibels(float linear, float floorDB = -96.0f)
+    {
+        return (linear > 0.0f) ? std::max(floorDB, 20.0f * std::log10(linear)) : floorDB;
+    }
+
+private:
+    static void storeMax(std::atomic<float>& target, float value)
+    {
+        float current = target.load(std::memory_order_relaxed);
+        while (value > current
+               && !target.compare_exchange_weak(current, value, std::memory_order_relaxed))
+        {
+        }
+    }
+
+    double fs = 48000.0;
+    double rmsWindow = 0.3;
+    double meanSquare = 0.0;   // Audio thread only
+
+    std::atomic<float> peakHold { 0.0f };
+    std::atomic<float> truePeakHold { 0.0f };
+    std::atomic<float> rmsLevel { 0.0f };
+};
+
+// TruePeakInterpolator - 2x true-peak estimate without an oversampled buffer
+//
+// From 88.2kHz up the core runs at the host rate, so there is no upsampled
+// input to take the true peak from. This estimates the sample halfway
+// between each pair of input samples with an 8-tap half-sample FIR
+// (Hann-windowed sinc, unity at DC, flat within 0.1dB to 0.3 x the rate)
+// and returns its magnitude. Meant to be called from a loop that already
+// runs over the samples; the midpoint lags the input by 4 samples.
+class TruePeakInterpolator
+{
+public:
+    static constexpr int NUM_TAPS = 8;
+
+    void reset()
+    {
+        std::fill(std::begin(history), std::end(history), 0.0f);
+    }
+
+    // |midpoint| between the samples 4 and 5 behind x
+    float push(float x)
+    {
+        for (int i = 0; i < NUM_TAPS - 1; ++i)
+            history[i] = history[i + 1];
+        history[NUM_TAPS - 1] = x;
+
+        float midpoint = 0.0f;
+        for (int k = 0; k < NUM_TAPS / 2; ++k)
+            midpoint += coefficients[k] * (history[NUM_TAPS / 2 - 1 - k] + history[NUM_TAPS / 2 + k]);
+        return std::abs(midpoint);
+    }
+
+private:
+    // Nearest tap pair first (offsets +-0.5, +-1.5, +-2.5, +-3.5 samples)
+    static constexpr float coefficients[NUM_TAPS / 2] = { 0.6171309f, -0.1590796f, 0.0525823f, -0.0106336f };
+
+    float history[NUM_TAPS] = {};
+};
+
+} // namespace TapeHysteresis
@@ -7,9 +7,13 @@
 #define M_PI 3.14159265358979323846
 #endif
 
+#include "MachineProfile.h"
+
 namespace TapeHysteresis
 {
 
+class HybridTapeBatch;
+
 // Biquad filter using Audio EQ Cookbook formulas
 struct EQBiquad
 {
@@ -102,6 +106,12 @@ struct FirstOrderFilter
  * Machine-specific EQ curves from Jack Endino's measurements
  * Applied AFTER saturation to capture the total frequency response.
  *
+ * The curves themselves are data (MachineProfile::eq, see MachineProfile.cpp
+ * for the Ampex ATR-102 / Studer A820 targets): a cascade of up to
+ * MAX_STAGES biquads read from a MachineEQCoefficients section. Standalone,
+ * setMachine() selects between the two built-in curves; inside
+ * HybridTapeProcessor the section comes from the active CompiledProfile.
+ *
  * Note: MachineEQ runs at the oversampled rate (2x), so at 48kHz base
  * we have 96kHz sample rate and 48kHz Nyquist - 30kHz bands work correctly.
  */
@@ -111,46 +121,35 @@ public:
     enum class Machine { Ampex, Studer };
 
     MachineEQ();
+    MachineEQ(const MachineEQ&) = delete;
+    MachineEQ& operator=(const MachineEQ&) = delete;
 
     void setSampleRate(double sampleRate);
     void setMachine(Machine machine);
     void reset();
     double processSample(double input);
 
+    // Installs the periodic steady state for `period` repeated forever
+    // (settleBiquad per stage); period is replaced by the steady-state
+    // output. One constant sample = settled at that DC level.
+    void settle(double* period, int numSamples);
+
+    // Use an externally owned section (must outlive this object / the next call)
+    void setCoefficients(const MachineEQCoefficients* section);
+
 private:
+    friend class HybridTapeBatch;
+
     double fs = 48000.0;
     Machine currentMachine = Machine::Ampex;
 
-    // Ampex ATR-102 "Master" EQ
-    // Fine-tuned to match Pro-Q4 reference:
-    // Targets: 20Hz=-2.7dB, 28Hz=0dB, 40Hz=+1.15dB, 70Hz=+0.17dB, 105Hz=+0.3dB, 150Hz=0dB,
-    //          350Hz=-0.5dB, 1200Hz=-0.3dB, 3kHz=-0.45dB, 10kHz=0dB, 16kHz=-0.25dB, 21.5kHz=0dB
-    EQBiquad ampexHP;           // HP filter
-    EQBiquad ampexBell1;        // 28 Hz lift
-    EQBiquad ampexBell2;        // 40 Hz head bump
-    EQBiquad ampexBell3;        // 70 Hz
-    EQBiquad ampexBell4;        // 105 Hz
-    EQBiquad ampexBell5;        // 150 Hz
-    EQBiquad ampexBell6;        // 350 Hz dip
-    EQBiquad ampexBell7;        // 1200 Hz
-    EQBiquad ampexBell8;        // 3000 Hz
-    EQBiquad ampexBell9;        // 10kHz / 16kHz
-    EQBiquad ampexBell10;       // HF lift
-    FirstOrderFilter ampexLP;   // 30000 Hz, 6 dB/oct
-
-    // Studer A820 "Tracks" EQ
-    // Fine-tuned to match Pro-Q4 reference:
-    // Targets: 30Hz=-2dB, 38Hz=0dB, 49.5Hz=+0.55dB, 69.5Hz=+0.1dB, 110Hz=+1.2dB, 260Hz=+0.05dB
-    EQBiquad studerHP1;         // 27 Hz, 12 dB/oct (Q=1.0 for 3rd order Butterworth)
-    FirstOrderFilter studerHP2; // 27 Hz, 6 dB/oct (cascaded = 18 dB/oct total)
-    EQBiquad studerBell1;       // 49.5 Hz, Q 1.5, +0.7 dB (head bump 1)
-    EQBiquad studerBell2;       // 72 Hz, Q 2.07, -1.1 dB (dip)
-    EQBiquad studerBell3;       // 110 Hz, Q 1.0, +1.8 dB (head bump 2)
-    EQBiquad studerBell4;       // 180 Hz, Q 1.0, -0.7 dB
-    EQBiquad studerBell5;       // 600 Hz, Q 0.8, +0.2 dB
-    EQBiquad studerBell6;       // 2000 Hz, Q 1.0, +0.1 dB
-    EQBiquad studerBell7;       // 5000 Hz, Q 1.0, +0.1 dB
-    EQBiquad studerBell8;       // 10000 Hz, Q 1.0, -0.1 dB
+    // Built-in curves for standalone use, compiled at setSampleRate()
+    MachineEQCoefficients builtIn[2];
+    const MachineEQCoefficients* coefficients = &builtIn[0];
+
+    // Filter state, one pair per stage
+    double z1[MachineEQCoefficients::MAX_STAGES] = {};
+    double z2[MachineEQCoefficients::MAX_STAGES] = {};
 
     void updateCoefficients();
 };
@@ -0,0 +1,480 @@
+#include "MachineProfile.h"
+#include "MachineEQ.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+#include <utility>
+#include <vector>
+
+namespace TapeHysteresis
+{
+
+// High shelf filter design (Audio EQ Cookbook)
+static void designHighShelf(BiquadCoefficients& filter, double fc, double gainDB, double Q, double fs)
+{
+    double A = std::pow(10.0, gainDB / 40.0);
+    double omega = 2.0 * M_PI * fc / fs;
+    double cosOmega = std::cos(omega);
+    double sinOmega = std::sin(omega);
+    double alpha = sinOmega / (2.0 * Q);
+
+    double a0 = (A + 1.0) - (A - 1.0) * cosOmega + 2.0 * std::sqrt(A) * alpha;
+    filter.b0 = (A * ((A + 1.0) + (A - 1.0) * cosOmega + 2.0 * std::sqrt(A) * alpha)) / a0;
+    filter.b1 = (-2.0 * A * ((A - 1.0) + (A + 1.0) * cosOmega)) / a0;
+    filter.b2 = (A * ((A + 1.0) + (A - 1.0) * cosOmega - 2.0 * std::sqrt(A) * alpha)) / a0;
+    filter.a1 = (2.0 * ((A - 1.0) - (A + 1.0) * cosOmega)) / a0;
+    filter.a2 = ((A + 1.0) - (A - 1.0) * cosOmega - 2.0 * std::sqrt(A) * alpha) / a0;
+}
+
+//==============================================================================
+// Scalar keys - one table drives parse() and toText()
+
+template <typename Profile>
+static auto scalarFields(Profile& p)
+{
+    using Value = decltype(&p.inputBias);
+    return std::vector<std::pair<const char*, Value>> {
+        { "ja.Ms",                     &p.ja.M_s },
+        { "ja.a",                      &p.ja.a },
+        { "ja.k",                      &p.ja.k },
+        { "ja.c",                      &p.ja.c },
+        { "ja.alpha",                  &p.ja.alpha },
+        { "ja.inputScale",             &p.jaInputScale },
+        { "ja.outputScale",            &p.jaOutputScale },
+        { "ja.blendMax",               &p.jaBlendMax },
+        { "ja.blendThreshold",         &p.jaBlendThreshold },
+        { "ja.blendWidth",             &p.jaBlendWidth },
+        { "atan.mix",                  &p.atanMix },
+        { "atan.threshold",            &p.atanThreshold },
+        { "atan.width",                &p.atanWidth },
+        { "atan.drive",                &p.atanDrive },
+        { "inputBias",                 &p.inputBias },
+        { "hfCut1.freq",               &p.hfCut[0].freq },
+        { "hfCut1.gainDB",             &p.hfCut[0].gainDB },
+        { "hfCut2.freq",               &p.hfCut[1].freq },
+        { "hfCut2.gainDB",             &p.hfCut[1].gainDB },
+        { "selfErasure.threshold",     &p.selfErasureThreshold },
+        { "selfErasure.width",         &p.selfErasureWidth },
+        { "selfErasure.maxCutDB",      &p.selfErasureMaxCutDB },
+        { "selfErasure.freq",          &p.selfErasureFreq },
+        { "dispersive.cornerFreq",     &p.dispersiveCornerFreq },
+        { "azimuth.delayMicroseconds", &p.azimuthDelayMicroseconds },
+    };
+}
+
+static const char* filterTypeName(MachineProfile::FilterType type)
+{
+    switch (type)
+    {
+        case MachineProfile::FilterType::Bell:      return "bell";
+        case MachineProfile::FilterType::HighPass:  return "highpass";
+        case MachineProfile::FilterType::HighPass1: return "highpass1";
+        case MachineProfile::FilterType::LowPass1:  return "lowpass1";
+    }
+    return "bell";
+}
+
+// Shortest decimal that reads back as the same double (fixed point when readable)
+static std::string formatNumber(double value)
+{
+    char buffer[64];
+    bool fixed = (value == 0.0) || (std::abs(value) >= 1e-4 && std::abs(value) < 1e9);
+
+    for (int precision = fixed ? 0 : 1; precision <= 17; ++precision)
+    {
+        std::snprintf(buffer, sizeof(buffer), fixed ? "%.*f" : "%.*g", precision, value);
+        if (std::strtod(buffer, nullptr) == value)
+            return buffer;
+    }
+
+    std::snprintf(buffer, sizeof(buffer), "%.17g", value);
+    return buffer;
+}
+
+static std::string trim(const std::string& text)
+{
+    const char* whitespace = " \t\r\n";
+    size_t first = text.find_first_not_of(whitespace);
+    if (first == std::string::npos)
+        return {};
+    size_t last = text.find_last_not_of(whitespace);
+    return text.substr(first, last - first + 1);
+}
+
+static bool parseNumber(const std::string& text, double& value)
+{
+    if (text.empty())
+        return false;
+    char* end = nullptr;
+    value = std::strtod(text.c_str(), &end);
+    return *end == '\0' && std::isfinite(value);
+}
+
+//==============================================================================
+bool MachineProfile::addEQStage(const EQStage& stage)
+{
+    if (numEQStages >= MachineEQCoefficients::MAX_STAGES)
+        return false;
+    eq[numEQStages++] = stage;
+    return true;
+}
+
+MachineProfile MachineProfile::ampexATR102()
+{
+    // AMPEX ATR-102 (MASTER MODE)
+    // THD targets: -6dB=0.02%, 0dB=0.08%, +6dB=0.40%, MOL(3%)=+12dB
+    // E/O ratio ~0.5 (odd-dominant)
+    MachineProfile p;
+    p.name = "Ampex ATR-102";
+
+    // === LAYER 1: J-A (hysteresis feel) ===
+    p.ja.M_s = 1.0;
+    p.ja.a = 50.0;
+    p.ja.k = 0.005;
+    p.ja.c = 0.96;
+    p.ja.alpha = 2.0e-7;
+    p.jaInputScale = 1.0;
+    p.jaOutputScale = 50.0;
+    p.jaBlendMax = 0.005;           // Very small - tune for -6dB ~0.02%
+    p.jaBlendThreshold = 0.05;
+    p.jaBlendWidth = 0.45;
+
+    // === LAYER 2: Atan (symmetric - bias is global) ===
+    p.atanMix = 0.25;
+    p.atanThreshold = 0.18;
+    p.atanWidth = 2.2;
+    p.atanDrive = 0.6;
+
+    // Global input bias for E/O ~0.5 (odd-dominant)
+    p.inputBias = 0.06;
+
+    // 432 kHz bias: flat to 8kHz, -8dB at 20kHz
+    p.hfCut[0] = { 8000.0, -4.0 };
+    p.hfCut[1] = { 14000.0, -4.0 };
+
+    // Little self-erasure: engages above -6dB, full -2dB cut at +6dB
+    p.selfErasureThreshold = 0.5;
+    p.selfErasureWidth = 1.5;
+    p.selfErasureMaxCutDB = -2.0;
+    p.selfErasureFreq = 12000.0;
+
+    p.dispersiveCornerFreq = 10000.0;
+    p.azimuthDelayMicroseconds = 8.0;
+
+    // Targets from Jack Endino and EMC Published Specs:
+    // 20Hz=-2.7dB, 28Hz=0dB, 40Hz=+1.15dB, 70Hz=+0.17dB, 105Hz=+0.3dB, 150Hz=0dB,
+    // 300Hz=-0.5dB, 1kHz=0dB, 3kHz=-0.45dB, 5kHz=0dB, 10kHz=0dB, 16kHz=-0.25dB
+    p.addEQStage({ FilterType::HighPass, 20.8, 0.7071, 0.0 });   // HP for -2.7dB @ 20Hz
+    p.addEQStage({ FilterType::Bell, 28.0, 2.5, 0.4 });          // 28Hz lift
+    p.addEQStage({ FilterType::Bell, 40.0, 1.8, 0.95 });         // +1.15dB @ 40Hz
+    p.addEQStage({ FilterType::Bell, 70.0, 2.0, -0.3 });         // Cut for +0.17dB @ 70Hz
+    p.addEQStage({ FilterType::Bell, 105.0, 2.0, 0.1 });         // +0.3dB @ 105Hz
+    p.addEQStage({ FilterType::Bell, 150.0, 2.0, -0.2 });        // Cut for 0dB @ 150Hz
+    p.addEQStage({ FilterType::Bell, 300.0, 0.7, -0.8 });        // -0.5dB @ 300Hz
+    p.addEQStage({ FilterType::Bell, 1200.0, 1.5, -0.25 });      // -0.3dB @ 1200Hz
+    p.addEQStage({ FilterType::Bell, 3000.0, 1.0, -0.7 });       // -0.45dB @ 3kHz
+    p.addEQStage({ FilterType::Bell, 7000.0, 1.0, -0.3 });       // Cut 5-10kHz excess
+    p.addEQStage({ FilterType::Bell, 16000.0, 1.5, -0.4 });      // -0.25dB @ 16kHz
+    p.addEQStage({ FilterType::LowPass1, 40000.0, 0.7071, 0.0 });// LP at 40kHz
+    return p;
+}
+
+MachineProfile MachineProfile::studerA820()
+{
+    // STUDER A820 (TRACKS MODE)
+    // THD targets: -6dB=0.07%, 0dB=0.25%, +6dB=1.25%, MOL(3%)=+9dB
+    // E/O ratio ~1.12 (even-dominant)
+    MachineProfile p;
+    p.name = "Studer A820";
+
+    // === LAYER 1: J-A (hysteresis feel) ===
+    p.ja.M_s = 1.0;
+    p.ja.a = 45.0;
+    p.ja.k = 0.008;
+    p.ja.c = 0.92;
+    p.ja.alpha = 5.0e-6;
+    p.jaInputScale = 1.0;
+    p.jaOutputScale = 50.0;
+    p.jaBlendMax = 0.012;           // More than Ampex - tune for -6dB ~0.07%
+    p.jaBlendThreshold = 0.02;
+    p.jaBlendWidth = 0.48;
+
+    // === LAYER 2: Atan (symmetric - bias is global) ===
+    p.atanMix = 0.35;
+    p.atanThreshold = 0.20;
+    p.atanWidth = 1.8;
+    p.atanDrive = 0.95;
+
+    // Larger bias for Studer's even-dominant character
+    p.inputBias = 0.22;
+
+    // 153.6 kHz bias: flat to 6kHz, -12dB at 20kHz
+    p.hfCut[0] = { 6000.0, -6.0 };
+    p.hfCut[1] = { 12000.0, -6.0 };
+
+    // Earlier and deeper HF compression: engages above -9dB, -3.5dB at +6dB
+    p.selfErasureThreshold = 0.35;
+    p.selfErasureWidth = 1.65;
+    p.selfErasureMaxCutDB = -3.5;
+    p.selfErasureFreq = 10000.0;
+
+    p.dispersiveCornerFreq = 2800.0;
+    p.azimuthDelayMicroseconds = 12.0;
+
+    // Targets from Jack Endino and EMC Published Specs:
+    // 20Hz=-5dB, 28Hz=-2.5dB, 40Hz=0dB, 50Hz=+0.55dB, 70Hz=+0.1dB, 110Hz=+1.2dB
+    // 18dB/oct HP tuned to hit both 20Hz and 28Hz targets
+    p.addEQStage({ FilterType::HighPass, 22.0, 1.0, 0.0 });      // 2nd order @ 22Hz
+    p.addEQStage({ FilterType::HighPass1, 22.0, 0.7071, 0.0 });  // 1st order @ 22Hz (total 18 dB/oct)
+    p.addEQStage({ FilterType::Bell, 28.0, 1.0, -2.0 });         // Cut at 28Hz for -2.5dB target
+    p.addEQStage({ FilterType::Bell, 40.0, 2.0, 0.9 });          // Lift at 40Hz to counter HP rolloff
+    p.addEQStage({ FilterType::Bell, 50.0, 1.5, 0.6 });          // First head bump (+0.55dB target)
+    p.addEQStage({ FilterType::Bell, 70.0, 2.5, -0.6 });         // Dip at 70Hz
+    p.addEQStage({ FilterType::Bell, 110.0, 1.0, 1.5 });         // Second head bump (+1.2dB target)
+    p.addEQStage({ FilterType::Bell, 160.0, 1.5, -0.5 });        // Post-bump dip
+    p.addEQStage({ FilterType::Bell, 2000.0, 1.5, 0.05 });       // Subtle 2kHz boost
+    p.addEQStage({ FilterType::Bell, 10000.0, 2.0, -0.1 });      // Slight cut at 10kHz
+    return p;
+}
+
+//==============================================================================
+bool MachineProfile::parse(const std::string& text, MachineProfile& profile, std::string& error)
+{
+    MachineProfile parsed;
+    auto fields = scalarFields(parsed);
+    std::vector<bool> seen(fields.size(), false);
+    bool hasFormat = false;
+
+    std::istringstream stream(text);
+    std::string line;
+    int lineNumber = 0;
+
+    auto fail = [&](const std::string& message)
+    {
+        error = "line " + std::to_string(lineNumber) + ": " + message;
+        return false;
+    };
+
+    while (std::getline(stream, line))
+    {
+        ++lineNumber;
+        line = trim(line.substr(0, line.find('#')));
+        if (line.empty())
+            continue;
+
+        size_t equals = line.find('=');
+        if (equals == std::string::npos)
+            return fail("expected 'key = value'");
+
+        std::string key = trim(line.substr(0, equals));
+        std::string value = trim(line.substr(equals + 1));
+
+        if (key == "format")
+        {
+            double version = 0.0;
+            if (!parseNumber(value, version) || version != FORMAT_VERSION)
+                return fail("unsupported format '" + value + "' (expected " + std::to_string(FORMAT_VERSION) + ")");
+            hasFormat = true;
+        }
+        else if (key == "name")
+        {
+            parsed.name = value;
+        }
+        else if (key == "eq")
+        {
+            std::istringstream words(value);
+            std::string type;
+            words >> type;
+
+            std::vector<double> numbers;
+            std::string word;
+            while (words >> word)
+            {
+                double number = 0.0;
+                if (!parseNumber(word, number))
+                    return fail("bad number '" + word + "'");
+                numbers.push_back(number);
+            }
+
+            EQStage stage;
+            size_t expected = 0;
+            if (type == "bell")           { stage.type = FilterType::Bell;      expected = 3; }
+            else if (type == "highpass")  { stage.type = FilterType::HighPass;  expected = 2; }
+            else if (type == "highpass1") { stage.type = FilterType::HighPass1; expected = 1; }
+            else if (type == "lowpass1")  { stage.type = FilterType::LowPass1;  expected = 1; }
+            else
+                return fail("unknown eq type '" + type + "'");
+
+            if (numbers.size() != expected)
+                return fail("eq " + type + " takes " + std::to_string(expected) + " values");
+
+            stage.freq = numbers[0];
+            if (expected > 1) stage.Q = numbers[1];
+            if (expected > 2) stage.gainDB = numbers[2];
+
+            if (stage.freq <= 0.0 || stage.Q <= 0.0)
+                return fail("eq frequency and Q must be positive");
+            if (!parsed.addEQStage(stage))
+                return fail("more than " + std::to_string(MachineEQCoefficients::MAX_STAGES) + " eq stages");
+        }
+        else
+        {
+            size_t index = 0;
+            while (index < fields.size() && key != fields[index].first)
+                ++index;
+            if (index == fields.size())
+                return fail("unknown key '" + key + "'");
+            if (!parseNumber(value, *fields[index].second))
+                return fail("bad number '" + value + "' for " + key);
+            seen[index] = true;
+        }
+    }
+
+    lineNumber = 0;
+    if (!hasFormat)
+        return fail("missing 'format'");
+    if (parsed.name.empty())
+        return fail("missing 'name'");
+    for (size_t i = 0; i < fields.size(); ++i)
+        if (!seen[i])
+            return fail(std::string("missing '") + fields[i].first + "'");
+
+    if (parsed.ja.a <= 0.0 || parsed.ja.M_s <= 0.0)
+        return fail("ja.a and ja.Ms must be positive");
+    if (parsed.atanWidth <= 0.0 || parsed.selfErasureWidth <= 0.0)
+        return fail("atan.width and selfErasure.width must be positive");
+
+    profile = parsed;
+    return true;
+}
+
+bool MachineProfile::loadFile(const std::string& path, MachineProfile& profile, std::string& error)
+{
+    std::ifstream file(path);
+    if (!file)
+    {
+        error = "cannot open " + path;
+        return false;
+    }
+
+    std::stringstream contents;
+    contents << file.rdbuf();
+    return parse(contents.str(), profile, error);
+}
+
+std::string MachineProfile::toText() const
+{
+    std::string text = "# LOWTHD machine profile\n";
+    text += "format = " + std::to_string(FORMAT_VERSION) + "\n";
+    text += "name = " + name + "\n";
+
+    for (const auto& field : scalarFields(*this))
+        text += std::string(field.first) + " = " + formatNumber(*field.second) + "\n";
+
+    for (int i = 0; i < numEQStages; ++i)
+    {
+        const EQStage& stage = eq[i];
+        text += std::string("eq = ") + filterTypeName(stage.type) + " " + formatNumber(stage.freq);
+        if (stage.type == FilterType::Bell || stage.type == FilterType::HighPass)
+            text += " " + formatNumber(stage.Q);
+        if (stage.type == FilterType::Bell)
+            text += " " + formatNumber(stage.gainDB);
+        text += "\n";
+    }
+
+    return text;
+}
+
+//==============================================================================
+void CompiledProfile::compile(const MachineProfile& profile, double sampleRate, CompiledProfile& compiled)
+{
+    compiled.sampleRate = sampleRate;
+
+    compiled.ja = profile.ja;
+    compiled.jaInputScale = profile.jaInputScale;
+    compiled.jaOutputScale = profile.jaOutputScale;
+    compiled.jaBlendMax = profile.jaBlendMax;
+    compiled.jaBlendThreshold = profile.jaBlendThreshold;
+    compiled.jaBlendWidth = profile.jaBlendWidth;
+    compiled.atanMix = profile.atanMix;
+    compiled.atanThreshold = profile.atanThreshold;
+    compiled.atanWidth = profile.atanWidth;
+    compiled.atanDrive = profile.atanDrive;
+    compiled.inputBias = profile.inputBias;
+
+    compiled.azimuthDelaySamples = profile.azimuthDelayMicroseconds * 1e-6 * sampleRate;
+
+    // Dispersive allpass cascade, corners spaced half an octave apart
+    for (int i = 0; i < NUM_DISPERSIVE_STAGES; ++i)
+    {
+        double freq = std::min(profile.dispersiveCornerFreq * std::pow(2.0, i * 0.5), sampleRate / 2.0 * 0.95);
+        double w0 = 2.0 * M_PI * freq / sampleRate;
+        double tanHalf = std::tan(w0 / 2.0);
+        compiled.allpassCoefficients[i] = (1.0 - tanHalf) / (1.0 + tanHalf);
+    }
+
+    compileHFCut(profile, sampleRate, compiled.hfCut);
+    compileSelfErasure(profile, sampleRate, compiled.selfErasure);
+    compileEQ(profile, sampleRate, compiled.eq);
+}
+
+void CompiledProfile::compileHFCut(const MachineProfile& profile, double sampleRate, HFCutCoefficients& section)
+{
+    double nyquist = sampleRate / 2.0;
+    double shelf1Freq = std::min(profile.hfCut[0].freq, nyquist * 0.9);
+    double shelf2Freq = std::min(profile.hfCut[1].freq, nyquist * 0.85);
+    designHighShelf(section.shelves[0], shelf1Freq, profile.hfCut[0].gainDB, 0.7, sampleRate);
+    designHighShelf(section.shelves[1], shelf2Freq, profile.hfCut[1].gainDB, 0.7, sampleRate);
+}
+
+void CompiledProfile::compileSelfErasure(const MachineProfile& profile, double sampleRate, SelfErasureTable& section)
+{
+    section.threshold = profile.selfErasureThreshold;
+    section.width = profile.selfErasureWidth;
+    section.maxCutDB = profile.selfErasureMaxCutDB;
+
+    double freq = std::min(profile.selfErasureFreq, sampleRate / 2.0 * 0.9);
+
+    for (int i = 0; i < SelfErasureTable::TABLE_SIZE; ++i)
+    {
+        double gainDB = section.maxCutDB * static_cast<double>(i) / (SelfErasureTable::TABLE_SIZE - 1);
+        designHighShelf(section.shelves[i], freq, gainDB, 0.7, sampleRate);
+    }
+}
+
+void CompiledProfile::compileEQ(const MachineProfile& profile, double sampleRate, MachineEQCoefficients& section)
+{
+    section.numStages = profile.numEQStages;
+
+    for (int i = 0; i < profile.numEQStages; ++i)
+    {
+        const MachineProfile::EQStage& stage = profile.eq[i];
+        BiquadCoefficients& target = section.stages[i];
+
+        // Keep corners below Nyquist when run at a base rate (40kHz LP at 48kHz)
+        double freq = std::min(stage.freq, sampleRate / 2.0 * 0.95);
+
+        if (stage.type == MachineProfile::FilterType::Bell || stage.type == MachineProfile::FilterType::HighPass)
+        {
+            EQBiquad biquad;
+            if (stage.type == MachineProfile::FilterType::Bell)
+                biquad.setBell(freq, stage.Q, stage.gainDB, sampleRate);
+            else
+                biquad.setHighPass(freq, stage.Q, sampleRate);
+            target = { biquad.b0, biquad.b1, biquad.b2, biquad.a1, biquad.a2 };
+        }
+        else
+        {
+            FirstOrderFilter filter;
+            if (stage.type == MachineProfile::FilterType::HighPass1)
+                filter.setHighPass(freq, sampleRate);
+            else
+                filter.setLowPass(freq, sampleRate);
+            target = { filter.b0, filter.b1, 0.0, filter.a1, 0.0 };
+        }
+    }
+}
+
+} // namespace TapeHysteresis
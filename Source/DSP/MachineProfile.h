@@ -0,0 +1,224 @@
+#pragma once
+
+#define _USE_MATH_DEFINES
+#include <algorithm>
+#include <cmath>
+#include <string>
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+#include "JilesAthertonCore.h"
+#include "Biquad.h"
+
+namespace TapeHysteresis
+{
+
+// Coefficient sections, one per stage - each stage reads its section through
+// a pointer, so a whole machine switch is a pointer swap.
+struct HFCutCoefficients
+{
+    BiquadCoefficients shelves[2];
+};
+
+struct SelfErasureTable
+{
+    static constexpr int TABLE_SIZE = 33;
+
+    double threshold = 0.5;
+    double width = 1.5;
+    double maxCutDB = -2.0;
+    BiquadCoefficients shelves[TABLE_SIZE];    // maxCutDB * i / (TABLE_SIZE - 1)
+
+    // Shelf depth for an envelope: smoothstep from 0 (flat) to 1 (maxCutDB)
+    double control(double envelope) const
+    {
+        double ratio = std::clamp((envelope - threshold) / width, 0.0, 1.0);
+        return ratio * ratio * (3.0 - 2.0 * ratio);
+    }
+
+    // Shelf at a control value, interpolated between neighbouring entries
+    BiquadCoefficients shelfAt(double control) const
+    {
+        double position = control * (TABLE_SIZE - 1);
+        int index = std::min(static_cast<int>(position), TABLE_SIZE - 2);
+        double frac = position - index;
+
+        const BiquadCoefficients& lo = shelves[index];
+        const BiquadCoefficients& hi = shelves[index + 1];
+        return { lo.b0 + (hi.b0 - lo.b0) * frac, lo.b1 + (hi.b1 - lo.b1) * frac,
+                 lo.b2 + (hi.b2 - lo.b2) * frac, lo.a1 + (hi.a1 - lo.a1) * frac,
+                 lo.a2 + (hi.a2 - lo.a2) * frac };
+    }
+
+    // One sample of the shelf at `control` on the DF2T state z1 / z2.
+    // At control 0 the shelf is flat (0dB, b = a): the input passes and the
+    // state an engaged shelf left behind rings out on its own - no step
+    // where the shelf drops out, nothing stale where it comes back. Below
+    // REST_LEVEL (-240dB) the state is set to rest, which is free to run.
+    static constexpr double REST_LEVEL = 1e-12;
+
+    double process(double control, double input, double& z1, double& z2) const
+    {
+        if (control <= 0.0)
+        {
+            if (z1 == 0.0 && z2 == 0.0)
+                return input;
+
+            const BiquadCoefficients& flat = shelves[0];
+            double output = input + z1;
+            double next = z2 - flat.a1 * z1;
+            z2 = -flat.a2 * z1;
+            z1 = next;
+            if (std::abs(z1) + std::abs(z2) < REST_LEVEL)
+                z1 = z2 = 0.0;
+            return output;
+        }
+
+        const BiquadCoefficients c = shelfAt(control);
+        double output = c.b0 * input + z1;
+        z1 = c.b1 * input - c.a1 * output + z2;
+        z2 = c.b2 * input - c.a2 * output;
+        return output;
+    }
+};
+
+struct MachineEQCoefficients
+{
+    static constexpr int MAX_STAGES = 16;
+
+    int numStages = 0;
+    BiquadCoefficients stages[MAX_STAGES];     // 1st-order stages have b2 = a2 = 0
+};
+
+/**
+ * Machine Profile - every machine constant of the core as data
+ *
+ * Profiles are versioned "key = value" text files (see Profiles/). Built-in
+ * copies of the shipped profiles are compiled in, so the core never needs
+ * the files; they exist to add tape formulations, speeds or machines
+ * without code edits. Rate-independent: compile() turns a profile into a
+ * CompiledProfile for one sample rate.
+ *
+ * File format (version 1):
+ *   format = 1
+ *   name = Ampex ATR-102
+ *   ja.a = 50.0                     (scalar keys, see toText())
+ *   eq = bell 40.0 1.8 0.95         (freq, Q, gain dB)
+ *   eq = highpass 20.8 0.7071       (freq, Q - 2nd order)
+ *   eq = highpass1 22.0             (freq - 1st order)
+ *   eq = lowpass1 40000.0           (freq - 1st order)
+ * Blank lines and '#' comments are ignored; eq stages run in file order.
+ */
+struct MachineProfile
+{
+    static constexpr int FORMAT_VERSION = 1;
+
+    enum class FilterType { Bell, HighPass, HighPass1, LowPass1 };
+
+    struct EQStage
+    {
+        FilterType type = FilterType::Bell;
+        double freq = 1000.0;
+        double Q = 0.7071;
+        double gainDB = 0.0;
+    };
+
+    struct Shelf
+    {
+        double freq = 8000.0;
+        double gainDB = 0.0;
+    };
+
+    std::string name;
+
+    // Layer 1: J-A hysteresis
+    JilesAthertonCore::Parameters ja;
+    double jaInputScale = 1.0;
+    double jaOutputScale = 50.0;
+    double jaBlendMax = 0.0;
+    double jaBlendThreshold = 0.0;
+    double jaBlendWidth = 0.0;
+
+    // Layer 2: symmetric atan
+    double atanMix = 0.0;
+    double atanThreshold = 0.0;
+    double atanWidth = 1.0;
+    double atanDrive = 0.0;
+
+    // Global DC bias (E/O ratio)
+    double inputBias = 0.0;
+
+    // AC bias shielding (two cascaded high shelves, Q 0.7)
+    Shelf hfCut[2];
+
+    // Self-erasure (high shelf, Q 0.7, driven by the saturation envelope)
+    double selfErasureThreshold = 0.5;
+    double selfErasureWidth = 1.5;
+    double selfErasureMaxCutDB = 0.0;
+    double selfErasureFreq = 12000.0;
+
+    // Head geometry
+    double dispersiveCornerFreq = 10000.0;
+    double azimuthDelayMicroseconds = 0.0;
+
+    // Machine EQ (applied after saturation, in order)
+    EQStage eq[MachineEQCoefficients::MAX_STAGES];
+    int numEQStages = 0;
+
+    bool addEQStage(const EQStage& stage);
+
+    // Shipped profiles (identical to Profiles/*.profile)
+    static MachineProfile ampexATR102();
+    static MachineProfile studerA820();
+
+    // Parse / load a profile file. On failure returns false and sets error
+    // ("line N: ..."); the profile is left untouched.
+    static bool parse(const std::string& text, MachineProfile& profile, std::string& error);
+    static bool loadFile(const std::string& path, MachineProfile& profile, std::string& error);
+
+    // Serialize (parse(toText()) reproduces the profile exactly)
+    std::string toText() const;
+};
+
+/**
+ * Compiled Profile - one flat, sample-rate-specific block of everything the
+ * core reads per sample: scalars, allpass coefficients and each stage's
+ * coefficient section. Built at prepare time; never touched by the audio
+ * thread except through const reads.
+ */
+struct CompiledProfile
+{
+    static constexpr int NUM_DISPERSIVE_STAGES = 4;
+
+    double sampleRate = 48000.0;
+
+    JilesAthertonCore::Parameters ja;
+    double jaInputScale = 1.0;
+    double jaOutputScale = 50.0;
+    double jaBlendMax = 0.0;
+    double jaBlendThreshold = 0.0;
+    double jaBlendWidth = 0.0;
+    double atanMix = 0.0;
+    double atanThreshold = 0.0;
+    double atanWidth = 1.0;
+    double atanDrive = 0.0;
+    double inputBias = 0.0;
+
+    double azimuthDelaySamples = 0.0;
+    double allpassCoefficients[NUM_DISPERSIVE_STAGES] = {};
+
+    HFCutCoefficients hfCut;
+    SelfErasureTable selfErasure;
+    MachineEQCoefficients eq;
+
+    static void compile(const MachineProfile& profile, double sampleRate, CompiledProfile& compiled);
+
+    // Per-section compilers (also used by stages running standalone)
+    static void compileHFCut(const MachineProfile& profile, double sampleRate, HFCutCoefficients& section);
+    static void compileSelfErasure(const MachineProfile& profile, double sampleRate, SelfErasureTable& section);
+    static void compileEQ(const MachineProfile& profile, double sampleRate, MachineEQCoefficients& section);
+};
+
+} // namespace TapeHysteresis
@@ -0,0 +1,128 @@
+#include "PrintThrough.h"
+#include "DenormalGuard.h"
+#include <algorithm>
+#include <cmath>
+
+namespace TapeHysteresis
+{
+
+PrintThrough::PrintThrough()
+{
+    setSampleRate(48000.0);
+}
+
+void PrintThrough::setSampleRate(double sampleRate)
+{
+    // Layer spacing truncated to whole samples (3120 at 48kHz)
+    spacing = std::max(1, static_cast<int>(LAYER_SPACING * sampleRate));
+    for (int tap = 0; tap < NUM_TAPS; ++tap)
+    {
+        tapDelay[tap] = spacing * (tap + 1);
+        tapGain[tap] = PRINT_COEFF * std::pow(10.0f, -LAYER_FALLOFF_DB * tap / 20.0f);
+    }
+    if (lookahead > 0)
+        lookahead = NUM_PRE_TAPS * spacing;
+
+    // The block is written before it is read, so the ring holds the
+    // farthest tap behind the longest lookahead plus one block
+    int size = 1;
+    while (size < NUM_PRE_TAPS * spacing + tapDelay[NUM_TAPS - 1] + BLOCK_SIZE)
+        size *= 2;
+
+    ringL.assign(size, 0.0f);
+    ringR.assign(size, 0.0f);
+    dryL.assign(size, 0.0f);
+    dryR.assign(size, 0.0f);
+    mask = size - 1;
+    writeIndex = 0;
+}
+
+void PrintThrough::reset()
+{
+    for (auto* ring : { &ringL, &ringR, &dryL, &dryR })
+        std::fill(ring->begin(), ring->end(), 0.0f);
+    writeIndex = 0;
+}
+
+void PrintThrough::setPreEcho(bool enabled)
+{
+    const int wanted = enabled ? NUM_PRE_TAPS * spacing : 0;
+    if (wanted == lookahead)
+        return;
+
+    lookahead = wanted;
+    reset();
+}
+
+void PrintThrough::processChannel(std::vector<float>& ring, std::vector<float>& dry, float* data, int numSamples,
+                                  bool printing)
+{
+    float* const buffer = ring.data();
+    float* const dryBuffer = dry.data();
+    const int size = mask + 1;
+
+    // Print signal of the dry block into the ring (at most two runs)
+    const int firstWrite = std::min(numSamples, size - writeIndex);
+    auto print = [](float x) { return x * std::max(std::abs(x) - NOISE_FLOOR, 0.0f); };
+    for (int i = 0; i < firstWrite; ++i)
+        buffer[writeIndex + i] = print(data[i]);
+    for (int i = firstWrite; i < numSamples; ++i)
+        buffer[i - firstWrite] = print(data[i]);
+
+    // Pre-echo: the block plays the dry signal from lookahead samples back
+    if (lookahead > 0)
+    {
+        std::copy(data, data + firstWrite, dryBuffer + writeIndex);
+        std::copy(data + firstWrite, data + numSamples, dryBuffer);
+
+        const int start = (writeIndex - lookahead) & mask;
+        const int firstRead = std::min(numSamples, size - start);
+        std::copy(dryBuffer + start, dryBuffer + start + firstRead, data);
+        std::copy(dryBuffer, dryBuffer + (numSamples - firstRead), data + firstRead);
+    }
+
+    if (!printing)
+        return;
+
+    // Gain x the print signal `delay` samples behind the block just written
+    auto addTap = [&](int delay, float gain)
+    {
+        const int start = (writeIndex - delay) & mask;
+        const int firstRead = std::min(numSamples, size - start);
+        const float* source = buffer + start;
+
+        for (int i = 0; i < firstRead; ++i)
+            data[i] += gain * source[i];
+        for (int i = firstRead; i < numSamples; ++i)
+            data[i] += gain * buffer[i - firstRead];
+    };
+
+    // Each layer behind: one to NUM_TAPS spacings behind the played signal
+    for (int tap = 0; tap < NUM_TAPS; ++tap)
+        addTap(lookahead + tapDelay[tap], tapGain[tap]);
+
+    // Each layer ahead, within the lookahead
+    if (lookahead > 0)
+        for (int tap = 0; tap < NUM_PRE_TAPS; ++tap)
+            addTap(lookahead - tapDelay[tap], tapGain[tap]);
+}
+
+void PrintThrough::process(float* left, float* right, int numSamples, bool printing)
+{
+    DenormalGuard denormalGuard;
+    int offset = 0;
+
+    while (offset < numSamples)
+    {
+        const int n = std::min(BLOCK_SIZE, numSamples - offset);
+
+        processChannel(ringL, dryL, left + offset, n, printing);
+        if (right != nullptr)
+            processChannel(ringR, dryR, right + offset, n, printing);
+
+        writeIndex = (writeIndex + n) & mask;
+        offset += n;
+    }
+}
+
+} // namespace TapeHysteresis
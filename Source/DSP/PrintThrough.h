@@ -0,0 +1,84 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+namespace TapeHysteresis
+{
+
+// PrintThrough - Multi-layer magnetic print-through (Studer mode)
+//
+// Stored tape magnetizes its neighbouring layers: a loud passage bleeds
+// into the layers wound around it, one layer spacing (65ms at 30 IPS) per
+// turn. Each layer further away prints weaker (LAYER_FALLOFF_DB per layer).
+// The stage sums NUM_TAPS echoes at 1x .. NUM_TAPS x the spacing.
+//
+// Pre-echo (the outer layers, printed ahead of the signal) needs the input
+// one spacing early. With setPreEcho(true) the stage delays its dry signal
+// by NUM_PRE_TAPS spacings (getLatencySamples) and adds NUM_PRE_TAPS echoes
+// that far ahead of it, at the same gains as the layers behind. The plugin
+// turns it on in background mode, where the latency is reported anyway.
+//
+// Level dependence: the printed field grows with the recorded level, so
+// each sample prints x * PRINT_COEFF * max(|x| - NOISE_FLOOR, 0). That is
+// -58dB at 0dBFS (GP9) and nothing under -60dB, with a soft knee and no
+// branch. The curve is memoryless, so it is applied once per sample as the
+// sample enters the ring. The taps are then plain gains on delayed reads.
+//
+// One print ring per channel (power-of-two length, masked indices) serves
+// every tap, plus a dry ring of the same length for the delayed signal.
+// Processing is in blocks of BLOCK_SIZE: the block is written first, then
+// each tap adds its gain times one or two contiguous runs of the ring.
+// There are no per-sample index wraps or branches, so the loops vectorize.
+class PrintThrough
+{
+public:
+    static constexpr int NUM_TAPS = 4;
+    static constexpr int NUM_PRE_TAPS = 1;              // With setPreEcho(true)
+    static constexpr int BLOCK_SIZE = 256;
+    static constexpr double LAYER_SPACING = 0.065;      // Seconds per layer, 30 IPS
+    static constexpr float PRINT_COEFF = 0.00126f;      // -58dB at unity, first layer (GP9 spec)
+    static constexpr float NOISE_FLOOR = 0.001f;        // -60dB: quieter material prints nothing
+    static constexpr float LAYER_FALLOFF_DB = 8.0f;     // Each further layer
+
+    PrintThrough();
+
+    // Allocates - call from prepare
+    void setSampleRate(double sampleRate);
+    void reset();
+
+    // Pre-echo on/off (resets when it changes). Not while processing.
+    void setPreEcho(bool enabled);
+    bool getPreEcho() const { return lookahead > 0; }
+
+    // Delay of the dry signal: NUM_PRE_TAPS spacings with pre-echo, else 0
+    int getLatencySamples() const { return lookahead; }
+
+    // Processes in place. right may be nullptr for mono. printing = false
+    // only delays (same latency, no echoes) - the rings stay current.
+    void process(float* left, float* right, int numSamples, bool printing = true);
+
+    // Tap delays (samples) and gains, nearest layer first
+    int getTapDelay(int tap) const { return tapDelay[tap]; }
+    float getTapGain(int tap) const { return tapGain[tap]; }
+
+    size_t getBufferBytes() const
+    {
+        return sizeof(float) * (ringL.size() + ringR.size() + dryL.size() + dryR.size());
+    }
+
+private:
+    void processChannel(std::vector<float>& ring, std::vector<float>& dry, float* data, int numSamples, bool printing);
+
+    std::vector<float> ringL, ringR;
+    std::vector<float> dryL, dryR;
+    int mask = 0;
+    int writeIndex = 0;
+    int spacing = 1;
+    int lookahead = 0;
+
+    int tapDelay[NUM_TAPS] = {};
+    float tapGain[NUM_TAPS] = {};
+};
+
+} // namespace TapeHysteresis
@@ -0,0 +1,499 @@
+#include "RenderCache.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <random>
+
+namespace TapeHysteresis
+{
+
+namespace
+{
+
+constexpr char MAGIC[4] = { 'L', 'T', 'R', 'C' };
+constexpr size_t HEADER_BYTES = 60;
+constexpr size_t CHECKED_HEADER_BYTES = 52;     // Everything before the checksum
+constexpr uint64_t MAX_PACKBITS_EXPANSION = 128;
+constexpr size_t READ_CHUNK_BYTES = 1 << 16;
+constexpr uint32_t MAX_CHANNELS = 64;
+const char* const ENTRY_EXTENSION = ".lrc";
+const char* const TEMP_MARKER = ".tmp-";
+
+inline uint64_t rotl(uint64_t x, int r)
+{
+    return (x << r) | (x >> (64 - r));
+}
+
+// MurmurHash3 finalizer
+inline uint64_t fmix64(uint64_t k)
+{
+    k ^= k >> 33;
+    k *= 0xff51afd7ed558ccdULL;
+    k ^= k >> 33;
+    k *= 0xc4ceb9fe1a85ec53ULL;
+    k ^= k >> 33;
+    return k;
+}
+
+void appendLE(std::vector<unsigned char>& out, uint64_t value, int bytes)
+{
+    for (int i = 0; i < bytes; ++i)
+        out.push_back(static_cast<unsigned char>((value >> (8 * i)) & 0xFF));
+}
+
+uint64_t readLE(const unsigned char* p, int bytes)
+{
+    uint64_t value = 0;
+    for (int i = 0; i < bytes; ++i)
+        value |= static_cast<uint64_t>(p[i]) << (8 * i);
+    return value;
+}
+
+uint64_t doubleBits(double value)
+{
+    uint64_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    return bits;
+}
+
+// PackBits: control c < 128 -> c + 1 literal bytes follow,
+//           c > 128 -> the next byte repeats 257 - c times (3..128)
+void packBits(const std::vector<unsigned char>& in, std::vector<unsigned char>& out)
+{
+    const size_t n = in.size();
+    size_t i = 0;
+
+    auto runLength = [&](size_t at) {
+        size_t run = 1;
+        while (at + run < n && run < 128 && in[at + run] == in[at])
+            ++run;
+        return run;
+    };
+
+    while (i < n)
+    {
+        const size_t run = runLength(i);
+        if (run >= 3)
+        {
+            out.push_back(static_cast<unsigned char>(257 - run));
+            out.push_back(in[i]);
+            i += run;
+            continue;
+        }
+
+        const size_t start = i;
+        while (i < n && i - start < 128 && runLength(i) < 3)
+            ++i;
+
+        out.push_back(static_cast<unsigned char>(i - start - 1));
+        out.insert(out.end(), in.begin() + static_cast<std::ptrdiff_t>(start), in.begin() + static_cast<std::ptrdiff_t>(i));
+    }
+}
+
+// False on any malformed control sequence or size mismatch
+bool unpackBits(const std::vector<unsigned char>& in, std::vector<unsigned char>& out, size_t expectedSize)
+{
+    out.clear();
+    out.reserve(expectedSize);
+
+    for (size_t i = 0; i < in.size();)
+    {
+        const unsigned char control = in[i++];
+        if (control < 128)
+        {
+            const size_t count = static_cast<size_t>(control) + 1;
+            if (i + count > in.size() || out.size() + count > expectedSize)
+                return false;
+            out.insert(out.end(), in.begin() + static_cast<std::ptrdiff_t>(i), in.begin() + static_cast<std::ptrdiff_t>(i + count));
+            i += count;
+        }
+        else if (control > 128)
+        {
+            const size_t count = 257 - static_cast<size_t>(control);
+            if (i >= in.size() || out.size() + count > expectedSize)
+                return false;
+            out.insert(out.end(), count, in[i++]);
+        }
+    }
+
+    return out.size() == expectedSize;
+}
+
+// Float bits XOR previous, split into byte planes (most significant first)
+std::vector<unsigned char> encodePayload(const RenderCache::Audio& audio, size_t numFrames)
+{
+    std::vector<unsigned char> planes(audio.channels.size() * numFrames * 4);
+
+    for (size_t ch = 0; ch < audio.channels.size(); ++ch)
+    {
+        unsigned char* channelPlanes = planes.data() + ch * numFrames * 4;
+        uint32_t previous = 0;
+
+        for (size_t i = 0; i < numFrames; ++i)
+        {
+            uint32_t bits;
+            std::memcpy(&bits, &audio.channels[ch][i], sizeof(bits));
+            const uint32_t delta = bits ^ previous;
+            previous = bits;
+
+            for (int b = 0; b < 4; ++b)
+                channelPlanes[static_cast<size_t>(b) * numFrames + i] = static_cast<unsigned char>(delta >> (24 - 8 * b));
+        }
+    }
+
+    std::vector<unsigned char> payload;
+    payload.reserve(planes.size() / 2);
+    packBits(planes, payload);
+    return payload;
+}
+
+bool decodePayload(const std::vector<unsigned char>& payload, uint32_t numChannels, size_t numFrames,
+                   RenderCache::Audio& audio)
+{
+    std::vector<unsigned char> planes;
+    if (!unpackBits(payload, planes, static_cast<size_t>(numChannels) * numFrames * 4))
+        return false;
+
+    audio.channels.assign(numChannels, std::vector<float>(numFrames));
+
+    for (size_t ch = 0; ch < numChannels; ++ch)
+    {
+        const unsigned char* channelPlanes = planes.data() + ch * numFrames * 4;
+        uint32_t previous = 0;
+
+        for (size_t i = 0; i < numFrames; ++i)
+        {
+            uint32_t delta = 0;
+            for (int b = 0; b < 4; ++b)
+                delta |= static_cast<uint32_t>(channelPlanes[static_cast<size_t>(b) * numFrames + i]) << (24 - 8 * b);
+
+            const uint32_t bits = delta ^ previous;
+            previous = bits;
+            std::memcpy(&audio.channels[ch][i], &bits, sizeof(bits));
+        }
+    }
+
+    return true;
+}
+
+} // namespace
+
+//==============================================================================
+RenderCache::KeyBuilder::KeyBuilder()
+    : laneA(0x9E3779B97F4A7C15ULL), laneB(0xC2B2AE3D27D4EB4FULL)
+{
+}
+
+void RenderCache::KeyBuilder::addWord(uint64_t word)
+{
+    // MurmurHash3 x64-128 style block mix
+    const uint64_t c1 = 0x87c37b91114253d5ULL;
+    const uint64_t c2 = 0x4cf5ad432745937fULL;
+
+    laneA ^= rotl(word * c1, 31) * c2;
+    laneA = rotl(laneA, 27) + laneB;
+    laneA = laneA * 5 + 0x52dce729;
+
+    laneB ^= rotl(word * c2, 33) * c1;
+    laneB = rotl(laneB, 31) + laneA;
+    laneB = laneB * 5 + 0x38495ab5;
+}
+
+void RenderCache::KeyBuilder::addBytes(const void* data, size_t size)
+{
+    const unsigned char* bytes = static_cast<const unsigned char*>(data);
+    totalBytes += size;
+
+    while (size > 0 && numPending > 0)
+    {
+        pending[numPending++] = *bytes++;
+        --size;
+        if (numPending == 8)
+        {
+            addWord(readLE(pending, 8));
+            numPending = 0;
+        }
+    }
+
+    for (; size >= 8; size -= 8, bytes += 8)
+        addWord(readLE(bytes, 8));
+
+    while (size-- > 0)
+        pending[numPending++] = *bytes++;
+}
+
+RenderCache::KeyBuilder& RenderCache::KeyBuilder::add(const std::string& text)
+{
+    const uint64_t header[2] = { 1, text.size() };
+    addBytes(header, sizeof(header));
+    addBytes(text.data(), text.size());
+    return *this;
+}
+
+RenderCache::KeyBuilder& RenderCache::KeyBuilder::add(double value)
+{
+    const uint64_t field[2] = { 2, doubleBits(value) };
+    addBytes(field, sizeof(field));
+    return *this;
+}
+
+RenderCache::KeyBuilder& RenderCache::KeyBuilder::add(uint64_t value)
+{
+    const uint64_t field[2] = { 3, value };
+    addBytes(field, sizeof(field));
+    return *this;
+}
+
+RenderCache::KeyBuilder& RenderCache::KeyBuilder::add(const float* samples, size_t numSamples)
+{
+    const uint64_t header[2] = { 4, numSamples };
+    addBytes(header, sizeof(header));
+    addBytes(samples, numSamples * sizeof(float));
+    return *this;
+}
+
+RenderCache::Key RenderCache::KeyBuilder::finish() const
+{
+    KeyBuilder state = *this;
+
+    if (state.numPending > 0)
+    {
+        std::memset(state.pending + state.numPending, 0, static_cast<size_t>(8 - state.numPending));
+        state.addWord(readLE(state.pending, 8));
+    }
+
+    uint64_t a = state.laneA ^ totalBytes;
+    uint64_t b = state.laneB ^ totalBytes;
+    a += b;
+    b += a;
+    a = fmix64(a);
+    b = fmix64(b);
+    a += b;
+    b += a;
+
+    return { a, b };
+}
+
+std::string RenderCache::Key::toHex() const
+{
+    static const char digits[] = "0123456789abcdef";
+    std::string hex(32, '0');
+    for (int i = 0; i < 16; ++i)
+    {
+        hex[static_cast<size_t>(15 - i)] = digits[(high >> (4 * i)) & 0xF];
+        hex[static_cast<size_t>(31 - i)] = digits[(low >> (4 * i)) & 0xF];
+    }
+    return hex;
+}
+
+//==============================================================================
+RenderCache::RenderCache(const std::filesystem::path& directoryToUse, uint64_t maxBytesToUse)
+    : directory(directoryToUse), maxBytes(maxBytesToUse)
+{
+}
+
+std::filesystem::path RenderCache::getEntryPath(const Key& key) const
+{
+    return directory / (key.toHex() + ENTRY_EXTENSION);
+}
+
+bool RenderCache::lookup(const Key& key, Audio& audio)
+{
+    const std::filesystem::path path = getEntryPath(key);
+    std::ifstream file(path, std::ios::binary);
+    if (!file)
+        return false;
+
+    auto reject = [&] {
+        file.close();
+        std::error_code ignored;
+        std::filesystem::remove(path, ignored);
+        return false;
+    };
+
+    unsigned char header[HEADER_BYTES];
+    if (!file.read(reinterpret_cast<char*>(header), HEADER_BYTES) || std::memcmp(header, MAGIC, 4) != 0
+        || readLE(header + 4, 4) != FORMAT_VERSION)
+        return reject();
+
+    const Key stored = { readLE(header + 8, 8), readLE(header + 16, 8) };
+    const uint64_t rateBits = readLE(header + 24, 8);
+    const uint32_t numChannels = static_cast<uint32_t>(readLE(header + 32, 4));
+    const uint64_t numFrames = readLE(header + 36, 8);
+    const uint64_t payloadBytes = readLE(header + 44, 8);
+    const uint64_t checksum = readLE(header + 52, 8);
+
+    std::error_code sizeError;
+    const uint64_t fileBytes = std::filesystem::file_size(path, sizeError);
+    if (!(stored == key) || numChannels == 0 || numChannels > MAX_CHANNELS || sizeError
+        || payloadBytes != fileBytes - HEADER_BYTES || numFrames > (uint64_t(1) << 40)
+        || numChannels * numFrames * 4 > payloadBytes * MAX_PACKBITS_EXPANSION)
+        return reject();
+
+    // Verify the header and the payload while streaming it in - no second pass
+    std::vector<unsigned char> payload(static_cast<size_t>(payloadBytes));
+    KeyBuilder verifier;
+    verifier.addBytes(header, CHECKED_HEADER_BYTES);
+
+    for (size_t offset = 0; offset < payload.size(); offset += READ_CHUNK_BYTES)
+    {
+        const size_t count = std::min(READ_CHUNK_BYTES, payload.size() - offset);
+        if (!file.read(reinterpret_cast<char*>(payload.data() + offset), static_cast<std::streamsize>(count)))
+            return reject();
+        verifier.addBytes(payload.data() + offset, count);
+    }
+
+    if (verifier.finish().low != checksum)
+        return reject();
+
+    Audio decoded;
+    std::memcpy(&decoded.sampleRate, &rateBits, sizeof(rateBits));
+    if (!decodePayload(payload, numChannels, static_cast<size_t>(numFrames), decoded))
+        return reject();
+
+    audio = std::move(decoded);
+
+    // Mark as recently used for eviction
+    std::error_code ignored;
+    std::filesystem::last_write_time(path, std::filesystem::file_time_type::clock::now(), ignored);
+    return true;
+}
+
+bool RenderCache::store(const Key& key, const Audio& audio)
+{
+    if (audio.channels.empty() || audio.channels.size() > MAX_CHANNELS)
+        return false;
+
+    const size_t numFrames = audio.channels[0].size();
+    for (const auto& channel : audio.channels)
+        if (channel.size() != numFrames)
+            return false;
+
+    std::error_code error;
+    std::filesystem::create_directories(directory, error);
+
+    const std::vector<unsigned char> payload = encodePayload(audio, numFrames);
+
+    std::vector<unsigned char> header;
+    header.insert(header.end(), MAGIC, MAGIC + 4);
+    appendLE(header, FORMAT_VERSION, 4);
+    appendLE(header, key.high, 8);
+    appendLE(header, key.low, 8);
+    appendLE(header, doubleBits(audio.sampleRate), 8);
+    appendLE(header, audio.channels.size(), 4);
+    appendLE(header, numFrames, 8);
+    appendLE(header, payload.size(), 8);
+
+    KeyBuilder checksum;
+    checksum.addBytes(header.data(), header.size());
+    checksum.addBytes(payload.data(), payload.size());
+    appendLE(header, checksum.finish().low, 8);
+
+    // Unique temp name in the same directory, then an atomic rename
+    std::random_device random;
+    const uint64_t suffix = (static_cast<uint64_t>(random()) << 32) ^ random();
+    const std::filesystem::path temp = directory / (key.toHex() + TEMP_MARKER + Key { 0, suffix }.toHex().substr(16));
+
+    {
+        std::ofstream file(temp, std::ios::binary | std::ios::trunc);
+        file.write(reinterpret_cast<const char*>(header.data()), static_cast<std::streamsize>(header.size()));
+        file.write(reinterpret_cast<const char*>(payload.data()), static_cast<std::streamsize>(payload.size()));
+        file.close();
+
+        if (!file)
+        {
+            std::filesystem::remove(temp, error);
+            return false;
+        }
+    }
+
+    std::filesystem::rename(temp, getEntryPath(key), error);
+    if (error)
+    {
+        std::error_code ignored;
+        std::filesystem::remove(temp, ignored);
+        return false;
+    }
+
+    evict();
+    return true;
+}
+
+//==============================================================================
+uint64_t RenderCache::getSizeBytes() const
+{
+    uint64_t total = 0;
+    std::error_code error;
+
+    for (std::filesystem::directory_iterator it(directory, error), end; !error && it != end; it.increment(error))
+    {
+        std::error_code entryError;
+        if (it->path().extension() == ENTRY_EXTENSION && it->is_regular_file(entryError))
+            total += it->file_size(entryError);
+    }
+
+    return total;
+}
+
+void RenderCache::evict()
+{
+    struct Entry
+    {
+        std::filesystem::path path;
+        uint64_t bytes;
+        std::filesystem::file_time_type lastUsed;
+    };
+
+    std::vector<Entry> entries;
+    uint64_t total = 0;
+    const auto now = std::filesystem::file_time_type::clock::now();
+    std::error_code error;
+
+    // Entries can vanish under us (other processes evicting) - skip, don't fail
+    for (std::filesystem::directory_iterator it(directory, error), end; !error && it != end; it.increment(error))
+    {
+        std::error_code entryError;
+        if (!it->is_regular_file(entryError))
+            continue;
+
+        const std::filesystem::path path = it->path();
+        const auto lastUsed = it->last_write_time(entryError);
+        if (entryError)
+            continue;
+
+        if (path.filename().string().find(TEMP_MARKER) != std::string::npos)
+        {
+            // Abandoned by a writer that crashed before its rename
+            if (now - lastUsed > std::chrono::hours(1))
+                std::filesystem::remove(path, entryError);
+        }
+        else if (path.extension() == ENTRY_EXTENSION)
+        {
+            const uint64_t bytes = it->file_size(entryError);
+            if (!entryError)
+            {
+                entries.push_back({ path, bytes, lastUsed });
+                total += bytes;
+            }
+        }
+    }
+
+    if (total <= maxBytes)
+        return;
+
+    std::sort(entries.begin(), entries.end(), [](const Entry& a, const Entry& b) { return a.lastUsed < b.lastUsed; });
+
+    for (const Entry& entry : entries)
+    {
+        if (total <= maxBytes)
+            break;
+
+        std::error_code ignored;
+        std::filesystem::remove(entry.path, ignored);
+        total -= entry.bytes;
+    }
+}
+
+} // namespace TapeHysteresis
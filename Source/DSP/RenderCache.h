@@ -0,0 +1,105 @@
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+namespace TapeHysteresis
+{
+
+/**
+ * Render Cache - content-addressed on-disk cache of rendered audio
+ *
+ * Re-bounces mostly push identical stems through identical settings. A
+ * render is keyed by a 128-bit hash of everything that determines it - input
+ * samples, sample rate, parameters, profile text, ENGINE_VERSION and random
+ * seeds (see KeyBuilder) - and its output stored as <key>.lrc in the cache
+ * directory:
+ *
+ *   header   "LTRC", format, key, sample rate, channels, frames,
+ *            payload size, checksum of the header fields and payload
+ *   payload  per channel: float bits XOR the previous sample's, split into
+ *            4 byte planes (sign/exponent plane first), PackBits run-length
+ *            coded - lossless, and silence / quiet stems shrink to almost
+ *            nothing
+ *
+ * Lookups verify the checksum while streaming the payload in, and reject
+ * sizes PackBits can't produce before decoding; a damaged entry is deleted
+ * and reported as a miss. Entries are published by writing
+ * a temp file and renaming it over <key>.lrc, so concurrent writers (several
+ * render processes sharing one directory) never expose a partial file; the
+ * last rename wins, and both wrote identical bytes. Hits refresh the file's
+ * modification time, and store() evicts least recently used entries until
+ * the directory is under maxBytes.
+ *
+ * The hash is not cryptographic - the cache trusts whoever can write to it.
+ */
+class RenderCache
+{
+public:
+    static constexpr uint32_t FORMAT_VERSION = 2;    // 2: checksum covers the header
+
+    struct Key
+    {
+        uint64_t high = 0;
+        uint64_t low = 0;
+
+        std::string toHex() const;
+        bool operator==(const Key& other) const { return high == other.high && low == other.low; }
+    };
+
+    // Streaming 128-bit hash. Every field is length/type prefixed, so
+    // ("ab", "c") and ("a", "bc") differ.
+    class KeyBuilder
+    {
+    public:
+        KeyBuilder();
+
+        KeyBuilder& add(const std::string& text);
+        KeyBuilder& add(double value);
+        KeyBuilder& add(uint64_t value);
+        KeyBuilder& add(const float* samples, size_t numSamples);
+
+        Key finish() const;
+
+    private:
+        friend class RenderCache;
+        void addBytes(const void* data, size_t size);
+        void addWord(uint64_t word);
+
+        uint64_t laneA, laneB;
+        uint64_t totalBytes = 0;
+        unsigned char pending[8] = {};
+        int numPending = 0;
+    };
+
+    struct Audio
+    {
+        double sampleRate = 0.0;
+        std::vector<std::vector<float>> channels;
+    };
+
+    RenderCache(const std::filesystem::path& directory, uint64_t maxBytes);
+
+    // True on a verified hit (audio filled, entry marked recently used)
+    bool lookup(const Key& key, Audio& audio);
+
+    // Publishes atomically, then evicts down to maxBytes
+    bool store(const Key& key, const Audio& audio);
+
+    // Total size of the published entries
+    uint64_t getSizeBytes() const;
+
+    // Removes least recently used entries until under maxBytes, plus temp
+    // files abandoned by crashed writers
+    void evict();
+
+    std::filesystem::path getEntryPath(const Key& key) const;
+
+private:
+    std::filesystem::path directory;
+    uint64_t maxBytes;
+};
+
+} // namespace TapeHysteresis
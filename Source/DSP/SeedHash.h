@@ -0,0 +1,21 @@
+#pragma once
+
+#include <cstdint>
+
+namespace TapeHysteresis
+{
+
+// Integer hash (lowbias32) for per-instance seeds. Spreads consecutive
+// seeds across generator states; never returns 0, so the result can seed
+// an xorshift directly.
+inline uint32_t hashSeed(uint32_t x)
+{
+    x ^= x >> 16;
+    x *= 0x7feb352dU;
+    x ^= x >> 15;
+    x *= 0x846ca68bU;
+    x ^= x >> 16;
+    return (x != 0) ? x : 0x6d2b79f5U;
+}
+
+} // namespace TapeHysteresis
@@ -0,0 +1,208 @@
+#include "TapeHiss.h"
+#include "DenormalGuard.h"
+#include "SeedHash.h"
+#include <algorithm>
+#include <iterator>
+
+namespace TapeHysteresis
+{
+
+TapeHiss::TapeHiss(uint32_t seed)
+{
+    setSeed(seed);
+    updateCoefficients();
+}
+
+void TapeHiss::setSeed(uint32_t seed)
+{
+    baseSeed = seed;
+    reset();
+}
+
+void TapeHiss::setSampleRate(double sampleRate)
+{
+    fs = sampleRate;
+    updateCoefficients();
+}
+
+void TapeHiss::setMachineMode(bool isAmpex)
+{
+    if (ampexMode != isAmpex)
+    {
+        ampexMode = isAmpex;
+        updateCoefficients();
+    }
+}
+
+void TapeHiss::setBreathing(double amount)
+{
+    breathing = std::clamp(amount, 0.0, 1.0);
+}
+
+void TapeHiss::reset()
+{
+    // Same seed -> same noise after reset (deterministic renders)
+    seedChannel(channelL, baseSeed);
+    seedChannel(channelR, baseSeed ^ 0xa5a5a5a5U);
+    envelope = 0.0f;
+    currentGain = static_cast<float>(noiseRMS);
+}
+
+void TapeHiss::seedChannel(Channel& ch, uint32_t seed)
+{
+    for (int lane = 0; lane < NUM_LANES; ++lane)
+        ch.lanes[lane] = hashSeed(seed + 0x9e3779b9U * static_cast<uint32_t>(lane + 1));
+
+    std::fill(std::begin(ch.white), std::end(ch.white), 0.0f);
+    ch.numAhead = 0;
+}
+
+void TapeHiss::updateCoefficients()
+{
+    // Published 30 IPS S/N (unweighted, re operating level) and hiss tilt
+    double snrDB, tiltFreq, tiltDB;
+
+    if (ampexMode)
+    {
+        // AMPEX ATR-102: 1/2" 2-track, wide tracks = low noise
+        snrDB = 78.0;
+        tiltFreq = 6000.0;
+        tiltDB = 2.0;
+    }
+    else
+    {
+        // STUDER A820: 2" 24-track, narrow tracks = ~8dB more hiss
+        snrDB = 70.0;
+        tiltFreq = 4000.0;
+        tiltDB = 3.0;
+    }
+
+    noiseRMS = std::pow(10.0, -snrDB / 20.0);
+
+    // Shaping prototype: RBJ high shelf (tilt) + 1st order LP (head gap loss).
+    // Both are minimum phase, so their truncated impulse response is a
+    // short minimum-phase FIR with the energy packed into the first taps.
+    double A = std::pow(10.0, tiltDB / 40.0);
+    double omega = 2.0 * M_PI * std::min(tiltFreq, fs * 0.4) / fs;
+    double cosOmega = std::cos(omega);
+    double alpha = std::sin(omega) / (2.0 * 0.7);
+
+    double a0 = (A + 1.0) - (A - 1.0) * cosOmega + 2.0 * std::sqrt(A) * alpha;
+    double b0 = (A * ((A + 1.0) + (A - 1.0) * cosOmega + 2.0 * std::sqrt(A) * alpha)) / a0;
+    double b1 = (-2.0 * A * ((A - 1.0) + (A + 1.0) * cosOmega)) / a0;
+    double b2 = (A * ((A + 1.0) + (A - 1.0) * cosOmega - 2.0 * std::sqrt(A) * alpha)) / a0;
+    double a1 = (2.0 * ((A - 1.0) - (A + 1.0) * cosOmega)) / a0;
+    double a2 = ((A + 1.0) - (A - 1.0) * cosOmega - 2.0 * std::sqrt(A) * alpha) / a0;
+
+    double K = std::tan(M_PI * std::min(20000.0, fs * 0.45) / fs);
+    double lpB = K / (1.0 + K);
+    double lpA = (K - 1.0) / (1.0 + K);
+
+    double impulse[FIR_LENGTH];
+    double z1 = 0.0, z2 = 0.0, lpZ = 0.0;
+    double energy = 0.0;
+
+    for (int n = 0; n < FIR_LENGTH; ++n)
+    {
+        double x = (n == 0) ? 1.0 : 0.0;
+        double y = b0 * x + z1;
+        z1 = b1 * x - a1 * y + z2;
+        z2 = b2 * x - a2 * y;
+
+        double out = lpB * y + lpZ;
+        lpZ = lpB * y - lpA * out;
+
+        impulse[n] = out;
+        energy += out * out;
+    }
+
+    // Unit output variance for unit-variance white input. The generator is
+    // uniform in [-1, 1) (variance 1/3), hence the sqrt(3).
+    double norm = std::sqrt(3.0 / energy);
+
+    for (int n = 0; n < FIR_LENGTH; ++n)
+        fir[n] = static_cast<float>(impulse[FIR_LENGTH - 1 - n] * norm);
+
+    currentGain = static_cast<float>(noiseRMS);
+}
+
+void TapeHiss::renderBlock(Channel& ch, float* out, int numSamples, float gainStart, float gainStep)
+{
+    constexpr int HISTORY = FIR_LENGTH - 1;
+    float* fresh = ch.white + HISTORY;
+
+    // Lane-parallel xorshift32 - each lane is an independent generator.
+    // Whole steps only: what this block doesn't use is kept for the next.
+    int base = ch.numAhead;
+    for (; base < numSamples; base += NUM_LANES)
+    {
+        for (int lane = 0; lane < NUM_LANES; ++lane)
+        {
+            uint32_t x = ch.lanes[lane];
+            x ^= x << 13;
+            x ^= x >> 17;
+            x ^= x << 5;
+            ch.lanes[lane] = x;
+            fresh[base + lane] = static_cast<float>(static_cast<int32_t>(x)) * 4.656612873e-10f;
+        }
+    }
+
+    // Minimum-phase shaping FIR - tap-outer loop so the inner loop runs
+    // across samples (vectorizes without reassociating the sum)
+    float shaped[BLOCK_SIZE] = {0};
+    for (int k = 0; k < FIR_LENGTH; ++k)
+    {
+        const float tap = fir[k];
+        const float* src = ch.white + k;
+        for (int i = 0; i < numSamples; ++i)
+            shaped[i] += tap * src[i];
+    }
+
+    for (int i = 0; i < numSamples; ++i)
+        out[i] += shaped[i] * (gainStart + gainStep * static_cast<float>(i));
+
+    // Keep the last FIR_LENGTH - 1 white samples and the unused ones
+    ch.numAhead = base - numSamples;
+    std::copy(ch.white + numSamples, ch.white + numSamples + HISTORY + ch.numAhead, ch.white);
+}
+
+void TapeHiss::process(float* left, float* right, int numSamples)
+{
+    DenormalGuard denormalGuard;
+    int offset = 0;
+
+    while (offset < numSamples)
+    {
+        const int n = std::min(BLOCK_SIZE, numSamples - offset);
+        float* blockL = left + offset;
+        float* blockR = (right != nullptr) ? right + offset : nullptr;
+
+        // Breathing: block-rate envelope of the recorded signal (~50ms)
+        float targetGain = static_cast<float>(noiseRMS);
+        if (breathing > 0.0)
+        {
+            float peak = 0.0f;
+            for (int i = 0; i < n; ++i)
+                peak = std::max(peak, std::abs(blockL[i]));
+            if (blockR != nullptr)
+                for (int i = 0; i < n; ++i)
+                    peak = std::max(peak, std::abs(blockR[i]));
+
+            float coeff = 1.0f - static_cast<float>(std::exp(-n / (0.05 * fs)));
+            envelope += coeff * (peak - envelope);
+            targetGain *= 1.0f + static_cast<float>(breathing) * std::min(envelope, 1.0f);
+        }
+
+        // Linear gain ramp across the block - no zipper noise
+        float gainStep = (targetGain - currentGain) / static_cast<float>(n);
+
+        renderBlock(channelL, blockL, n, currentGain, gainStep);
+        if (blockR != nullptr)
+            renderBlock(channelR, blockR, n, currentGain, gainStep);
+
+        currentGain = targetGain;
+        offset += n;
+    }
+}
+
+} // namespace TapeHysteresis
@@ -0,0 +1,519 @@
+#include "TelemetryPage.h"
+
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <thread>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <cerrno>
+#include <csignal>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace TapeHysteresis
+{
+
+// Writer and readers are different processes: only address-free atomics work
+static_assert(std::atomic<uint32_t>::is_always_lock_free, "telemetry needs lock-free 32-bit atomics");
+static_assert(std::atomic<uint64_t>::is_always_lock_free, "telemetry needs lock-free 64-bit atomics");
+
+struct TelemetryPage::Page
+{
+    std::atomic<uint32_t> magic { 0 };           // Stored last, with release
+    uint32_t version = FORMAT_VERSION;
+    uint32_t numSlots = MAX_SLOTS;
+    uint32_t slotSize = sizeof(Slot);
+    uint64_t pid = 0;
+    char processName[NAME_LENGTH] = {};
+    std::atomic<uint32_t> numSlotsUsed { 0 };    // Every claimed slot is below this
+    Slot slots[MAX_SLOTS];
+};
+
+namespace
+{
+
+constexpr int MAX_READ_ATTEMPTS = 64;
+constexpr const char* TEMP_EXTENSION = ".tmp";
+constexpr size_t NAME_WORDS = TelemetryPage::NAME_LENGTH / 8;
+
+// Pid from a page (or page temp) file name, 0 if it is not one
+uint64_t pidFromFileName(const std::filesystem::path& file)
+{
+    const std::string stem = file.stem().string();
+    if (stem.empty() || stem.size() > 19 || !std::all_of(stem.begin(), stem.end(), [](char c) { return c >= '0' && c <= '9'; }))
+        return 0;
+    return std::strtoull(stem.c_str(), nullptr, 10);
+}
+
+void removeStalePages(const std::filesystem::path& directory)
+{
+    std::error_code error;
+    for (const auto& entry : std::filesystem::directory_iterator(directory, error))
+    {
+        const auto& file = entry.path();
+        if (file.extension() != TelemetryPage::FILE_EXTENSION && file.extension() != TEMP_EXTENSION)
+            continue;
+
+        const uint64_t pid = pidFromFileName(file);
+        if (pid != 0 && pid != TelemetryPage::getCurrentProcessId() && !TelemetryPage::isProcessAlive(pid))
+        {
+            std::error_code ignored;
+            std::filesystem::remove(file, ignored);
+        }
+    }
+}
+
+#ifndef _WIN32
+// The page directory has to be a real directory, owned by this user and
+// closed to everyone else - in a shared temp directory another local user
+// could otherwise pre-create it and plant symlinks or forged pages. Created
+// 0700; an existing one of ours is narrowed to that.
+bool preparePrivateDirectory(const std::filesystem::path& directory)
+{
+    std::error_code error;
+    if (directory.has_parent_path())
+        std::filesystem::create_directories(directory.parent_path(), error);
+
+    if (::mkdir(directory.c_str(), 0700) != 0 && errno != EEXIST)
+        return false;
+
+    struct stat status {};
+    if (::lstat(directory.c_str(), &status) != 0 || !S_ISDIR(status.st_mode) || status.st_uid != ::geteuid())
+        return false;
+
+    return (status.st_mode & 077) == 0 || ::chmod(directory.c_str(), 0700) == 0;
+}
+#endif
+
+std::string sanitize(std::string text)
+{
+    for (char& c : text)
+        if (!std::isalnum(static_cast<unsigned char>(c)) && c != '-' && c != '_' && c != '.')
+            c = '_';
+    return text;
+}
+
+} // namespace
+
+//==============================================================================
+// Slot
+
+void TelemetryPage::Slot::publish(const Counters& counters)
+{
+    const uint32_t start = sequence.load(std::memory_order_relaxed);
+    sequence.store(start + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    store(counters);
+    sequence.store(start + 2, std::memory_order_release);
+}
+
+void TelemetryPage::Slot::store(const Counters& counters)
+{
+    constexpr auto relaxed = std::memory_order_relaxed;
+    blocks.store(counters.blocks, relaxed);
+    busyNanoseconds.store(counters.busyNanoseconds, relaxed);
+    audioNanoseconds.store(counters.audioNanoseconds, relaxed);
+    maxBlockNanoseconds.store(counters.maxBlockNanoseconds, relaxed);
+    coreSamples.store(counters.coreSamples, relaxed);
+    jaSteps.store(counters.jaSteps, relaxed);
+    nonFiniteBlocks.store(counters.nonFiniteBlocks, relaxed);
+    memoryBytes.store(counters.memoryBytes, relaxed);
+    lastBlockTime.store(counters.lastBlockTime, relaxed);
+    sampleRate.store(counters.sampleRate, relaxed);
+    oversampling.store(counters.oversampling, relaxed);
+    activity.store(static_cast<uint32_t>(counters.activity), relaxed);
+    mode.store(static_cast<uint32_t>(counters.mode), relaxed);
+}
+
+void TelemetryPage::Slot::setName(const std::string& text)
+{
+    char bytes[NAME_LENGTH] = {};
+    std::memcpy(bytes, text.data(), std::min(text.size(), static_cast<size_t>(NAME_LENGTH - 1)));
+
+    for (size_t i = 0; i < NAME_WORDS; ++i)
+    {
+        uint64_t word;
+        std::memcpy(&word, bytes + 8 * i, 8);
+        name[i].store(word, std::memory_order_relaxed);
+    }
+}
+
+//==============================================================================
+// Mapping
+
+TelemetryPage::~TelemetryPage()
+{
+    close();
+}
+
+bool TelemetryPage::create(const std::filesystem::path& directory, const std::string& processName)
+{
+    close();
+
+    std::error_code error;
+#ifdef _WIN32
+    std::filesystem::create_directories(directory, error);
+#else
+    if (!preparePrivateDirectory(directory))
+        return false;
+#endif
+    removeStalePages(directory);
+
+    const std::string stem = std::to_string(getCurrentProcessId());
+    const size_t size = sizeof(Page);
+    void* address = nullptr;
+
+#ifdef _WIN32
+    // Delete-on-close: the page goes with the last handle, crash or not
+    const auto file = directory / (stem + FILE_EXTENSION);
+    HANDLE handle = CreateFileW(file.c_str(), GENERIC_READ | GENERIC_WRITE,
+                                FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, nullptr, CREATE_ALWAYS,
+                                FILE_ATTRIBUTE_TEMPORARY | FILE_FLAG_DELETE_ON_CLOSE, nullptr);
+    if (handle == INVALID_HANDLE_VALUE)
+        return false;
+
+    HANDLE mapping = CreateFileMappingW(handle, nullptr, PAGE_READWRITE, 0, static_cast<DWORD>(size), nullptr);
+    address = mapping != nullptr ? MapViewOfFile(mapping, FILE_MAP_ALL_ACCESS, 0, 0, size) : nullptr;
+    if (address == nullptr)
+    {
+        if (mapping != nullptr)
+            CloseHandle(mapping);
+        CloseHandle(handle);
+        return false;
+    }
+
+    fileHandle = handle;
+    mappingHandle = mapping;
+#else
+    // Initialized under a temp name, then renamed into place: a reader
+    // never maps a page that is still being set up. Always a new file of
+    // our own (a leftover temp of this pid is ours to remove), never
+    // through a link.
+    const auto file = directory / (stem + FILE_EXTENSION);
+    const auto temp = directory / (stem + TEMP_EXTENSION);
+    ::unlink(temp.c_str());
+    const int descriptor = ::open(temp.c_str(), O_RDWR | O_CREAT | O_EXCL | O_NOFOLLOW, 0600);
+    if (descriptor < 0)
+        return false;
+
+    if (::ftruncate(descriptor, static_cast<off_t>(size)) == 0)
+    {
+        address = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, descriptor, 0);
+        if (address == MAP_FAILED)
+            address = nullptr;
+    }
+    ::close(descriptor);
+
+    if (address == nullptr)
+    {
+        ::unlink(temp.c_str());
+        return false;
+    }
+#endif
+
+    page = new (address) Page();
+    page->pid = getCurrentProcessId();
+    std::strncpy(page->processName, processName.c_str(), NAME_LENGTH - 1);
+    page->magic.store(MAGIC, std::memory_order_release);
+
+    mappedSize = size;
+    owner = true;
+    path = file;
+
+#ifndef _WIN32
+    std::filesystem::rename(temp, file, error);
+    if (error)
+    {
+        close();
+        ::unlink(temp.c_str());
+        return false;
+    }
+#endif
+
+    return true;
+}
+
+bool TelemetryPage::attach(const std::filesystem::path& file)
+{
+    close();
+
+    const size_t size = sizeof(Page);
+    const void* address = nullptr;
+
+#ifdef _WIN32
+    HANDLE handle = CreateFileW(file.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+                                nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (handle == INVALID_HANDLE_VALUE)
+        return false;
+
+    LARGE_INTEGER fileSize {};
+    HANDLE mapping = nullptr;
+    if (GetFileSizeEx(handle, &fileSize) && static_cast<uint64_t>(fileSize.QuadPart) >= size)
+        mapping = CreateFileMappingW(handle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    address = mapping != nullptr ? MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, size) : nullptr;
+    if (address == nullptr)
+    {
+        if (mapping != nullptr)
+            CloseHandle(mapping);
+        CloseHandle(handle);
+        return false;
+    }
+
+    fileHandle = handle;
+    mappingHandle = mapping;
+#else
+    const int descriptor = ::open(file.c_str(), O_RDONLY | O_NOFOLLOW);
+    if (descriptor < 0)
+        return false;
+
+    // Only pages this user wrote
+    struct stat status {};
+    if (::fstat(descriptor, &status) == 0 && S_ISREG(status.st_mode) && status.st_uid == ::geteuid()
+        && static_cast<uint64_t>(status.st_size) >= size)
+    {
+        void* mapped = ::mmap(nullptr, size, PROT_READ, MAP_SHARED, descriptor, 0);
+        if (mapped != MAP_FAILED)
+            address = mapped;
+    }
+    ::close(descriptor);
+
+    if (address == nullptr)
+        return false;
+#endif
+
+    page = const_cast<Page*>(static_cast<const Page*>(address));
+    mappedSize = size;
+    owner = false;
+    path = file;
+
+    if (page->magic.load(std::memory_order_acquire) != MAGIC || page->version != FORMAT_VERSION
+        || page->numSlots != MAX_SLOTS || page->slotSize != sizeof(Slot))
+    {
+        close();
+        return false;
+    }
+
+    return true;
+}
+
+void TelemetryPage::close()
+{
+    if (page == nullptr)
+        return;
+
+#ifdef _WIN32
+    UnmapViewOfFile(page);
+    CloseHandle(static_cast<HANDLE>(mappingHandle));
+    CloseHandle(static_cast<HANDLE>(fileHandle));
+    mappingHandle = fileHandle = nullptr;
+#else
+    if (owner)
+        ::unlink(path.c_str());
+    ::munmap(page, mappedSize);
+#endif
+
+    page = nullptr;
+    mappedSize = 0;
+    owner = false;
+}
+
+//==============================================================================
+// Slots
+
+TelemetryPage::Slot* TelemetryPage::claim()
+{
+    if (page == nullptr || !owner)
+        return nullptr;
+
+    for (int i = 0; i < MAX_SLOTS; ++i)
+    {
+        Slot& slot = page->slots[i];
+        uint32_t expected = Slot::FREE;
+        if (!slot.state.compare_exchange_strong(expected, Slot::CLAIMED, std::memory_order_acq_rel))
+            continue;
+
+        // New generation and zeroed counters in one sequence-locked update
+        const uint32_t start = slot.sequence.load(std::memory_order_relaxed);
+        slot.sequence.store(start + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        slot.generation.fetch_add(1, std::memory_order_relaxed);
+        slot.store(Counters());
+        slot.sequence.store(start + 2, std::memory_order_release);
+        slot.setName({});
+
+        uint32_t used = page->numSlotsUsed.load(std::memory_order_relaxed);
+        while (used < static_cast<uint32_t>(i + 1)
+               && !page->numSlotsUsed.compare_exchange_weak(used, static_cast<uint32_t>(i + 1), std::memory_order_release))
+        {
+        }
+        return &slot;
+    }
+
+    return nullptr;
+}
+
+void TelemetryPage::release(Slot* slot)
+{
+    if (slot != nullptr)
+        slot->state.store(Slot::FREE, std::memory_order_release);
+}
+
+uint64_t TelemetryPage::getProcessId() const
+{
+    return page != nullptr ? page->pid : 0;
+}
+
+std::string TelemetryPage::getProcessName() const
+{
+    if (page == nullptr)
+        return {};
+    return std::string(page->processName, strnlen(page->processName, NAME_LENGTH));
+}
+
+std::vector<TelemetryPage::Reading> TelemetryPage::read() const
+{
+    std::vector<Reading> readings;
+    if (page == nullptr)
+        return readings;
+
+    constexpr auto relaxed = std::memory_order_relaxed;
+    const int used = static_cast<int>(std::min<uint32_t>(page->numSlotsUsed.load(std::memory_order_acquire), MAX_SLOTS));
+
+    for (int i = 0; i < used; ++i)
+    {
+        const Slot& slot = page->slots[i];
+        if (slot.state.load(std::memory_order_acquire) != Slot::CLAIMED)
+            continue;
+
+        Reading reading;
+        reading.slot = i;
+        Counters& c = reading.counters;
+        bool consistent = false;
+
+        for (int attempt = 0; attempt < MAX_READ_ATTEMPTS && !consistent; ++attempt)
+        {
+            const uint32_t start = slot.sequence.load(std::memory_order_acquire);
+            if (start & 1u)
+            {
+                std::this_thread::yield();
+                continue;
+            }
+
+            reading.generation = slot.generation.load(relaxed);
+            c.blocks = slot.blocks.load(relaxed);
+            c.busyNanoseconds = slot.busyNanoseconds.load(relaxed);
+            c.audioNanoseconds = slot.audioNanoseconds.load(relaxed);
+            c.maxBlockNanoseconds = slot.maxBlockNanoseconds.load(relaxed);
+            c.coreSamples = slot.coreSamples.load(relaxed);
+            c.jaSteps = slot.jaSteps.load(relaxed);
+            c.nonFiniteBlocks = slot.nonFiniteBlocks.load(relaxed);
+            c.memoryBytes = slot.memoryBytes.load(relaxed);
+            c.lastBlockTime = slot.lastBlockTime.load(relaxed);
+            c.sampleRate = slot.sampleRate.load(relaxed);
+            c.oversampling = slot.oversampling.load(relaxed);
+            c.activity = static_cast<Activity>(std::min(slot.activity.load(relaxed), static_cast<uint32_t>(Activity::saturating)));
+            c.mode = static_cast<Mode>(std::min(slot.mode.load(relaxed), static_cast<uint32_t>(Mode::batch)));
+
+            std::atomic_thread_fence(std::memory_order_acquire);
+            consistent = slot.sequence.load(relaxed) == start;
+        }
+
+        if (!consistent)
+            continue;
+
+        char bytes[NAME_LENGTH];
+        for (size_t w = 0; w < NAME_WORDS; ++w)
+        {
+            const uint64_t word = slot.name[w].load(relaxed);
+            std::memcpy(bytes + 8 * w, &word, 8);
+        }
+        reading.name.assign(bytes, strnlen(bytes, NAME_LENGTH));
+
+        readings.push_back(std::move(reading));
+    }
+
+    return readings;
+}
+
+//==============================================================================
+// Directory and process helpers
+
+std::filesystem::path TelemetryPage::getDefaultDirectory()
+{
+#ifndef _WIN32
+    // Per-user runtime directory (0700, owned by the user) where there is one
+    if (const char* runtime = std::getenv("XDG_RUNTIME_DIR"); runtime != nullptr && runtime[0] == '/')
+        return std::filesystem::path(runtime) / "lowthd-telemetry";
+#endif
+
+    std::error_code error;
+    std::filesystem::path temp = std::filesystem::temp_directory_path(error);
+    if (error)
+        temp = ".";
+
+    const char* user = std::getenv("USER");
+    if (user == nullptr) user = std::getenv("USERNAME");
+    if (user == nullptr) user = std::getenv("LOGNAME");
+
+    return temp / ("lowthd-telemetry-" + sanitize(user != nullptr ? user : "user"));
+}
+
+std::vector<std::filesystem::path> TelemetryPage::listPages(const std::filesystem::path& directory)
+{
+    std::vector<std::filesystem::path> pages;
+    std::error_code error;
+    for (const auto& entry : std::filesystem::directory_iterator(directory, error))
+        if (entry.path().extension() == FILE_EXTENSION && pidFromFileName(entry.path()) != 0)
+            pages.push_back(entry.path());
+
+    std::sort(pages.begin(), pages.end());
+    return pages;
+}
+
+uint64_t TelemetryPage::getCurrentProcessId()
+{
+#ifdef _WIN32
+    return static_cast<uint64_t>(GetCurrentProcessId());
+#else
+    return static_cast<uint64_t>(::getpid());
+#endif
+}
+
+bool TelemetryPage::isProcessAlive(uint64_t pid)
+{
+    if (pid == 0)
+        return false;
+
+#ifdef _WIN32
+    HANDLE process = OpenProcess(PROCESS_QUERY_LIMITED_INFORMATION, FALSE, static_cast<DWORD>(pid));
+    if (process == nullptr)
+        return GetLastError() == ERROR_ACCESS_DENIED;
+
+    DWORD exitCode = 0;
+    const bool alive = GetExitCodeProcess(process, &exitCode) && exitCode == STILL_ACTIVE;
+    CloseHandle(process);
+    return alive;
+#else
+    return ::kill(static_cast<pid_t>(pid), 0) == 0 || errno == EPERM;
+#endif
+}
+
+uint64_t TelemetryPage::now()
+{
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+} // namespace TapeHysteresis
@@ -0,0 +1,165 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+namespace TapeHysteresis
+{
+
+/**
+ * Telemetry Page - per-process shared-memory counters for every instance
+ *
+ * Each process that hosts instances maps one page file,
+ * $XDG_RUNTIME_DIR/lowthd-telemetry/<pid>.ltt (elsewhere
+ * <temp>/lowthd-telemetry-<user>/<pid>.ltt), and each instance claims a slot
+ * in it and publishes its counters once per block. Inspectors (lowthd-top)
+ * list the directory and map the pages read-only: nothing to enable, no
+ * editor, no IPC round trip, and a host that crashes leaves at worst a stale
+ * page (skipped while its pid is dead, removed by the next page created).
+ *
+ *   header   magic (stored last), format, pid, process name, slot count,
+ *            slots-used high-water mark
+ *   slots    MAX_SLOTS x { state, generation, sequence, name, Counters }
+ *
+ * Everything in the page is a lock-free std::atomic (the writer and readers
+ * are different processes). Slots are claimed by compare-and-swap, and each
+ * claim bumps the slot's generation so a reader can tell a reused slot from
+ * the instance it saw before. Counters are written by the slot's owner only,
+ * under a per-slot sequence lock: plain relaxed stores between two sequence
+ * bumps, no waiting on the writer side - a reader retries until it sees an
+ * even, unchanged sequence. Names are set from another thread, one atomic
+ * word at a time, and may read half-updated for one refresh after a rename.
+ *
+ * Counters are cumulative (load = busy / audio time between two reads) so
+ * a reader needs no clock in step with the writer's blocks. now() is the
+ * steady clock, which is system-wide - a reader compares it with
+ * lastBlockTime to see an instance the host stopped calling.
+ *
+ * POSIX: the directory must be the user's own and private (created 0700,
+ * checked with lstat - never a symlink or another user's directory), and
+ * the page is created 0600 with O_EXCL | O_NOFOLLOW under a temp name,
+ * mapped and initialized, then renamed into place, and unlinked on close -
+ * readers never see a partial page, and one still mapped stays valid.
+ * Readers only attach regular files the same user owns. Windows: the file is
+ * created delete-on-close.
+ */
+class TelemetryPage
+{
+public:
+    static constexpr uint32_t MAGIC = 0x5054544C;       // "LTTP"
+    static constexpr uint32_t FORMAT_VERSION = 1;
+    static constexpr int MAX_SLOTS = 256;
+    static constexpr int NAME_LENGTH = 64;              // Bytes, NUL-padded
+    static constexpr const char* FILE_EXTENSION = ".ltt";
+
+    // Saturation state over the last block; idle = no block published yet
+    // (readers also treat a stale lastBlockTime as idle)
+    enum class Activity : uint32_t { idle, linear, saturating };
+
+    // Who drives the render: the host's audio thread, an offline bounce,
+    // the background renderer's worker, or the cross-instance batch
+    enum class Mode : uint32_t { realtime, offline, background, batch };
+
+    struct Counters
+    {
+        uint64_t blocks = 0;
+        uint64_t busyNanoseconds = 0;      // Cumulative time spent rendering
+        uint64_t audioNanoseconds = 0;     // Cumulative audio rendered
+        uint64_t maxBlockNanoseconds = 0;  // Longest block, over the last one to two seconds of audio
+        uint64_t coreSamples = 0;          // Cumulative (oversampled) samples through the cores
+        uint64_t jaSteps = 0;              // Of those, samples that ran the J-A solve
+        uint64_t nonFiniteBlocks = 0;      // Blocks with NaN / Inf in the output
+        uint64_t memoryBytes = 0;          // Instance footprint estimate
+        uint64_t lastBlockTime = 0;        // now() at the end of the last block
+        uint32_t sampleRate = 0;           // Host rate, Hz
+        uint32_t oversampling = 0;
+        Activity activity = Activity::idle;
+        Mode mode = Mode::realtime;
+    };
+
+    class Slot
+    {
+    public:
+        // Owner's thread (one writer at a time)
+        void publish(const Counters& counters);
+
+        // Any thread of the owning process: truncated to NAME_LENGTH - 1 bytes
+        void setName(const std::string& name);
+
+    private:
+        friend class TelemetryPage;
+
+        enum State : uint32_t { FREE, CLAIMED };
+
+        void store(const Counters& counters);     // Inside the sequence lock
+
+        std::atomic<uint32_t> state { FREE };
+        std::atomic<uint32_t> generation { 0 };
+        std::atomic<uint32_t> sequence { 0 };
+        std::atomic<uint32_t> reserved { 0 };
+        std::atomic<uint64_t> name[NAME_LENGTH / 8] = {};
+
+        std::atomic<uint64_t> blocks { 0 }, busyNanoseconds { 0 }, audioNanoseconds { 0 };
+        std::atomic<uint64_t> maxBlockNanoseconds { 0 }, coreSamples { 0 }, jaSteps { 0 };
+        std::atomic<uint64_t> nonFiniteBlocks { 0 }, memoryBytes { 0 }, lastBlockTime { 0 };
+        std::atomic<uint32_t> sampleRate { 0 }, oversampling { 0 }, activity { 0 }, mode { 0 };
+    };
+
+    struct Reading
+    {
+        int slot = 0;
+        uint32_t generation = 0;
+        std::string name;
+        Counters counters;
+    };
+
+    TelemetryPage() = default;
+    ~TelemetryPage();
+
+    TelemetryPage(const TelemetryPage&) = delete;
+    TelemetryPage& operator=(const TelemetryPage&) = delete;
+
+    // Publishes this process's page in `directory` (created if missing) and
+    // removes the pages of processes that are gone. False = no telemetry.
+    bool create(const std::filesystem::path& directory, const std::string& processName);
+
+    // Maps a page read-only. False if it is not a complete page of this format.
+    bool attach(const std::filesystem::path& file);
+
+    void close();
+    bool isOpen() const { return page != nullptr; }
+
+    // Creator: a free slot, counters zeroed and unnamed; nullptr when full
+    Slot* claim();
+    void release(Slot* slot);
+
+    uint64_t getProcessId() const;
+    std::string getProcessName() const;
+
+    // Every claimed slot with a consistent reading (a slot whose writer
+    // keeps it busy through every retry is left out this time)
+    std::vector<Reading> read() const;
+
+    static std::filesystem::path getDefaultDirectory();
+    static std::vector<std::filesystem::path> listPages(const std::filesystem::path& directory);
+    static uint64_t getCurrentProcessId();
+    static bool isProcessAlive(uint64_t pid);
+    static uint64_t now();                          // Steady clock, ns
+
+private:
+    struct Page;
+
+    Page* page = nullptr;
+    size_t mappedSize = 0;
+    bool owner = false;
+    std::filesystem::path path;
+#ifdef _WIN32
+    void* fileHandle = nullptr;
+    void* mappingHandle = nullptr;
+#endif
+};
+
+} // namespace TapeHysteresis
@@ -0,0 +1,239 @@
+#include "WowFlutter.h"
+#include "DenormalGuard.h"
+#include "SeedHash.h"
+#include <algorithm>
+
+namespace TapeHysteresis
+{
+
+namespace
+{
+    struct TransportSpec
+    {
+        double wowFreq[WowFlutter::NUM_WOW_COMPONENTS];
+        double wowDepth[WowFlutter::NUM_WOW_COMPONENTS];   // peak speed deviation
+        double flutterDepth;                               // peak speed deviation
+    };
+
+    // AMPEX ATR-102: servo capstan, precision 2-track transport
+    constexpr TransportSpec ampexSpec = {
+        {0.63, 1.07, 9.6},
+        {0.00010, 0.00005, 0.00004},
+        0.00006
+    };
+
+    // STUDER A820: heavier 2" reels, slightly more wow
+    constexpr TransportSpec studerSpec = {
+        {0.55, 0.95, 7.8},
+        {0.00015, 0.00008, 0.00006},
+        0.00010
+    };
+
+    constexpr double flutterCentreFreq = 40.0;
+    constexpr double flutterQ = 0.5;
+    constexpr double flutterCrest = 2.5;   // peak / RMS of the band-passed noise
+
+    // Peak delay excursion (samples) for a spec, with headroom for noise peaks
+    double maxExcursion(const TransportSpec& spec, double fs)
+    {
+        double excursion = 0.0;
+        for (int i = 0; i < WowFlutter::NUM_WOW_COMPONENTS; ++i)
+            excursion += spec.wowDepth[i] * fs / (2.0 * M_PI * spec.wowFreq[i]);
+
+        double flutterRMS = spec.flutterDepth / flutterCrest * fs / (2.0 * M_PI * flutterCentreFreq);
+        return excursion + 5.0 * flutterRMS;
+    }
+}
+
+WowFlutter::WowFlutter(uint32_t seedValue)
+{
+    setSeed(seedValue);
+    setSampleRate(fs);
+}
+
+void WowFlutter::setSeed(uint32_t seedValue)
+{
+    seed = seedValue;
+
+    // Randomized LFO start phases (unique per instance)
+    for (int i = 0; i < NUM_WOW_COMPONENTS; ++i)
+        initialPhase[i] = 2.0 * M_PI * (hashSeed(seed + 0x9e3779b9U * (i + 1)) / 4294967296.0);
+}
+
+void WowFlutter::setSampleRate(double sampleRate)
+{
+    fs = sampleRate;
+
+    // Centre delay covers the worst machine so latency is constant across mode switches
+    double excursion = std::max(maxExcursion(ampexSpec, fs), maxExcursion(studerSpec, fs));
+    centreDelay = static_cast<int>(std::ceil(excursion)) + 2;   // Lagrange needs 2 samples ahead
+    historyLength = 2 * centreDelay + 4;
+
+    channelL.history.assign(historyLength + BLOCK_SIZE, 0.0f);
+    channelR.history.assign(historyLength + BLOCK_SIZE, 0.0f);
+
+    updateCoefficients();
+    reset();
+}
+
+void WowFlutter::setMachineMode(bool isAmpex)
+{
+    if (ampexMode != isAmpex)
+    {
+        ampexMode = isAmpex;
+        updateCoefficients();
+    }
+}
+
+void WowFlutter::reset()
+{
+    std::fill(channelL.history.begin(), channelL.history.end(), 0.0f);
+    std::fill(channelR.history.begin(), channelR.history.end(), 0.0f);
+
+    for (int i = 0; i < NUM_WOW_COMPONENTS; ++i)
+        wowPhase[i] = initialPhase[i];
+
+    noiseState = hashSeed(seed ^ 0x5bd1e995U);
+    bpZ1 = bpZ2 = 0.0;
+
+    lastDelay = static_cast<double>(centreDelay);
+    controlCountdown = 0;
+    delayStep = 0.0;
+}
+
+void WowFlutter::updateCoefficients()
+{
+    const TransportSpec& spec = ampexMode ? ampexSpec : studerSpec;
+    const double controlRate = fs / CONTROL_INTERVAL;
+
+    for (int i = 0; i < NUM_WOW_COMPONENTS; ++i)
+    {
+        wowFreq[i] = spec.wowFreq[i];
+        wowDepth[i] = spec.wowDepth[i];
+        // Delay amplitude A gives peak speed deviation 2*pi*f*A/fs
+        wowAmplitude[i] = wowDepth[i] * fs / (2.0 * M_PI * wowFreq[i]);
+        wowPhaseInc[i] = 2.0 * M_PI * wowFreq[i] / controlRate;
+    }
+
+    // Flutter bandpass (RBJ, 0dB peak) at the control rate
+    double w0 = 2.0 * M_PI * flutterCentreFreq / controlRate;
+    double alpha = std::sin(w0) / (2.0 * flutterQ);
+    double a0 = 1.0 + alpha;
+    bpB0 = alpha / a0;
+    bpB2 = -alpha / a0;
+    bpA1 = (-2.0 * std::cos(w0)) / a0;
+    bpA2 = (1.0 - alpha) / a0;
+
+    // RMS of the bandpass for uniform [-1, 1) input (variance 1/3)
+    double z1 = 0.0, z2 = 0.0, energy = 0.0;
+    for (int n = 0; n < 4096; ++n)
+    {
+        double x = (n == 0) ? 1.0 : 0.0;
+        double y = bpB0 * x + z1;
+        z1 = -bpA1 * y + z2;
+        z2 = bpB2 * x - bpA2 * y;
+        energy += y * y;
+    }
+    double bandpassRMS = std::sqrt(energy / 3.0);
+
+    flutterDepth = spec.flutterDepth;
+    double delayRMS = flutterDepth / flutterCrest * fs / (2.0 * M_PI * flutterCentreFreq);
+    flutterGain = delayRMS / bandpassRMS;
+}
+
+double WowFlutter::nextControlDelay()
+{
+    double delay = static_cast<double>(centreDelay);
+
+    for (int i = 0; i < NUM_WOW_COMPONENTS; ++i)
+    {
+        delay += wowAmplitude[i] * std::sin(wowPhase[i]);
+        wowPhase[i] += wowPhaseInc[i];
+        if (wowPhase[i] > 2.0 * M_PI) wowPhase[i] -= 2.0 * M_PI;
+    }
+
+    // Flutter noise (xorshift32 -> bandpass)
+    noiseState ^= noiseState << 13;
+    noiseState ^= noiseState >> 17;
+    noiseState ^= noiseState << 5;
+    double noise = static_cast<int32_t>(noiseState) * 4.656612873077393e-10;
+
+    double flutter = bpB0 * noise + bpZ1;
+    bpZ1 = -bpA1 * flutter + bpZ2;
+    bpZ2 = bpB2 * noise - bpA2 * flutter;
+    delay += flutterGain * flutter;
+
+    // Keep the 4-point kernel inside the history buffer
+    return std::clamp(delay, 2.0, static_cast<double>(historyLength - 2));
+}
+
+void WowFlutter::renderPositions(int numSamples)
+{
+    double delay = lastDelay;
+
+    for (int i = 0; i < numSamples; ++i)
+    {
+        if (controlCountdown == 0)
+        {
+            double target = nextControlDelay();
+            delayStep = (target - delay) / CONTROL_INTERVAL;
+            controlCountdown = CONTROL_INTERVAL;
+        }
+
+        readPosition[i] = static_cast<float>(historyLength + i - delay);
+        delay += delayStep;
+        --controlCountdown;
+    }
+
+    lastDelay = delay;
+}
+
+void WowFlutter::processChannel(Channel& ch, float* data, int numSamples)
+{
+    float* buffer = ch.history.data();
+    std::copy(data, data + numSamples, buffer + historyLength);
+
+    // 4-point Lagrange interpolation at the shared read positions
+    for (int i = 0; i < numSamples; ++i)
+    {
+        const float pos = readPosition[i];
+        const int k = static_cast<int>(pos);
+        const float f = pos - static_cast<float>(k);
+
+        const float fm1 = f - 1.0f;
+        const float fm2 = f - 2.0f;
+        const float fp1 = f + 1.0f;
+
+        const float cm1 = -f * fm1 * fm2 * (1.0f / 6.0f);
+        const float c0 = fp1 * fm1 * fm2 * 0.5f;
+        const float c1 = -fp1 * f * fm2 * 0.5f;
+        const float c2 = fp1 * f * fm1 * (1.0f / 6.0f);
+
+        data[i] = cm1 * buffer[k - 1] + c0 * buffer[k] + c1 * buffer[k + 1] + c2 * buffer[k + 2];
+    }
+
+    // Keep the most recent historyLength samples for the next block
+    std::copy(buffer + numSamples, buffer + numSamples + historyLength, buffer);
+}
+
+void WowFlutter::process(float* left, float* right, int numSamples)
+{
+    DenormalGuard denormalGuard;
+    int offset = 0;
+
+    while (offset < numSamples)
+    {
+        const int n = std::min(BLOCK_SIZE, numSamples - offset);
+
+        // One control signal for both channels (coherent transport)
+        renderPositions(n);
+
+        processChannel(channelL, left + offset, n);
+        if (right != nullptr)
+            processChannel(channelR, right + offset, n);
+
+        offset += n;
+    }
+}
+
+} // namespace TapeHysteresis
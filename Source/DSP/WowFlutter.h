@@ -0,0 +1,94 @@
+#pragma once
+
+#define _USE_MATH_DEFINES
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+namespace TapeHysteresis
+{
+
+// WowFlutter - Transport speed modulation (true pitch wow and flutter)
+//
+// A modulated fractional delay around a fixed integer centre delay (reported
+// as latency). One control signal per instance drives both channels, so the
+// L/R modulation stays coherent like a single capstan/reel transport.
+//
+// Control signal (computed every CONTROL_INTERVAL samples, linearly
+// interpolated in between):
+//   - Three wow/capstan sines with randomized start phases
+//   - Flutter: band-passed noise (~25-100Hz scrape/idler flutter)
+//
+// Peak speed deviation per component (30 IPS, fresh alignment):
+//   Ampex ATR-102: 0.010% reel, 0.005% secondary, 0.004% capstan, 0.006% flutter
+//   Studer A820:   0.015% reel, 0.008% secondary, 0.006% capstan, 0.010% flutter
+//
+// Interpolation: 4-point 3rd-order Lagrange over a linear history buffer,
+// evaluated block-wise (positions first, then one pass per channel).
+class WowFlutter
+{
+public:
+    explicit WowFlutter(uint32_t seed = 0x2545F491u);
+
+    void setSeed(uint32_t seed);
+    void setSampleRate(double sampleRate);
+    void setMachineMode(bool isAmpex);
+    void reset();
+
+    // Processes in place. right may be nullptr for mono.
+    void process(float* left, float* right, int numSamples);
+
+    // Fixed centre delay of the modulated line
+    int getLatencySamples() const { return centreDelay; }
+
+    static constexpr int BLOCK_SIZE = 256;
+    static constexpr int CONTROL_INTERVAL = 32;
+    static constexpr int NUM_WOW_COMPONENTS = 3;
+
+private:
+    struct Channel
+    {
+        std::vector<float> history;   // historyLength + BLOCK_SIZE
+    };
+
+    Channel channelL, channelR;
+    int historyLength = 0;
+    int centreDelay = 0;
+
+    double fs = 48000.0;
+    bool ampexMode = true;
+    uint32_t seed = 0x2545F491u;
+    uint32_t noiseState = 1;
+
+    // Wow components: delay amplitude (samples), phase, phase increment per control step
+    double wowFreq[NUM_WOW_COMPONENTS] = {0.0};
+    double wowDepth[NUM_WOW_COMPONENTS] = {0.0};   // peak speed deviation (fraction)
+    double wowAmplitude[NUM_WOW_COMPONENTS] = {0.0};
+    double wowPhase[NUM_WOW_COMPONENTS] = {0.0};
+    double initialPhase[NUM_WOW_COMPONENTS] = {0.0};
+    double wowPhaseInc[NUM_WOW_COMPONENTS] = {0.0};
+
+    // Flutter: white noise -> 2nd order bandpass at the control rate
+    double flutterDepth = 0.0;
+    double flutterGain = 0.0;
+    double bpB0 = 0.0, bpB2 = 0.0, bpA1 = 0.0, bpA2 = 0.0;
+    double bpZ1 = 0.0, bpZ2 = 0.0;
+
+    // Control signal: delay at the start of the next control step
+    double lastDelay = 0.0;
+    int controlCountdown = 0;
+    double delayStep = 0.0;
+
+    float readPosition[BLOCK_SIZE] = {0};
+
+    void updateCoefficients();
+    double nextControlDelay();
+    void renderPositions(int numSamples);
+    void processChannel(Channel& ch, float* data, int numSamples);
+};
+
+} // namespace TapeHysteresis
@@ -0,0 +1,539 @@
+/**
+ * AudioAnalysis.h
+ *
+ * Shared helpers for the offline measurement tools (header-only, no JUCE):
+ *   - WAV file I/O (PCM 16/24/32-bit and 32-bit float)
+ *   - Radix-2 FFT
+ *   - 2x polyphase resampling (renders the core at the plugin's internal rate)
+ *   - Cross-correlation alignment
+ *   - Multi-resolution STFT distance
+ *   - Nonlinear (incoherent) power spectrum via Welch cross-spectra
+ */
+
+#pragma once
+
+#define _USE_MATH_DEFINES
+#include <cmath>
+#include <complex>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <algorithm>
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+namespace AudioAnalysis
+{
+
+// ============================================================================
+// WAV I/O
+// ============================================================================
+struct WavFile
+{
+    double sampleRate = 0.0;
+    std::vector<std::vector<float>> channels;
+
+    int getNumChannels() const { return static_cast<int>(channels.size()); }
+    int getNumSamples() const { return channels.empty() ? 0 : static_cast<int>(channels[0].size()); }
+};
+
+inline uint32_t readLE(const unsigned char* p, int bytes)
+{
+    uint32_t value = 0;
+    for (int i = 0; i < bytes; ++i)
+        value |= static_cast<uint32_t>(p[i]) << (8 * i);
+    return value;
+}
+
+inline bool readWav(const std::string& path, WavFile& wav, std::string& error)
+{
+    FILE* file = std::fopen(path.c_str(), "rb");
+    if (file == nullptr)
+    {
+        error = "cannot open " + path;
+        return false;
+    }
+
+    std::vector<unsigned char> data;
+    unsigned char chunk[65536];
+    size_t got;
+    while ((got = std::fread(chunk, 1, sizeof(chunk), file)) > 0)
+        data.insert(data.end(), chunk, chunk + got);
+    std::fclose(file);
+
+    if (data.size() < 12 || std::memcmp(data.data(), "RIFF", 4) != 0 || std::memcmp(data.data() + 8, "WAVE", 4) != 0)
+    {
+        error = path + " is not a RIFF/WAVE file";
+        return false;
+    }
+
+    int format = 0, numChannels = 0, bitsPerSample = 0;
+    const unsigned char* samples = nullptr;
+    size_t sampleBytes = 0;
+
+    for (size_t pos = 12; pos + 8 <= data.size();)
+    {
+        const unsigned char* header = data.data() + pos;
+        size_t size = readLE(header + 4, 4);
+        size_t available = std::min(size, data.size() - pos - 8);
+
+        if (std::memcmp(header, "fmt ", 4) == 0 && available >= 16)
+        {
+            format = static_cast<int>(readLE(header + 8, 2));
+            numChannels = static_cast<int>(readLE(header + 10, 2));
+            wav.sampleRate = static_cast<double>(readLE(header + 12, 4));
+            bitsPerSample = static_cast<int>(readLE(header + 22, 2));
+
+            // WAVE_FORMAT_EXTENSIBLE: real format is the first word of the subformat GUID
+            if (format == 0xFFFE && available >= 26)
+                format = static_cast<int>(readLE(header + 32, 2));
+        }
+        else if (std::memcmp(header, "data", 4) == 0)
+        {
+            samples = header + 8;
+            sampleBytes = available;
+        }
+
+        pos += 8 + size + (size & 1);
+    }
+
+    bool supported = (format == 1 && (bitsPerSample == 16 || bitsPerSample == 24 || bitsPerSample == 32))
+                  || (format == 3 && bitsPerSample == 32);
+    if (samples == nullptr || numChannels <= 0 || !supported)
+    {
+        error = path + ": unsupported WAV format (need PCM 16/24/32 or float 32)";
+        return false;
+    }
+
+    const int bytesPerSample = bitsPerSample / 8;
+    const size_t numFrames = sampleBytes / (static_cast<size_t>(bytesPerSample) * numChannels);
+    wav.channels.assign(numChannels, std::vector<float>(numFrames));
+
+    for (size_t i = 0; i < numFrames; ++i)
+    {
+        for (int ch = 0; ch < numChannels; ++ch)
+        {
+            const unsigned char* p = samples + (i * numChannels + ch) * bytesPerSample;
+            float value;
+
+            if (format == 3)
+            {
+                uint32_t bits = readLE(p, 4);
+                std::memcpy(&value, &bits, sizeof(value));
+            }
+            else
+            {
+                uint32_t raw = readLE(p, bytesPerSample);
+                int shift = 32 - bitsPerSample;
+                int32_t sample = static_cast<int32_t>(raw << shift) >> shift;
+                value = static_cast<float>(sample / std::pow(2.0, bitsPerSample - 1));
+            }
+
+            wav.channels[ch][i] = value;
+        }
+    }
+
+    return true;
+}
+
+// Writes 32-bit float WAV
+inline bool writeWav(const std::string& path, const WavFile& wav)
+{
+    FILE* file = std::fopen(path.c_str(), "wb");
+    if (file == nullptr)
+        return false;
+
+    auto put = [file](uint32_t value, int bytes) {
+        for (int i = 0; i < bytes; ++i)
+            std::fputc(static_cast<int>((value >> (8 * i)) & 0xFF), file);
+    };
+
+    const uint32_t numChannels = static_cast<uint32_t>(wav.getNumChannels());
+    const uint32_t numFrames = static_cast<uint32_t>(wav.getNumSamples());
+    const uint32_t dataBytes = numFrames * numChannels * 4;
+    const uint32_t rate = static_cast<uint32_t>(wav.sampleRate);
+
+    std::fwrite("RIFF", 1, 4, file); put(36 + dataBytes, 4);
+    std::fwrite("WAVE", 1, 4, file);
+    std::fwrite("fmt ", 1, 4, file); put(16, 4);
+    put(3, 2); put(numChannels, 2); put(rate, 4);
+    put(rate * numChannels * 4, 4); put(numChannels * 4, 2); put(32, 2);
+    std::fwrite("data", 1, 4, file); put(dataBytes, 4);
+
+    for (uint32_t i = 0; i < numFrames; ++i)
+    {
+        for (uint32_t ch = 0; ch < numChannels; ++ch)
+        {
+            uint32_t bits;
+            std::memcpy(&bits, &wav.channels[ch][i], sizeof(bits));
+            put(bits, 4);
+        }
+    }
+
+    bool ok = (std::ferror(file) == 0);
+    std::fclose(file);
+    return ok;
+}
+
+// ============================================================================
+// FFT
+// ============================================================================
+inline int nextPowerOfTwo(int n)
+{
+    int size = 1;
+    while (size < n) size <<= 1;
+    return size;
+}
+
+// In-place iterative radix-2 FFT (size must be a power of two)
+inline void fft(std::vector<std::complex<double>>& data, bool inverse = false)
+{
+    const size_t n = data.size();
+
+    for (size_t i = 1, j = 0; i < n; ++i)
+    {
+        size_t bit = n >> 1;
+        for (; j & bit; bit >>= 1)
+            j ^= bit;
+        j ^= bit;
+        if (i < j)
+            std::swap(data[i], data[j]);
+    }
+
+    for (size_t len = 2; len <= n; len <<= 1)
+    {
+        double angle = 2.0 * M_PI / static_cast<double>(len) * (inverse ? 1.0 : -1.0);
+        std::complex<double> step(std::cos(angle), std::sin(angle));
+
+        for (size_t i = 0; i < n; i += len)
+        {
+            std::complex<double> w(1.0, 0.0);
+            for (size_t k = 0; k < len / 2; ++k)
+            {
+                std::complex<double> even = data[i + k];
+                std::complex<double> odd = data[i + k + len / 2] * w;
+                data[i + k] = even + odd;
+                data[i + k + len / 2] = even - odd;
+                w *= step;
+            }
+        }
+    }
+
+    if (inverse)
+        for (auto& value : data)
+            value /= static_cast<double>(n);
+}
+
+inline std::vector<double> hannWindow(int size)
+{
+    std::vector<double> window(size);
+    for (int i = 0; i < size; ++i)
+        window[i] = 0.5 - 0.5 * std::cos(2.0 * M_PI * i / size);
+    return window;
+}
+
+// ============================================================================
+// RESAMPLING
+// ============================================================================
+// Kaiser-windowed sinc lowpass at a quarter of the 2x rate (linear phase,
+// ~100dB stopband). Odd taps fall on the zero-stuffed samples.
+class Resampler2x
+{
+public:
+    static constexpr int NUM_TAPS = 127;
+
+    Resampler2x()
+    {
+        const double beta = 10.0;
+        const int centre = NUM_TAPS / 2;
+        const double cutoff = 0.5 * 0.92;   // Normalized to the 2x Nyquist
+
+        auto besselI0 = [](double x) {
+            double sum = 1.0, term = 1.0;
+            for (int k = 1; k < 30; ++k)
+            {
+                term *= (x / (2.0 * k)) * (x / (2.0 * k));
+                sum += term;
+            }
+            return sum;
+        };
+
+        double gain = 0.0;
+        for (int i = 0; i < NUM_TAPS; ++i)
+        {
+            double n = static_cast<double>(i - centre);
+            double sinc = (n == 0.0) ? cutoff : std::sin(M_PI * cutoff * n) / (M_PI * n);
+            double r = n / centre;
+            double window = besselI0(beta * std::sqrt(std::max(0.0, 1.0 - r * r))) / besselI0(beta);
+            taps[i] = sinc * window;
+            gain += taps[i];
+        }
+
+        for (double& tap : taps)
+            tap /= gain;
+    }
+
+    // Group delay at the 2x rate
+    static constexpr int getLatency() { return NUM_TAPS / 2; }
+
+    template <typename Sample>
+    std::vector<double> upsample(const std::vector<Sample>& input) const
+    {
+        const int n = static_cast<int>(input.size());
+        std::vector<double> output(2 * n, 0.0);
+
+        for (int i = 0; i < 2 * n; ++i)
+        {
+            double sum = 0.0;
+            // Only even offsets from i hit non-zero (original) samples
+            for (int k = (i & 1); k < NUM_TAPS; k += 2)
+            {
+                int src = i - k;
+                if (src >= 0)
+                    sum += taps[k] * input[src / 2];
+            }
+            output[i] = 2.0 * sum;
+        }
+
+        return output;
+    }
+
+    template <typename Sample = float>
+    std::vector<Sample> downsample(const std::vector<double>& input) const
+    {
+        const int n = static_cast<int>(input.size()) / 2;
+        std::vector<Sample> output(n);
+
+        for (int i = 0; i < n; ++i)
+        {
+            double sum = 0.0;
+            for (int k = 0; k < NUM_TAPS; ++k)
+            {
+                int src = 2 * i - k;
+                if (src >= 0)
+                    sum += taps[k] * input[src];
+            }
+            output[i] = static_cast<Sample>(sum);
+        }
+
+        return output;
+    }
+
+private:
+    double taps[NUM_TAPS];
+};
+
+// Power-of-two factor as cascaded 2x stages, the plugin's oversampling for
+// a host rate (HybridTapeProcessor::getOversamplingFactor). Factor 1 passes
+// straight through.
+class Oversampler
+{
+public:
+    explicit Oversampler(int factorToUse) : factor(factorToUse) {}
+
+    int getFactor() const { return factor; }
+
+    std::vector<double> upsample(const std::vector<float>& input) const
+    {
+        std::vector<double> output(input.begin(), input.end());
+        for (int f = 1; f < factor; f *= 2)
+            output = stage().upsample(output);
+        return output;
+    }
+
+    std::vector<float> downsample(const std::vector<double>& input) const
+    {
+        std::vector<double> output = input;
+        for (int f = 1; f < factor; f *= 2)
+            output = stage().downsample<double>(output);
+        return std::vector<float>(output.begin(), output.end());
+    }
+
+private:
+    int factor;
+
+    static const Resampler2x& stage()
+    {
+        static const Resampler2x resampler;
+        return resampler;
+    }
+};
+
+// ============================================================================
+// ALIGNMENT
+// ============================================================================
+// Lag (samples) that best aligns `other` to `reference`: other[i + lag] ~ reference[i].
+// Uses |cross-correlation| so a polarity flip still aligns; sign is reported.
+inline int findLag(const std::vector<float>& reference, const std::vector<float>& other,
+                   int maxLag, bool* inverted = nullptr)
+{
+    const int length = static_cast<int>(std::min(reference.size(), other.size()));
+    const int size = nextPowerOfTwo(2 * length);
+
+    std::vector<std::complex<double>> a(size), b(size);
+    for (int i = 0; i < length; ++i)
+    {
+        a[i] = reference[i];
+        b[i] = other[i];
+    }
+
+    fft(a);
+    fft(b);
+    for (int i = 0; i < size; ++i)
+        a[i] = std::conj(a[i]) * b[i];
+    fft(a, true);
+
+    int bestLag = 0;
+    double best = -1.0;
+    for (int lag = -maxLag; lag <= maxLag; ++lag)
+    {
+        double value = a[(lag + size) % size].real();
+        if (std::abs(value) > best)
+        {
+            best = std::abs(value);
+            bestLag = lag;
+            if (inverted) *inverted = (value < 0.0);
+        }
+    }
+
+    return bestLag;
+}
+
+// ============================================================================
+// MULTI-RESOLUTION STFT DISTANCE
+// ============================================================================
+// Sum over FFT sizes of spectral convergence + mean log-magnitude distance
+// (Yamamoto et al. style). 0 = identical magnitude spectrograms.
+inline double multiResolutionSTFTDistance(const std::vector<float>& target, const std::vector<float>& estimate,
+                                          const std::vector<int>& fftSizes = {256, 1024, 4096})
+{
+    const int length = static_cast<int>(std::min(target.size(), estimate.size()));
+    double total = 0.0;
+
+    for (int size : fftSizes)
+    {
+        const int hop = size / 4;
+        if (length < size)
+            continue;
+
+        std::vector<double> window = hannWindow(size);
+        std::vector<std::complex<double>> bufferT(size), bufferE(size);
+
+        double diffSquared = 0.0, targetSquared = 0.0, logDistance = 0.0;
+        long count = 0;
+
+        for (int start = 0; start + size <= length; start += hop)
+        {
+            for (int i = 0; i < size; ++i)
+            {
+                bufferT[i] = target[start + i] * window[i];
+                bufferE[i] = estimate[start + i] * window[i];
+            }
+            fft(bufferT);
+            fft(bufferE);
+
+            for (int k = 0; k <= size / 2; ++k)
+            {
+                double magT = std::abs(bufferT[k]);
+                double magE = std::abs(bufferE[k]);
+                diffSquared += (magT - magE) * (magT - magE);
+                targetSquared += magT * magT;
+                logDistance += std::abs(std::log(magT + 1e-7) - std::log(magE + 1e-7));
+                ++count;
+            }
+        }
+
+        if (count > 0 && targetSquared > 0.0)
+            total += std::sqrt(diffSquared / targetSquared) + logDistance / count;
+    }
+
+    return total;
+}
+
+// ============================================================================
+// NONLINEAR SPECTRUM
+// ============================================================================
+// Welch estimate of the part of y that is NOT linearly predictable from x:
+//   D(f) = Syy(f) - |Sxy(f)|^2 / Sxx(f)
+// i.e. harmonics, IMD and noise, independent of any linear EQ / phase shift.
+// Returned per bin, normalized by total output power (level independent).
+inline std::vector<double> nonlinearSpectrum(const std::vector<float>& x, const std::vector<float>& y,
+                                             int fftSize = 4096)
+{
+    const int length = static_cast<int>(std::min(x.size(), y.size()));
+    const int bins = fftSize / 2 + 1;
+    const int hop = fftSize / 2;
+
+    std::vector<double> window = hannWindow(fftSize);
+    std::vector<double> sxx(bins, 0.0), syy(bins, 0.0);
+    std::vector<std::complex<double>> sxy(bins, 0.0);
+    std::vector<std::complex<double>> bufferX(fftSize), bufferY(fftSize);
+
+    for (int start = 0; start + fftSize <= length; start += hop)
+    {
+        for (int i = 0; i < fftSize; ++i)
+        {
+            bufferX[i] = x[start + i] * window[i];
+            bufferY[i] = y[start + i] * window[i];
+        }
+        fft(bufferX);
+        fft(bufferY);
+
+        for (int k = 0; k < bins; ++k)
+        {
+            sxx[k] += std::norm(bufferX[k]);
+            syy[k] += std::norm(bufferY[k]);
+            sxy[k] += bufferY[k] * std::conj(bufferX[k]);
+        }
+    }
+
+    double totalPower = 0.0;
+    for (double value : syy)
+        totalPower += value;
+
+    std::vector<double> distortion(bins, 0.0);
+    for (int k = 0; k < bins; ++k)
+    {
+        double coherent = (sxx[k] > 1e-30) ? std::norm(sxy[k]) / sxx[k] : 0.0;
+        distortion[k] = std::max(syy[k] - coherent, 0.0) / std::max(totalPower, 1e-30);
+    }
+
+    return distortion;
+}
+
+// Mean |dB difference| of two per-bin spectra over 1/3-octave bands (40Hz-20kHz),
+// floored at -120dB so bands with no distortion in either signal don't dominate
+inline double bandedDistanceDB(const std::vector<double>& a, const std::vector<double>& b, double sampleRate)
+{
+    const int bins = static_cast<int>(std::min(a.size(), b.size()));
+    const double binWidth = sampleRate / (2.0 * (bins - 1));
+
+    double total = 0.0;
+    int bands = 0;
+
+    for (double centre = 40.0; centre <= std::min(20000.0, sampleRate * 0.45); centre *= std::pow(2.0, 1.0 / 3.0))
+    {
+        int lo = std::max(1, static_cast<int>(centre * std::pow(2.0, -1.0 / 6.0) / binWidth));
+        int hi = std::min(bins - 1, static_cast<int>(centre * std::pow(2.0, 1.0 / 6.0) / binWidth));
+        if (hi < lo)
+            continue;
+
+        double sumA = 0.0, sumB = 0.0;
+        for (int k = lo; k <= hi; ++k)
+        {
+            sumA += a[k];
+            sumB += b[k];
+        }
+
+        total += std::abs(10.0 * std::log10(sumA + 1e-12) - 10.0 * std::log10(sumB + 1e-12));
+        ++bands;
+    }
+
+    return (bands > 0) ? total / bands : 0.0;
+}
+
+} // namespace AudioAnalysis
@@ -0,0 +1,308 @@
+/**
+ * alias_sweep.cpp
+ *
+ * Aliasing report: how much non-harmonic (aliased) energy each oversampling
+ * configuration lets into the audible band, for both machines across drive
+ * levels, input frequencies and host sample rates - and the cheapest
+ * configuration per host rate that stays within an aliasing budget.
+ *
+ * Configurations: oversampling factor (1x-8x) x decimation filter. The core
+ * has no other anti-aliasing (no ADAA): everything above the internal
+ * Nyquist folds back inside the core, everything between the host and the
+ * internal Nyquist is removed by the decimation filter, as far as its
+ * stopband goes. Filters: ideal, and the plugin's juce::dsp::Oversampling
+ * halfband polyphase IIR in standard (the plugin's setting) and max-quality
+ * form, modelled by the final decimation stage's stopband and transition
+ * band (attenuation rising linearly in dB from the host Nyquist to the
+ * stopband edge).
+ *
+ * Method: the test tone sits on an odd FFT bin (coherent, one FFT frame is
+ * one period), is generated at the internal rate, and the core is settled on
+ * it (HybridTapeProcessor::settle) before the measured period. Harmonics of
+ * the tone land on multiples of its bin; every other bin up to 20 kHz is
+ * aliasing - from the core directly, or after decimation (internal bins
+ * folded onto the host rate, weighted by the filter). Aliasing is reported
+ * in dB re the fundamental; the worst case over machines, levels and
+ * frequencies decides. Cost is the core's measured time per host sample
+ * (the filters are a few percent of it); at equal factor the standard
+ * filter counts as cheaper.
+ *
+ * Build (from repo root):
+ *   g++ -std=c++17 -O2 -pthread Tests/alias_sweep.cpp Source/DSP/HybridTapeProcessor.cpp \
+ *       Source/DSP/BiasShielding.cpp Source/DSP/MachineEQ.cpp Source/DSP/MachineProfile.cpp -o alias_sweep
+ *
+ * Usage:
+ *   ./alias_sweep [--budget dB] [--rate hz] [--rate ...] [--threads n]
+ */
+
+#include <iostream>
+#include <cstdio>
+#include <cstdlib>
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <thread>
+#include "AudioAnalysis.h"
+#include "../Source/DSP/HybridTapeProcessor.h"
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+using namespace TapeHysteresis;
+
+// ============================================================================
+// SWEEP
+// ============================================================================
+static constexpr int FFT_SIZE = 8192;                   // At the host rate
+static constexpr double AUDIBLE_LIMIT = 20000.0;
+static const int factors[] = { 1, 2, 4, 8 };
+static const double levels[] = { -12.0, -6.0, 0.0, 6.0, 12.0 };      // dB re the calibration level
+static const double frequencies[] = { 1000.0, 5000.0, 10000.0, 15000.0 };
+static constexpr int NUM_FACTORS = 4;
+static constexpr int NUM_LEVELS = 5;
+static constexpr int NUM_FREQUENCIES = 4;
+
+// Final decimation stage of juce::dsp::Oversampling, filterHalfBandPolyphaseIIR
+struct Filter
+{
+    const char* name;
+    double stopbandDB;          // Attenuation beyond the stopband edge
+    double transitionWidth;     // Normalized to the oversampled rate
+};
+
+static const Filter filters[] = {
+    { "ideal",       -1000.0, 0.0  },
+    { "IIR max-q",   -75.0,   0.12 },
+    { "IIR std",     -60.0,   0.15 },    // The plugin's setting
+};
+static constexpr int NUM_FILTERS = 3;
+
+struct Case
+{
+    double hostRate;
+    int factor;
+    bool isAmpex;
+    int level;
+    int frequency;
+    double aliasDB[NUM_FILTERS];     // Aliased power re the fundamental
+};
+
+static int odd(int bin) { return bin | 1; }
+
+static void measure(Case& c)
+{
+    const int n = FFT_SIZE * c.factor;
+    const double internalRate = c.hostRate * c.factor;
+    const int bin = odd(static_cast<int>(std::lround(frequencies[c.frequency] * FFT_SIZE / c.hostRate)));
+    const double amplitude = std::pow(10.0, levels[c.level] / 20.0);
+
+    HybridTapeProcessor processor;
+    processor.setSampleRate(internalRate);
+    processor.setParameters(c.isAmpex ? 0.5 : 0.8, 1.0);
+
+    std::vector<double> signal(n);
+    for (int i = 0; i < n; ++i)
+        signal[i] = amplitude * std::sin(2.0 * M_PI * static_cast<double>(bin) * i / n);
+    processor.settle(signal.data(), n);
+    processor.processBlock(signal.data(), n);
+
+    std::vector<std::complex<double>> buffer(signal.begin(), signal.end());
+    AudioAnalysis::fft(buffer);
+
+    auto power = [&](int k) { return std::norm(buffer[k]); };
+    const double fundamental = power(bin);
+    const int audible = std::min(FFT_SIZE / 2, static_cast<int>(AUDIBLE_LIMIT * FFT_SIZE / c.hostRate));
+
+    for (int f = 0; f < NUM_FILTERS; ++f)
+    {
+        // Halfband at twice the host rate: stopband from (0.25 + width / 2) of it
+        const double stopbandEdge = (0.25 + 0.5 * filters[f].transitionWidth) * 2.0 * FFT_SIZE;
+        double aliased = 0.0;
+
+        for (int k = 1; k <= n / 2; ++k)
+        {
+            // Where bin k ends up at the host rate
+            const int r = k % FFT_SIZE;
+            const int image = (r <= FFT_SIZE / 2) ? r : FFT_SIZE - r;
+            if (image == 0 || image > audible)
+                continue;
+
+            // Harmonics below the host Nyquist are the wanted distortion
+            if (k <= FFT_SIZE / 2)
+            {
+                if (k % bin != 0)
+                    aliased += power(k);
+                continue;
+            }
+
+            // Above the host Nyquist: folded by decimation, through the filter
+            double attenuationDB = filters[f].stopbandDB;
+            if (k < stopbandEdge)
+                attenuationDB *= (k - FFT_SIZE / 2.0) / (stopbandEdge - FFT_SIZE / 2.0);
+            aliased += power(k) * std::pow(10.0, attenuationDB / 10.0);
+        }
+
+        c.aliasDB[f] = 10.0 * std::log10(std::max(aliased, 1e-300) / fundamental);
+    }
+}
+
+// Core time per host sample (loud Studer, the slowest case)
+static double measureCost(double hostRate, int factor)
+{
+    HybridTapeProcessor processor;
+    processor.setSampleRate(hostRate * factor);
+    processor.setParameters(0.8, 1.0);
+    processor.reset();
+
+    const int length = static_cast<int>(hostRate * factor);
+    std::vector<double> buffer(length);
+    for (int i = 0; i < length; ++i)
+        buffer[i] = std::sin(2.0 * M_PI * 1000.0 * i / (hostRate * factor));
+
+    processor.processBlock(buffer.data(), length);     // Warm up
+
+    double best = 1e30;
+    for (int run = 0; run < 3; ++run)
+    {
+        std::vector<double> block = buffer;
+        auto start = std::chrono::steady_clock::now();
+        processor.processBlock(block.data(), length);
+        auto end = std::chrono::steady_clock::now();
+        best = std::min(best, std::chrono::duration<double, std::nano>(end - start).count() / hostRate);
+    }
+    return best;
+}
+
+// ============================================================================
+// SETUP
+// ============================================================================
+struct Options
+{
+    double budgetDB = -80.0;
+    std::vector<double> rates;
+    int threads = 0;
+};
+
+static bool parseArguments(int argc, char** argv, Options& options)
+{
+    for (int i = 1; i < argc; ++i)
+    {
+        std::string arg = argv[i];
+        auto hasValue = [&](int count) { return i + count < argc; };
+
+        if (arg == "--budget" && hasValue(1))          options.budgetDB = std::atof(argv[++i]);
+        else if (arg == "--rate" && hasValue(1))       options.rates.push_back(std::atof(argv[++i]));
+        else if (arg == "--threads" && hasValue(1))    options.threads = std::atoi(argv[++i]);
+        else
+        {
+            std::cerr << "Unknown or incomplete argument: " << arg << "\n";
+            return false;
+        }
+    }
+
+    if (options.rates.empty())
+        options.rates = { 44100.0, 48000.0, 88200.0, 96000.0 };
+
+    for (double rate : options.rates)
+        if (rate < 2.0 * AUDIBLE_LIMIT)
+        {
+            std::cerr << "Rate below 40kHz: " << rate << "\n";
+            return false;
+        }
+
+    return true;
+}
+
+// ============================================================================
+// MAIN
+// ============================================================================
+int main(int argc, char** argv)
+{
+    Options options;
+    if (!parseArguments(argc, argv, options))
+    {
+        std::cerr << "Usage: alias_sweep [--budget dB] [--rate hz] [--rate ...] [--threads n]\n";
+        return 1;
+    }
+
+    // One job per rate x factor x machine x level x frequency
+    std::vector<Case> cases;
+    for (double rate : options.rates)
+        for (int factor : factors)
+            for (int m = 0; m < 2; ++m)
+                for (int l = 0; l < NUM_LEVELS; ++l)
+                    for (int f = 0; f < NUM_FREQUENCIES; ++f)
+                        cases.push_back({ rate, factor, m == 0, l, f, {} });
+
+    int numThreads = options.threads > 0 ? options.threads
+                                         : std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+
+    std::cout << "=== Alias Sweep (" << cases.size() << " cases, " << numThreads << " threads, budget "
+              << options.budgetDB << " dB) ===\n";
+
+    std::atomic<size_t> next { 0 };
+    auto worker = [&]()
+    {
+        for (size_t i = next++; i < cases.size(); i = next++)
+            measure(cases[i]);
+    };
+
+    std::vector<std::thread> workers;
+    for (int t = 0; t < numThreads; ++t)
+        workers.emplace_back(worker);
+    for (auto& thread : workers)
+        thread.join();
+
+    // Timed one at a time, after the sweep
+    for (double rate : options.rates)
+    {
+        std::printf("\n%.1fkHz host (plugin: %dx)\n", rate / 1000.0, HybridTapeProcessor::getOversamplingFactor(rate));
+        std::printf("  Config            Worst alias   Worst case                    Core/sample  Stereo\n");
+
+        int recommended = -1, recommendedFilter = -1;
+        double recommendedCost = 0.0;
+
+        for (int fi = 0; fi < NUM_FACTORS; ++fi)
+        {
+            const int factor = factors[fi];
+            const double cost = measureCost(rate, factor);
+
+            // Cheapest filter first, so the first compliant one is kept
+            for (int f = NUM_FILTERS - 1; f >= 0; --f)
+            {
+                if (factor == 1 && f != 0)
+                    continue;      // No decimation
+
+                const Case* worst = nullptr;
+                for (const Case& c : cases)
+                    if (c.hostRate == rate && c.factor == factor
+                        && (worst == nullptr || c.aliasDB[f] > worst->aliasDB[f]))
+                        worst = &c;
+
+                const bool compliant = worst->aliasDB[f] <= options.budgetDB;
+                if (compliant && recommended < 0)
+                {
+                    recommended = factor;
+                    recommendedFilter = f;
+                    recommendedCost = cost;
+                }
+
+                std::printf("  %dx %-12s   %7.1f dB    %-6s %+5.0fdB %5.0fHz       %6.0f ns   %5.2f%%%s\n",
+                            factor, factor == 1 ? "-" : filters[f].name, worst->aliasDB[f],
+                            worst->isAmpex ? "Ampex" : "Studer", levels[worst->level],
+                            frequencies[worst->frequency], cost, 100.0 * cost * 2.0 * rate * 1e-9,
+                            compliant ? "" : "  over");
+            }
+        }
+
+        if (recommended > 0)
+            std::printf("  -> Cheapest within %.0f dB: %dx, %s filter (%.0f ns per sample)\n",
+                        options.budgetDB, recommended, recommended == 1 ? "no" : filters[recommendedFilter].name,
+                        recommendedCost);
+        else
+            std::printf("  -> No configuration within %.0f dB\n", options.budgetDB);
+    }
+
+    return 0;
+}
@@ -0,0 +1,271 @@
+/**
+ * batch_render.cpp
+ *
+ * Renders stems through the core at the plugin's internal rate (channel 0
+ * on the left path, channel 1 on the right path with azimuth delay, further
+ * channels on the left path), optionally adding tape hiss.
+ *
+ * Every job is keyed by the input samples, sample rate, machine, drive,
+ * profile text, hiss seed and HybridTapeProcessor::ENGINE_VERSION, and its
+ * output kept in a RenderCache directory - re-bouncing an unchanged stem with
+ * unchanged settings just copies the cached render. Several batch_render
+ * processes may share one cache directory.
+ *
+ * Build (from repo root):
+ *   g++ -std=c++17 -O3 -pthread Tests/batch_render.cpp Source/DSP/HybridTapeProcessor.cpp \
+ *       Source/DSP/BiasShielding.cpp Source/DSP/MachineEQ.cpp Source/DSP/MachineProfile.cpp \
+ *       Source/DSP/TapeHiss.cpp Source/DSP/RenderCache.cpp -o batch_render
+ *
+ * Usage:
+ *   ./batch_render --machine ampex|studer --job in.wav out.wav [--job ...]
+ *       [--profile file.profile] [--drive dB] [--hiss] [--seed n]
+ *       [--cache dir] [--cache-mb n] [--no-cache] [--threads n]
+ */
+
+#include <iostream>
+#include <cstdio>
+#include <cstdlib>
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <thread>
+#include "AudioAnalysis.h"
+#include "../Source/DSP/HybridTapeProcessor.h"
+#include "../Source/DSP/RenderCache.h"
+#include "../Source/DSP/TapeHiss.h"
+
+using namespace TapeHysteresis;
+using namespace AudioAnalysis;
+
+// Bump when this tool's own processing (resampler, channel routing, hiss
+// setup) changes - the engine has ENGINE_VERSION for its part
+static constexpr uint64_t RENDER_VERSION = 2;
+
+struct Options
+{
+    bool isAmpex = true;
+    std::vector<std::pair<std::string, std::string>> jobs;
+    std::string profilePath;
+    double driveDB = 0.0;
+    bool hiss = false;
+    uint32_t seed = 1;
+    std::string cacheDirectory = ".lowthd-cache";
+    double cacheMB = 2048.0;
+    bool useCache = true;
+    int threads = 0;
+};
+
+// ============================================================================
+// RENDER
+// ============================================================================
+static RenderCache::Key makeKey(const WavFile& input, const Options& options, const std::string& profileText)
+{
+    RenderCache::KeyBuilder builder;
+    builder.add(std::string("lowthd batch_render"))
+           .add(RENDER_VERSION)
+           .add(static_cast<uint64_t>(HybridTapeProcessor::ENGINE_VERSION))
+           .add(input.sampleRate)
+           .add(std::string(options.isAmpex ? "ampex" : "studer"))
+           .add(options.driveDB)
+           .add(profileText)
+           .add(static_cast<uint64_t>(options.hiss ? options.seed : 0))
+           .add(static_cast<uint64_t>(options.hiss ? 1 : 0))
+           .add(static_cast<uint64_t>(input.getNumChannels()));
+
+    for (const auto& channel : input.channels)
+        builder.add(channel.data(), channel.size());
+
+    return builder.finish();
+}
+
+static RenderCache::Audio render(const WavFile& input, const Options& options, const MachineProfile* profile)
+{
+    const Oversampler resampler(HybridTapeProcessor::getOversamplingFactor(input.sampleRate));
+
+    RenderCache::Audio output;
+    output.sampleRate = input.sampleRate;
+
+    for (int ch = 0; ch < input.getNumChannels(); ++ch)
+    {
+        HybridTapeProcessor processor;
+        processor.setSampleRate(input.sampleRate * resampler.getFactor());
+        if (profile != nullptr)
+            processor.setMachineProfile(options.isAmpex ? HybridTapeProcessor::Slot::Master
+                                                        : HybridTapeProcessor::Slot::Tracks, *profile);
+        processor.setParameters(options.isAmpex ? 0.5 : 0.8, std::pow(10.0, options.driveDB / 20.0));
+        processor.reset();
+
+        std::vector<double> oversampled = resampler.upsample(input.channels[ch]);
+        if (ch == 1)
+            processor.processRightChannelBlock(oversampled.data(), static_cast<int>(oversampled.size()));
+        else
+            processor.processBlock(oversampled.data(), static_cast<int>(oversampled.size()));
+
+        output.channels.push_back(resampler.downsample(oversampled));
+    }
+
+    // One generator per channel pair, as in the plugin (L/R decorrelated)
+    if (options.hiss)
+    {
+        for (size_t ch = 0; ch < output.channels.size(); ch += 2)
+        {
+            TapeHiss tapeHiss(options.seed + static_cast<uint32_t>(ch / 2));
+            tapeHiss.setSampleRate(input.sampleRate);
+            tapeHiss.setMachineMode(options.isAmpex);
+            tapeHiss.setBreathing(0.5);
+            tapeHiss.reset();
+
+            float* right = ch + 1 < output.channels.size() ? output.channels[ch + 1].data() : nullptr;
+            tapeHiss.process(output.channels[ch].data(), right, static_cast<int>(output.channels[ch].size()));
+        }
+    }
+
+    return output;
+}
+
+// ============================================================================
+// SETUP
+// ============================================================================
+static bool parseArguments(int argc, char** argv, Options& options)
+{
+    for (int i = 1; i < argc; ++i)
+    {
+        std::string arg = argv[i];
+        auto hasValue = [&](int count) { return i + count < argc; };
+
+        if (arg == "--machine" && hasValue(1))
+            options.isAmpex = (std::string(argv[++i]) != "studer");
+        else if (arg == "--job" && hasValue(2))
+        {
+            options.jobs.emplace_back(argv[i + 1], argv[i + 2]);
+            i += 2;
+        }
+        else if (arg == "--profile" && hasValue(1))     options.profilePath = argv[++i];
+        else if (arg == "--drive" && hasValue(1))       options.driveDB = std::atof(argv[++i]);
+        else if (arg == "--seed" && hasValue(1))        options.seed = static_cast<uint32_t>(std::atol(argv[++i]));
+        else if (arg == "--cache" && hasValue(1))       options.cacheDirectory = argv[++i];
+        else if (arg == "--cache-mb" && hasValue(1))    options.cacheMB = std::atof(argv[++i]);
+        else if (arg == "--threads" && hasValue(1))     options.threads = std::atoi(argv[++i]);
+        else if (arg == "--hiss")                       options.hiss = true;
+        else if (arg == "--no-cache")                   options.useCache = false;
+        else
+        {
+            std::cerr << "Unknown or incomplete argument: " << arg << "\n";
+            return false;
+        }
+    }
+
+    return !options.jobs.empty();
+}
+
+// ============================================================================
+// MAIN
+// ============================================================================
+int main(int argc, char** argv)
+{
+    Options options;
+    if (!parseArguments(argc, argv, options))
+    {
+        std::cerr << "Usage: batch_render --machine ampex|studer --job in.wav out.wav [--job ...]\n"
+                  << "           [--profile file.profile] [--drive dB] [--hiss] [--seed n]\n"
+                  << "           [--cache dir] [--cache-mb n] [--no-cache] [--threads n]\n";
+        return 1;
+    }
+
+    // The key covers the full profile, built-in or loaded
+    MachineProfile profile = options.isAmpex ? MachineProfile::ampexATR102() : MachineProfile::studerA820();
+    if (!options.profilePath.empty())
+    {
+        std::string error;
+        if (!MachineProfile::loadFile(options.profilePath, profile, error))
+        {
+            std::cerr << options.profilePath << ": " << error << "\n";
+            return 1;
+        }
+    }
+    const std::string profileText = profile.toText();
+    const MachineProfile* customProfile = options.profilePath.empty() ? nullptr : &profile;
+
+    RenderCache cache(options.cacheDirectory, static_cast<uint64_t>(options.cacheMB * 1024.0 * 1024.0));
+
+    int numThreads = options.threads > 0 ? options.threads
+                                         : std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+    numThreads = std::min(numThreads, static_cast<int>(options.jobs.size()));
+
+    std::cout << "=== Batch Render: " << (options.isAmpex ? "AMPEX ATR-102" : "STUDER A820") << " ===\n\n";
+
+    std::atomic<size_t> nextJob { 0 };
+    std::atomic<int> failures { 0 }, hits { 0 };
+    std::mutex printMutex;
+
+    auto worker = [&]()
+    {
+        for (size_t j = nextJob++; j < options.jobs.size(); j = nextJob++)
+        {
+            const auto& job = options.jobs[j];
+            const auto start = std::chrono::steady_clock::now();
+
+            WavFile input;
+            std::string error;
+            if (!readWav(job.first, input, error))
+            {
+                std::lock_guard<std::mutex> lock(printMutex);
+                std::cerr << error << "\n";
+                ++failures;
+                continue;
+            }
+
+            RenderCache::Key key;
+            RenderCache::Audio output;
+            bool hit = false;
+            if (options.useCache)
+            {
+                key = makeKey(input, options, profileText);
+                hit = cache.lookup(key, output);
+            }
+
+            if (!hit)
+            {
+                output = render(input, options, customProfile);
+                if (options.useCache && !cache.store(key, output))
+                {
+                    std::lock_guard<std::mutex> lock(printMutex);
+                    std::cerr << "  Warning: could not store " << key.toHex() << " in " << options.cacheDirectory << "\n";
+                }
+            }
+
+            WavFile result;
+            result.sampleRate = output.sampleRate;
+            result.channels = std::move(output.channels);
+            bool written = writeWav(job.second, result);
+
+            const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+            std::lock_guard<std::mutex> lock(printMutex);
+            if (!written)
+            {
+                std::cerr << "Failed to write " << job.second << "\n";
+                ++failures;
+                continue;
+            }
+
+            hits += hit ? 1 : 0;
+            std::printf("  %-8s %s -> %s (%.2f s)\n", hit ? "cached" : "rendered",
+                        job.first.c_str(), job.second.c_str(), seconds);
+        }
+    };
+
+    std::vector<std::thread> workers;
+    for (int t = 1; t < numThreads; ++t)
+        workers.emplace_back(worker);
+    worker();
+    for (auto& thread : workers)
+        thread.join();
+
+    std::printf("\n  %zu jobs, %d from cache, %d failed", options.jobs.size(), hits.load(), failures.load());
+    if (options.useCache)
+        std::printf(", cache %.1f MB", static_cast<double>(cache.getSizeBytes()) / (1024.0 * 1024.0));
+    std::printf("\n");
+
+    return failures > 0 ? 1 : 0;
+}
@@ -0,0 +1,356 @@
+/**
+ * benchmark.cpp
+ *
+ * CPU cost of the DSP stages, in ns per sample and % of one core for a
+ * stereo instance in realtime, plus the cost of a silence tail (denormals):
+ * processBlock() holds flush-to-zero, so the tail must cost the same as
+ * signal; the unguarded per-sample path shows what the guard prevents.
+ * Then the linear fast path (quiet material and silence tails with every
+ * blend closed) vs the full path, and 8 instances per-instance vs stepped
+ * together (HybridTapeBatch). Last, print-through: the previous single-tap
+ * per-sample stage vs the block-vectorized multi-layer PrintThrough.
+ *
+ * Build (from repo root):
+ *   g++ -std=c++17 -O3 Tests/benchmark.cpp Source/DSP/HybridTapeProcessor.cpp \
+ *       Source/DSP/BiasShielding.cpp Source/DSP/MachineEQ.cpp Source/DSP/MachineProfile.cpp \
+ *       Source/DSP/TapeHiss.cpp Source/DSP/WowFlutter.cpp Source/DSP/HybridTapeBatch.cpp \
+ *       Source/DSP/PrintThrough.cpp -o benchmark
+ *   ./benchmark > bench_output.txt
+ */
+
+#include <iostream>
+#include <cstdio>
+#include <cmath>
+#include <algorithm>
+#include <chrono>
+#include <vector>
+#include <memory>
+#include "../Source/DSP/HybridTapeProcessor.h"
+#include "../Source/DSP/HybridTapeBatch.h"
+#include "../Source/DSP/TapeHiss.h"
+#include "../Source/DSP/WowFlutter.h"
+#include "../Source/DSP/PrintThrough.h"
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+using namespace TapeHysteresis;
+
+static constexpr int BLOCK_SIZE = 512;
+static constexpr double SECONDS = 4.0;
+
+// Runs fn(blockIndex) over SECONDS of audio and returns ns per sample
+template <typename Fn>
+double timePerSample(double sampleRate, Fn&& fn)
+{
+    const int numBlocks = static_cast<int>(SECONDS * sampleRate / BLOCK_SIZE);
+
+    auto start = std::chrono::steady_clock::now();
+    for (int b = 0; b < numBlocks; ++b)
+        fn(b);
+    auto end = std::chrono::steady_clock::now();
+
+    double ns = std::chrono::duration<double, std::nano>(end - start).count();
+    return ns / (static_cast<double>(numBlocks) * BLOCK_SIZE);
+}
+
+// Core ns per base-rate sample over one second of silence, measured after
+// one second of 0dB sine and skipSeconds of silence. The denormal sections
+// measure the full path (linearFastPath off).
+double silenceTailCost(double rate, double skipSeconds, bool guarded, bool linearFastPath = false)
+{
+    HybridTapeProcessor processor;
+    processor.setSampleRate(rate * 2.0);
+    processor.setParameters(0.82, 1.0);
+    processor.setLinearFastPath(linearFastPath);
+    processor.reset();
+
+    const int samplesPerSecond = static_cast<int>(rate * 2.0);
+    std::vector<double> buffer(BLOCK_SIZE * 2);
+    volatile double sink = 0.0;
+
+    auto run = [&](int numSamples, bool silent) {
+        for (int done = 0; done < numSamples; done += BLOCK_SIZE * 2)
+        {
+            for (int i = 0; i < BLOCK_SIZE * 2; ++i)
+                buffer[i] = silent ? 0.0 : std::sin(2.0 * M_PI * 1000.0 * (done + i) / (rate * 2.0));
+
+            if (guarded)
+                processor.processBlock(buffer.data(), BLOCK_SIZE * 2);
+            else
+                for (double& sample : buffer)
+                    sample = processor.processSample(sample);
+            sink = sink + buffer[0];
+        }
+    };
+
+    run(samplesPerSecond, false);
+    run(static_cast<int>(skipSeconds * samplesPerSecond), true);
+
+    auto start = std::chrono::steady_clock::now();
+    run(samplesPerSecond, true);
+    auto end = std::chrono::steady_clock::now();
+
+    return std::chrono::duration<double, std::nano>(end - start).count() / rate;
+}
+
+// The plugin's print-through before PrintThrough: one 65ms tap, the level
+// curve and a gate branch per sample, modulo index wrap
+struct SingleTapPrintThrough
+{
+    static constexpr int MAX_DELAY_SAMPLES = 12480;
+    static constexpr float printCoeff = 0.00126f;
+    static constexpr float noiseFloor = 0.001f;
+    float bufferL[MAX_DELAY_SAMPLES] = {0};
+    float bufferR[MAX_DELAY_SAMPLES] = {0};
+    int writeIndex = 0;
+    int delaySamples = 0;
+
+    void prepare(float sampleRate)
+    {
+        delaySamples = std::min(static_cast<int>(0.065f * sampleRate), MAX_DELAY_SAMPLES - 1);
+    }
+
+    void processSample(float& left, float& right)
+    {
+        int readIndex = writeIndex - delaySamples;
+        if (readIndex < 0) readIndex += MAX_DELAY_SAMPLES;
+
+        float delayedL = bufferL[readIndex];
+        float delayedR = bufferR[readIndex];
+        float absL = std::abs(delayedL);
+        float absR = std::abs(delayedR);
+        float printLevelL = (absL > noiseFloor) ? printCoeff * absL : 0.0f;
+        float printLevelR = (absR > noiseFloor) ? printCoeff * absR : 0.0f;
+
+        bufferL[writeIndex] = left;
+        bufferR[writeIndex] = right;
+        writeIndex = (writeIndex + 1) % MAX_DELAY_SAMPLES;
+
+        left += delayedL * printLevelL;
+        right += delayedR * printLevelR;
+    }
+};
+
+// Percentage of one core for a stereo instance running at sampleRate
+double percentOfCore(double nsPerSample, double sampleRate)
+{
+    return 100.0 * nsPerSample * 2.0 * sampleRate * 1e-9;
+}
+
+int main()
+{
+    const double rates[] = {44100.0, 48000.0, 88200.0, 96000.0, 176400.0, 192000.0};
+
+    std::vector<float> block(BLOCK_SIZE), blockR(BLOCK_SIZE);
+    volatile double sink = 0.0;
+
+    std::cout << "=== Benchmark (" << BLOCK_SIZE << "-sample blocks, per channel) ===\n\n";
+    std::cout << "  Rate      Core (Nx)    Hiss         W&F          Hiss/Core  W&F/Core\n";
+
+    for (double rate : rates)
+    {
+        // Core: J-A + atan + linear stages at the internal rate
+        const int factor = HybridTapeProcessor::getOversamplingFactor(rate);
+        HybridTapeProcessor processor;
+        processor.setSampleRate(rate * factor);
+        processor.setParameters(0.82, 1.0);
+        processor.reset();
+
+        double phase = 0.0;
+        const double phaseInc = 2.0 * M_PI * 1000.0 / (rate * factor);
+        double coreNs = timePerSample(rate, [&](int) {
+            for (int i = 0; i < BLOCK_SIZE * factor; ++i)
+            {
+                sink = sink + processor.processSample(0.5 * std::sin(phase));
+                phase += phaseInc;
+            }
+        });
+
+        // Hiss: added at the base rate
+        TapeHiss hiss(42u);
+        hiss.setSampleRate(rate);
+        hiss.setMachineMode(false);
+        hiss.setBreathing(0.5);
+        hiss.reset();
+
+        double hissNs = timePerSample(rate, [&](int) {
+            hiss.process(block.data(), nullptr, BLOCK_SIZE);
+            sink = sink + block[0];
+        });
+
+        // Wow & flutter: modulated delay at the base rate, both channels
+        WowFlutter wowFlutter(42u);
+        wowFlutter.setSampleRate(rate);
+        wowFlutter.setMachineMode(false);
+        wowFlutter.reset();
+
+        double wowNs = timePerSample(rate, [&](int) {
+            wowFlutter.process(block.data(), blockR.data(), BLOCK_SIZE);
+            sink = sink + block[0] + blockR[0];
+        }) * 0.5;
+
+        std::printf("  %6.1fk   %5.1f ns %dx  %5.2f ns     %5.2f ns     %5.1f%%     %5.1f%%\n",
+                    rate / 1000.0, coreNs, factor, hissNs, wowNs,
+                    100.0 * hissNs / coreNs, 100.0 * wowNs / coreNs);
+        std::printf("            (%5.2f%% core) (%5.3f%% core) (%5.3f%% core)\n",
+                    percentOfCore(coreNs, rate), percentOfCore(hissNs, rate),
+                    percentOfCore(wowNs, rate));
+    }
+
+    // Silence tail: same cost as signal when flush-to-zero is held
+    const double tailRate = 48000.0;
+    HybridTapeProcessor processor;
+    processor.setSampleRate(tailRate * 2.0);
+    processor.setParameters(0.82, 1.0);
+    processor.setLinearFastPath(false);
+    std::vector<double> signal(BLOCK_SIZE * 2);
+    double phase = 0.0;
+    double signalNs = timePerSample(tailRate, [&](int) {
+        for (double& sample : signal)
+        {
+            sample = std::sin(phase);
+            phase += 2.0 * M_PI * 1000.0 / (tailRate * 2.0);
+        }
+        processor.processBlock(signal.data(), BLOCK_SIZE * 2);
+        sink = sink + signal[0];
+    });
+
+    double guardedNear = silenceTailCost(tailRate, 1.0, true);
+    double guardedFar = silenceTailCost(tailRate, 30.0, true);
+    double unguardedNear = silenceTailCost(tailRate, 1.0, false);
+
+    std::cout << "\n=== Silence Tail (48k, core @2x) ===\n\n";
+    std::printf("  %-34s%6.1f ns\n", "Signal (processBlock)", signalNs);
+    std::printf("  %-34s%6.1f ns   x%.2f\n", "Silence +1s (processBlock)", guardedNear, guardedNear / signalNs);
+    std::printf("  %-34s%6.1f ns   x%.2f\n", "Silence +30s (processBlock)", guardedFar, guardedFar / signalNs);
+    std::printf("  %-34s%6.1f ns   x%.2f\n", "Silence +1s (no FTZ, per-sample)", unguardedNear, unguardedNear / signalNs);
+
+    // Linear fast path: -40dB material (under every blend threshold) and a
+    // silence tail, full path vs fast path
+    auto quietCost = [&](bool linearFastPath) {
+        HybridTapeProcessor quiet;
+        quiet.setSampleRate(tailRate * 2.0);
+        quiet.setParameters(0.82, 1.0);
+        quiet.setLinearFastPath(linearFastPath);
+        quiet.reset();
+        double quietPhase = 0.0;
+        return timePerSample(tailRate, [&](int) {
+            for (double& sample : signal)
+            {
+                sample = 0.01 * std::sin(quietPhase);
+                quietPhase += 2.0 * M_PI * 1000.0 / (tailRate * 2.0);
+            }
+            quiet.processBlock(signal.data(), BLOCK_SIZE * 2);
+            sink = sink + signal[0];
+        });
+    };
+
+    double quietFullNs = quietCost(false);
+    double quietFastNs = quietCost(true);
+    double tailFastNs = silenceTailCost(tailRate, 1.0, true, true);
+
+    std::cout << "\n=== Linear Fast Path (Studer, 48k, core @2x) ===\n\n";
+    std::printf("  %-34s%6.1f ns\n", "-40dB sine, full path", quietFullNs);
+    std::printf("  %-34s%6.1f ns   x%.2f\n", "-40dB sine, fast path", quietFastNs, quietFastNs / quietFullNs);
+    std::printf("  %-34s%6.1f ns   x%.2f\n", "Silence +1s, fast path", tailFastNs, tailFastNs / guardedNear);
+
+    // Cross-instance batch: 8 cores (4 stereo tracks, alternating machines)
+    // on 0dB material, each block per-instance vs in lock step
+    constexpr int NUM_CORES = 8;
+    auto batchCost = [&](bool batched) {
+        std::vector<std::unique_ptr<HybridTapeProcessor>> cores;
+        std::vector<std::vector<float>> buffers(NUM_CORES, std::vector<float>(BLOCK_SIZE * 2));
+        for (int c = 0; c < NUM_CORES; ++c)
+        {
+            cores.push_back(std::make_unique<HybridTapeProcessor>());
+            cores.back()->setSampleRate(tailRate * 2.0);
+            cores.back()->setParameters((c / 2) % 2 == 0 ? 0.5 : 0.82, 1.0);
+            cores.back()->reset();
+        }
+
+        double batchPhase = 0.0;
+        return timePerSample(tailRate, [&](int) {
+            for (int i = 0; i < BLOCK_SIZE * 2; ++i)
+            {
+                for (int c = 0; c < NUM_CORES; ++c)
+                    buffers[c][i] = static_cast<float>(std::sin(batchPhase * (1.0 + 0.1 * c)));
+                batchPhase += 2.0 * M_PI * 1000.0 / (tailRate * 2.0);
+            }
+
+            if (batched)
+            {
+                HybridTapeBatch::Lane lanes[NUM_CORES];
+                for (int c = 0; c < NUM_CORES; ++c)
+                    lanes[c] = { cores[c].get(), buffers[c].data(), c % 2 == 1 };
+                HybridTapeBatch::process(lanes, NUM_CORES, BLOCK_SIZE * 2);
+            }
+            else
+            {
+                for (int c = 0; c < NUM_CORES; ++c)
+                {
+                    if (c % 2 == 1)
+                        cores[c]->processRightChannelBlock(buffers[c].data(), BLOCK_SIZE * 2);
+                    else
+                        cores[c]->processBlock(buffers[c].data(), BLOCK_SIZE * 2);
+                }
+            }
+            sink = sink + buffers[0][0];
+        }) / (2.0 * NUM_CORES);
+    };
+
+    double perInstanceNs = batchCost(false);
+    double batchedNs = batchCost(true);
+
+    std::cout << "\n=== Cross-Instance Batch (8 cores, 0dB, 48k, per core sample) ===\n\n";
+    std::printf("  %-34s%6.1f ns\n", "Per-instance processBlock", perInstanceNs);
+    std::printf("  %-34s%6.1f ns   x%.2f\n", "HybridTapeBatch (4 lanes)", batchedNs, batchedNs / perInstanceNs);
+
+    // Print-through: stereo at 48k on music-like material (half the samples
+    // under the gate, so the single-tap branch is unpredictable)
+    const double printRate = 48000.0;
+    std::vector<float> material(BLOCK_SIZE * 64);
+    uint32_t materialSeed = 7;
+    for (size_t i = 0; i < material.size(); ++i)
+    {
+        materialSeed = materialSeed * 1664525u + 1013904223u;
+        const float noise = static_cast<float>(materialSeed) / 4294967296.0f - 0.5f;
+        material[i] = noise * ((materialSeed >> 8) & 1 ? 1.0f : 0.001f);
+    }
+    auto loadBlock = [&](int b) {
+        const float* source = material.data() + (b % 64) * BLOCK_SIZE;
+        std::copy(source, source + BLOCK_SIZE, block.begin());
+        std::copy(source, source + BLOCK_SIZE, blockR.begin());
+    };
+
+    auto singleTap = std::make_unique<SingleTapPrintThrough>();
+    singleTap->prepare(static_cast<float>(printRate));
+    double singleTapNs = timePerSample(printRate, [&](int b) {
+        loadBlock(b);
+        for (int i = 0; i < BLOCK_SIZE; ++i)
+            singleTap->processSample(block[i], blockR[i]);
+        sink = sink + block[0] + blockR[0];
+    });
+
+    PrintThrough printThrough;
+    printThrough.setSampleRate(printRate);
+    double multiTapNs = timePerSample(printRate, [&](int b) {
+        loadBlock(b);
+        printThrough.process(block.data(), blockR.data(), BLOCK_SIZE);
+        sink = sink + block[0] + blockR[0];
+    });
+
+    // Copying the block in is common to both
+    double copyNs = timePerSample(printRate, [&](int b) {
+        loadBlock(b);
+        sink = sink + block[0] + blockR[0];
+    });
+
+    std::cout << "\n=== Print-Through (stereo, 48k, per sample) ===\n\n";
+    std::printf("  %-34s%6.2f ns\n", "Single tap, per sample", singleTapNs - copyNs);
+    std::printf("  %-34s%6.2f ns   x%.2f\n", "PrintThrough (4 layers, block)", multiTapNs - copyNs,
+                (multiTapNs - copyNs) / (singleTapNs - copyNs));
+
+    return 0;
+}
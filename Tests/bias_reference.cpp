@@ -0,0 +1,488 @@
+/**
+ * bias_reference.cpp
+ *
+ * Checks the realtime AC-bias model (HFCut shelves + level blends) against
+ * the physical reference (BiasReference: bias oscillator + J-A record
+ * process at tens of MHz), and optionally re-fits the HFCut shelves to it.
+ *
+ * The reference is aligned like a machine on the bench:
+ *   1. Bias: a -20 dB, 10 kHz tone; raise the bias past the peak of its
+ *      output until it has dropped by the overbias (default 2 dB)
+ *   2. Level: the audio field at which a 0 dB, 1 kHz tone has the realtime
+ *      core's H3, so both start from the same point
+ * then both are measured at 96 kHz: H3 against level at 1 kHz, and H3
+ * against frequency at 0 dB, up to 14 kHz (H3 below 0.45 fs, the
+ * reference's passband). H3, not THD: the reference medium is symmetric -
+ * no even harmonics; the realtime core's come from its inputBias. The
+ * realtime core is solved by harmonic balance with its machine EQ and
+ * self-erasure removed (the reference has no playback chain and no head
+ * field geometry).
+ *
+ * --fit: Nelder-Mead on the two HFCut shelves (frequency, gain) so that the
+ * realtime H3 against frequency, relative to 1 kHz, follows the
+ * reference's; --write saves the profile with the fitted shelves.
+ *
+ * Build (from repo root):
+ *   g++ -std=c++17 -O2 -pthread Tests/bias_reference.cpp Source/DSP/BiasReference.cpp \
+ *       Source/DSP/HybridTapeProcessor.cpp Source/DSP/BiasShielding.cpp Source/DSP/MachineEQ.cpp \
+ *       Source/DSP/MachineProfile.cpp Source/DSP/HarmonicBalance.cpp -o bias_reference
+ *
+ * Usage:
+ *   ./bias_reference [--machine ampex|studer] [--overbias dB] [--steps n] [--threads n]
+ *       [--fit] [--write dir]
+ */
+
+#include <iostream>
+#include <cstdio>
+#include <cstdlib>
+#include <chrono>
+#include <complex>
+#include <fstream>
+#include <string>
+#include <vector>
+#include "../Source/DSP/BiasReference.h"
+#include "../Source/DSP/HybridTapeProcessor.h"
+#include "../Source/DSP/HarmonicBalance.h"
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+using namespace TapeHysteresis;
+
+// ============================================================================
+// MEASUREMENT
+// ============================================================================
+static constexpr double SAMPLE_RATE = 96000.0;
+static constexpr int FFT_SIZE = 2048;                 // Measured, after the lead-in
+static constexpr int LEAD_IN = 512;                   // Decimation filters and medium settle
+static constexpr int MAX_HARMONIC = 3;
+
+static constexpr double ALIGN_FREQ = 10000.0;
+static constexpr double ALIGN_LEVEL = -20.0;          // dB
+static constexpr double LEVEL_FREQ = 1000.0;
+
+static const double levels[] = { -12.0, -6.0, 0.0, 3.0, 6.0, 9.0 };
+static const double frequencies[] = { 1000.0, 2000.0, 4000.0, 6000.0, 8000.0, 10000.0, 12000.0, 14000.0 };
+static constexpr int NUM_LEVELS = 6;
+static constexpr int NUM_FREQUENCIES = 8;
+
+// Tone on the FFT bin nearest to frequency (coherent, no window)
+static int toneBin(double frequency)
+{
+    return std::max(1, (int)std::lround(frequency * FFT_SIZE / SAMPLE_RATE));
+}
+
+static double binFrequency(int bin)
+{
+    return bin * SAMPLE_RATE / FFT_SIZE;
+}
+
+struct Measurement
+{
+    double harmonics[MAX_HARMONIC + 1] = {};
+
+    double h3Percent() const { return 100.0 * harmonics[3] / harmonics[1]; }
+};
+
+static Measurement measureReference(const BiasReference::Settings& settings, double frequency, double levelDB,
+                                    BiasReference::Stats* stats = nullptr)
+{
+    const int bin = toneBin(frequency);
+    const double amplitude = std::pow(10.0, levelDB / 20.0);
+    std::vector<double> input(LEAD_IN + FFT_SIZE);
+    for (size_t n = 0; n < input.size(); ++n)
+        input[n] = amplitude * std::sin(2.0 * M_PI * bin * (double)n / FFT_SIZE);
+
+    const std::vector<double> output = BiasReference::record(input, SAMPLE_RATE, settings, stats);
+
+    Measurement m;
+    for (int h = 1; h <= MAX_HARMONIC && h * bin < FFT_SIZE / 2; ++h)
+    {
+        std::complex<double> sum = 0.0;
+        for (int n = 0; n < FFT_SIZE; ++n)
+            sum += output[(size_t)(LEAD_IN + n)] * std::polar(1.0, -2.0 * M_PI * h * bin * n / FFT_SIZE);
+        m.harmonics[h] = 2.0 * std::abs(sum) / FFT_SIZE;
+    }
+    return m;
+}
+
+static void configure(HybridTapeProcessor& processor, const MachineProfile& profile, bool isAmpex)
+{
+    // Compared at the saturation, as the reference
+    MachineProfile bare = profile;
+    bare.numEQStages = 0;
+    bare.selfErasureMaxCutDB = 0.0;
+
+    processor.setSampleRate(SAMPLE_RATE);
+    processor.setParameters(isAmpex ? 0.5 : 0.8, 1.0);
+    processor.setMachineProfile(isAmpex ? HybridTapeProcessor::Slot::Master : HybridTapeProcessor::Slot::Tracks,
+                                bare);
+}
+
+static Measurement measureRealtime(const HybridTapeProcessor& processor, double frequency, double levelDB)
+{
+    const double tone = binFrequency(toneBin(frequency));
+    const auto result = HarmonicBalance::solve(processor, tone, std::pow(10.0, levelDB / 20.0));
+
+    Measurement m;
+    for (int h = 1; h <= MAX_HARMONIC; ++h)
+        m.harmonics[h] = result.amplitude[h];
+    return m;
+}
+
+// ============================================================================
+// ALIGNMENT
+// ============================================================================
+// Bias for the overbias: golden-section search for the peak of the 10 kHz
+// output, then bisection above it for the drop
+static double alignBias(BiasReference::Settings settings, double overbiasDB, double& peakBias)
+{
+    auto output = [&](double bias)
+    {
+        settings.biasField = bias;
+        return measureReference(settings, ALIGN_FREQ, ALIGN_LEVEL).harmonics[1];
+    };
+
+    const double ratio = 0.5 * (std::sqrt(5.0) - 1.0);
+    double low = 0.1, high = 4.0;
+    double x1 = high - ratio * (high - low), x2 = low + ratio * (high - low);
+    double y1 = output(x1), y2 = output(x2);
+    while (high - low > 0.01)
+    {
+        if (y1 > y2)
+        {
+            high = x2; x2 = x1; y2 = y1;
+            x1 = high - ratio * (high - low);
+            y1 = output(x1);
+        }
+        else
+        {
+            low = x1; x1 = x2; y1 = y2;
+            x2 = low + ratio * (high - low);
+            y2 = output(x2);
+        }
+    }
+    peakBias = 0.5 * (low + high);
+
+    const double target = output(peakBias) * std::pow(10.0, -overbiasDB / 20.0);
+    low = peakBias;
+    high = 4.0 * peakBias;
+    for (int i = 0; i < 24 && high - low > 1e-3 * peakBias; ++i)
+    {
+        const double mid = 0.5 * (low + high);
+        (output(mid) > target ? low : high) = mid;
+    }
+    return 0.5 * (low + high);
+}
+
+// Audio field with the realtime core's H3 at 0 dB, 1 kHz (H3 rises with it)
+static double alignLevel(BiasReference::Settings settings, double targetH3)
+{
+    double low = std::log(0.01), high = std::log(10.0);
+    for (int i = 0; i < 24; ++i)
+    {
+        const double mid = 0.5 * (low + high);
+        settings.audioField = std::exp(mid);
+        (measureReference(settings, LEVEL_FREQ, 0.0).h3Percent() < targetH3 ? low : high) = mid;
+        if (high - low < 1e-3)
+            break;
+    }
+    return std::exp(0.5 * (low + high));
+}
+
+// ============================================================================
+// HFCUT FIT
+// ============================================================================
+static double dB(double ratio)
+{
+    return 20.0 * std::log10(ratio);
+}
+
+// RMS error (dB) of the realtime H3 against frequency, relative to 1 kHz
+static double shelfError(const MachineProfile& profile, bool isAmpex, const double* referenceShape)
+{
+    HybridTapeProcessor processor;
+    configure(processor, profile, isAmpex);
+
+    const double base = measureRealtime(processor, frequencies[0], 0.0).h3Percent();
+    double sum = 0.0;
+    for (int i = 1; i < NUM_FREQUENCIES; ++i)
+    {
+        const double error = dB(measureRealtime(processor, frequencies[i], 0.0).h3Percent() / base) - referenceShape[i];
+        sum += error * error;
+    }
+    return std::sqrt(sum / (NUM_FREQUENCIES - 1));
+}
+
+// Shelves as (log2 freq, gain dB), clamped to 1-20 kHz and -24..0 dB
+static void setShelves(MachineProfile& profile, const double* x)
+{
+    for (int s = 0; s < 2; ++s)
+    {
+        profile.hfCut[s].freq = std::clamp(std::exp2(x[2 * s]), 1000.0, 20000.0);
+        profile.hfCut[s].gainDB = std::clamp(x[2 * s + 1], -24.0, 0.0);
+    }
+}
+
+static MachineProfile fitShelves(const MachineProfile& start, bool isAmpex, const double* referenceShape,
+                                 double& error, int& evaluations)
+{
+    constexpr int N = 4;
+    double simplex[N + 1][N];
+    double value[N + 1];
+    MachineProfile trial = start;
+
+    auto evaluate = [&](const double* x)
+    {
+        setShelves(trial, x);
+        ++evaluations;
+        return shelfError(trial, isAmpex, referenceShape);
+    };
+
+    const double initial[N] = { std::log2(start.hfCut[0].freq), start.hfCut[0].gainDB,
+                                std::log2(start.hfCut[1].freq), start.hfCut[1].gainDB };
+    const double step[N] = { 0.5, 2.0, 0.5, 2.0 };
+    for (int v = 0; v <= N; ++v)
+    {
+        for (int j = 0; j < N; ++j)
+            simplex[v][j] = initial[j] + ((v == j + 1) ? step[j] : 0.0);
+        value[v] = evaluate(simplex[v]);
+    }
+
+    for (int iteration = 0; iteration < 400; ++iteration)
+    {
+        int best = 0, worst = 0, second = 0;
+        for (int v = 1; v <= N; ++v)
+        {
+            if (value[v] < value[best]) best = v;
+            if (value[v] > value[worst]) worst = v;
+        }
+        for (int v = 0; v <= N; ++v)
+            if (v != worst && (second == worst || value[v] > value[second])) second = v;
+        if (value[worst] - value[best] < 1e-4)
+            break;
+
+        double centroid[N] = {};
+        for (int v = 0; v <= N; ++v)
+            if (v != worst)
+                for (int j = 0; j < N; ++j)
+                    centroid[j] += simplex[v][j] / N;
+
+        auto along = [&](double t, double* x)
+        {
+            for (int j = 0; j < N; ++j)
+                x[j] = centroid[j] + t * (simplex[worst][j] - centroid[j]);
+            return evaluate(x);
+        };
+
+        double reflected[N], candidate[N];
+        const double reflectedValue = along(-1.0, reflected);
+        if (reflectedValue < value[best])
+        {
+            const double expandedValue = along(-2.0, candidate);
+            const bool expand = expandedValue < reflectedValue;
+            std::copy(expand ? candidate : reflected, (expand ? candidate : reflected) + N, simplex[worst]);
+            value[worst] = expand ? expandedValue : reflectedValue;
+        }
+        else if (reflectedValue < value[second])
+        {
+            std::copy(reflected, reflected + N, simplex[worst]);
+            value[worst] = reflectedValue;
+        }
+        else
+        {
+            const double contractedValue = along(0.5, candidate);
+            if (contractedValue < value[worst])
+            {
+                std::copy(candidate, candidate + N, simplex[worst]);
+                value[worst] = contractedValue;
+            }
+            else
+            {
+                // Shrink towards the best vertex
+                for (int v = 0; v <= N; ++v)
+                {
+                    if (v == best)
+                        continue;
+                    for (int j = 0; j < N; ++j)
+                        simplex[v][j] = simplex[best][j] + 0.5 * (simplex[v][j] - simplex[best][j]);
+                    value[v] = evaluate(simplex[v]);
+                }
+            }
+        }
+    }
+
+    int best = 0;
+    for (int v = 1; v <= N; ++v)
+        if (value[v] < value[best]) best = v;
+    MachineProfile fitted = start;
+    setShelves(fitted, simplex[best]);
+    error = value[best];
+    return fitted;
+}
+
+// ============================================================================
+// SETUP
+// ============================================================================
+struct Options
+{
+    bool ampex = true;
+    bool studer = true;
+    double overbiasDB = 2.0;
+    int stepsPerCycle = BiasReference::Settings().stepsPerCycle;
+    int threads = 0;
+    bool fit = false;
+    std::string writeDir;
+};
+
+static bool parseArguments(int argc, char** argv, Options& options)
+{
+    for (int i = 1; i < argc; ++i)
+    {
+        std::string arg = argv[i];
+        auto hasValue = [&](int count) { return i + count < argc; };
+
+        if (arg == "--machine" && hasValue(1))
+        {
+            std::string machine = argv[++i];
+            if (machine != "ampex" && machine != "studer")
+            {
+                std::cerr << "Unknown machine: " << machine << "\n";
+                return false;
+            }
+            options.ampex = (machine == "ampex");
+            options.studer = !options.ampex;
+        }
+        else if (arg == "--overbias" && hasValue(1))    options.overbiasDB = std::atof(argv[++i]);
+        else if (arg == "--steps" && hasValue(1))       options.stepsPerCycle = std::atoi(argv[++i]);
+        else if (arg == "--threads" && hasValue(1))     options.threads = std::atoi(argv[++i]);
+        else if (arg == "--fit")                        options.fit = true;
+        else if (arg == "--write" && hasValue(1))       options.writeDir = argv[++i];
+        else
+        {
+            std::cerr << "Unknown or incomplete argument: " << arg << "\n";
+            return false;
+        }
+    }
+
+    if (options.stepsPerCycle < 4 || options.overbiasDB <= 0.0)
+    {
+        std::cerr << "--steps needs at least 4, --overbias a positive value\n";
+        return false;
+    }
+    if (!options.writeDir.empty() && !options.fit)
+    {
+        std::cerr << "--write needs --fit\n";
+        return false;
+    }
+    return true;
+}
+
+// ============================================================================
+// REPORT
+// ============================================================================
+static bool report(bool isAmpex, const Options& options)
+{
+    const MachineProfile profile = isAmpex ? MachineProfile::ampexATR102() : MachineProfile::studerA820();
+    BiasReference::Settings settings = isAmpex ? BiasReference::ampexATR102() : BiasReference::studerA820();
+    settings.stepsPerCycle = options.stepsPerCycle;
+    settings.chunkLength = 256;             // Several lane groups per measurement, for the threads
+    settings.threads = options.threads;
+
+    HybridTapeProcessor processor;
+    configure(processor, profile, isAmpex);
+
+    std::printf("\n=== Bias Reference: %s (%.1f kHz bias) ===\n\n", profile.name.c_str(),
+                settings.biasFrequency / 1000.0);
+
+    auto clock = std::chrono::steady_clock::now();
+    BiasReference::Stats stats;
+    measureReference(settings, LEVEL_FREQ, 0.0, &stats);
+    std::printf("  Engine: %dx (%.2f MHz, %d halfband stages each way), %d chunks, %d re-rendered at handoff\n",
+                stats.oversampling, stats.internalRate / 1e6, stats.stages, stats.chunks, stats.rerendered);
+
+    double peakBias = 0.0;
+    settings.biasField = alignBias(settings, options.overbiasDB, peakBias);
+    const double realtimeH3 = measureRealtime(processor, LEVEL_FREQ, 0.0).h3Percent();
+    settings.audioField = alignLevel(settings, realtimeH3);
+
+    std::printf("  Bias: peak at %.3f k, aligned %.1f dB over at %.3f k (10 kHz, %.0f dB)\n", peakBias,
+                options.overbiasDB, settings.biasField, ALIGN_LEVEL);
+    std::printf("  Level: 0 dB = %.4f k audio field (1 kHz H3 %.4f%%)\n", settings.audioField, realtimeH3);
+
+    std::printf("\n  H3 against level, %.0f Hz\n", LEVEL_FREQ);
+    std::printf("  Level    Reference   Realtime\n");
+    for (double level : levels)
+        std::printf("  %+3.0fdB   %8.4f%%   %8.4f%%\n", level, measureReference(settings, LEVEL_FREQ, level).h3Percent(),
+                    measureRealtime(processor, LEVEL_FREQ, level).h3Percent());
+
+    // H3 against frequency, also as dB re 1 kHz (the shape the shelves set)
+    double referenceH3[NUM_FREQUENCIES], realtimeCurve[NUM_FREQUENCIES], referenceShape[NUM_FREQUENCIES];
+    for (int i = 0; i < NUM_FREQUENCIES; ++i)
+    {
+        referenceH3[i] = measureReference(settings, frequencies[i], 0.0).h3Percent();
+        realtimeCurve[i] = measureRealtime(processor, frequencies[i], 0.0).h3Percent();
+        referenceShape[i] = dB(referenceH3[i] / referenceH3[0]);
+    }
+
+    std::printf("\n  H3 against frequency, 0 dB\n");
+    std::printf("  Freq      Reference           Realtime\n");
+    for (int i = 0; i < NUM_FREQUENCIES; ++i)
+        std::printf("  %5.0f    %8.4f%% %+6.1fdB   %8.4f%% %+6.1fdB\n", frequencies[i], referenceH3[i],
+                    referenceShape[i], realtimeCurve[i], dB(realtimeCurve[i] / realtimeCurve[0]));
+
+    int evaluations = 0;
+    const double currentError = shelfError(profile, isAmpex, referenceShape);
+    std::printf("\n  HFCut shelves %.0f Hz %+.1f dB, %.0f Hz %+.1f dB: %.2f dB RMS from the reference shape\n",
+                profile.hfCut[0].freq, profile.hfCut[0].gainDB, profile.hfCut[1].freq, profile.hfCut[1].gainDB,
+                currentError);
+
+    if (options.fit)
+    {
+        double error = 0.0;
+        const MachineProfile fitted = fitShelves(profile, isAmpex, referenceShape, error, evaluations);
+        std::printf("  Fitted shelves %.0f Hz %+.1f dB, %.0f Hz %+.1f dB: %.2f dB RMS (%d evaluations)\n",
+                    fitted.hfCut[0].freq, fitted.hfCut[0].gainDB, fitted.hfCut[1].freq, fitted.hfCut[1].gainDB,
+                    error, evaluations);
+
+        if (!options.writeDir.empty())
+        {
+            const std::string path = options.writeDir + (isAmpex ? "/ampex_atr102.profile" : "/studer_a820.profile");
+            std::ofstream file(path);
+            file << fitted.toText();
+            if (!file)
+            {
+                std::cerr << "Cannot write " << path << "\n";
+                return false;
+            }
+            std::printf("  Wrote %s\n", path.c_str());
+        }
+    }
+
+    const double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - clock).count();
+    std::printf("\n  (%.1f s)\n", elapsed);
+    return true;
+}
+
+// ============================================================================
+// MAIN
+// ============================================================================
+int main(int argc, char** argv)
+{
+    Options options;
+    if (!parseArguments(argc, argv, options))
+    {
+        std::cerr << "Usage: bias_reference [--machine ampex|studer] [--overbias dB] [--steps n] [--threads n]\n"
+                     "                      [--fit] [--write dir]\n";
+        return 1;
+    }
+
+    bool ok = true;
+    if (options.ampex)
+        ok = report(true, options) && ok;
+    if (options.studer)
+        ok = report(false, options) && ok;
+
+    return ok ? 0 : 2;
+}
@@ -0,0 +1,258 @@
+/**
+ * lowthd_top.cpp
+ *
+ * lowthd-top: a live, top-style table of every plugin instance on this
+ * machine, read from the hosts' telemetry pages (TelemetryPage) - no editor,
+ * no host cooperation. Pages are mapped read-only; a host that exits or
+ * crashes drops out of the table (its pid is checked every refresh).
+ *
+ * Columns, per instance, over the last refresh interval:
+ *   LOAD%    render time / audio time rendered (100% = one core kept busy)
+ *   MAXms    longest single block over the last one to two seconds of audio
+ *   NR/smp   J-A Newton iterations per core sample (8 when every sample
+ *            saturates, 0 on the linear fast path)
+ *   STATE    sat = J-A running, linear = fast path, idle = no block for
+ *            IDLE_AFTER seconds (stopped transport, suspended, bypassed)
+ *   TIER     oversampling x render mode (rt, offline, bg, batch)
+ *   MEM      footprint estimate
+ *   NaN      blocks with NaN / Inf in the output, since the instance started
+ * The first refresh shows averages since each instance started.
+ *
+ * Build (from repo root):
+ *   g++ -std=c++17 -O2 Tests/lowthd_top.cpp Source/DSP/TelemetryPage.cpp -o lowthd-top
+ *
+ * Usage:
+ *   ./lowthd-top [--interval s] [--once] [--rows n] [--sort load|max|nr|mem|nan] [--dir path]
+ */
+
+#include <iostream>
+#include <cstdio>
+#include <cstdlib>
+#include <algorithm>
+#include <chrono>
+#include <map>
+#include <memory>
+#include <string>
+#include <thread>
+#include <tuple>
+#include <vector>
+#include "../Source/DSP/JilesAthertonCore.h"
+#include "../Source/DSP/TelemetryPage.h"
+
+using namespace TapeHysteresis;
+
+// ============================================================================
+// SAMPLING
+// ============================================================================
+static constexpr double IDLE_AFTER = 0.5;        // Seconds without a block
+
+struct Row
+{
+    uint64_t pid = 0;
+    std::string process;
+    std::string name;
+    int slot = 0;
+    double load = 0.0;              // %
+    double maxBlockMs = 0.0;
+    double newtonPerSample = 0.0;
+    const char* state = "";
+    std::string tier;
+    double memoryMiB = 0.0;
+    uint64_t nonFinite = 0;
+};
+
+// (pid, slot, generation) -> the reading of the previous refresh
+using InstanceKey = std::tuple<uint64_t, int, uint32_t>;
+using History = std::map<InstanceKey, TelemetryPage::Counters>;
+
+static const char* modeName(TelemetryPage::Mode mode)
+{
+    switch (mode)
+    {
+        case TelemetryPage::Mode::realtime:   return "rt";
+        case TelemetryPage::Mode::offline:    return "offline";
+        case TelemetryPage::Mode::background: return "bg";
+        case TelemetryPage::Mode::batch:      return "batch";
+    }
+    return "?";
+}
+
+static Row makeRow(const TelemetryPage& page, const TelemetryPage::Reading& reading,
+                   const TelemetryPage::Counters* previous, uint64_t now)
+{
+    const TelemetryPage::Counters& c = reading.counters;
+    const TelemetryPage::Counters base = previous != nullptr ? *previous : TelemetryPage::Counters();
+
+    Row row;
+    row.pid = page.getProcessId();
+    row.process = page.getProcessName();
+    row.name = reading.name.empty() ? "(unnamed)" : reading.name;
+    row.slot = reading.slot;
+
+    const double busy = static_cast<double>(c.busyNanoseconds - base.busyNanoseconds);
+    const double audio = static_cast<double>(c.audioNanoseconds - base.audioNanoseconds);
+    const double coreSamples = static_cast<double>(c.coreSamples - base.coreSamples);
+    row.load = audio > 0.0 ? 100.0 * busy / audio : 0.0;
+    row.newtonPerSample = coreSamples > 0.0
+        ? JilesAthertonCore::NEWTON_ITERATIONS * static_cast<double>(c.jaSteps - base.jaSteps) / coreSamples
+        : 0.0;
+    row.maxBlockMs = c.maxBlockNanoseconds * 1.0e-6;
+
+    const bool stale = c.activity == TelemetryPage::Activity::idle || now < c.lastBlockTime
+                    || (now - c.lastBlockTime) * 1.0e-9 > IDLE_AFTER;
+    row.state = stale ? "idle" : c.activity == TelemetryPage::Activity::saturating ? "sat" : "linear";
+
+    row.tier = std::to_string(c.oversampling) + "x " + modeName(c.mode);
+    row.memoryMiB = c.memoryBytes / (1024.0 * 1024.0);
+    row.nonFinite = c.nonFiniteBlocks;
+    return row;
+}
+
+// ============================================================================
+// SETUP
+// ============================================================================
+struct Options
+{
+    double interval = 1.0;
+    bool once = false;
+    int rows = 40;
+    std::string sort = "load";
+    std::string directory;
+};
+
+static bool parseArguments(int argc, char** argv, Options& options)
+{
+    for (int i = 1; i < argc; ++i)
+    {
+        std::string arg = argv[i];
+        auto hasValue = [&](int count) { return i + count < argc; };
+
+        if (arg == "--interval" && hasValue(1))        options.interval = std::atof(argv[++i]);
+        else if (arg == "--once")                      options.once = true;
+        else if (arg == "--rows" && hasValue(1))       options.rows = std::atoi(argv[++i]);
+        else if (arg == "--sort" && hasValue(1))       options.sort = argv[++i];
+        else if (arg == "--dir" && hasValue(1))        options.directory = argv[++i];
+        else
+        {
+            std::cerr << "Unknown or incomplete argument: " << arg << "\n";
+            return false;
+        }
+    }
+
+    static const char* sorts[] = { "load", "max", "nr", "mem", "nan" };
+    if (std::find_if(std::begin(sorts), std::end(sorts), [&](const char* s) { return options.sort == s; }) == std::end(sorts))
+    {
+        std::cerr << "Unknown sort column: " << options.sort << "\n";
+        return false;
+    }
+
+    options.interval = std::max(0.1, options.interval);
+    return true;
+}
+
+static double sortKey(const Row& row, const std::string& sort)
+{
+    if (sort == "max") return row.maxBlockMs;
+    if (sort == "nr")  return row.newtonPerSample;
+    if (sort == "mem") return row.memoryMiB;
+    if (sort == "nan") return static_cast<double>(row.nonFinite);
+    return row.load;
+}
+
+// ============================================================================
+// MAIN
+// ============================================================================
+int main(int argc, char** argv)
+{
+    Options options;
+    if (!parseArguments(argc, argv, options))
+    {
+        std::cerr << "Usage: lowthd-top [--interval s] [--once] [--rows n] [--sort load|max|nr|mem|nan] [--dir path]\n";
+        return 1;
+    }
+
+    const std::filesystem::path directory = options.directory.empty() ? TelemetryPage::getDefaultDirectory()
+                                                                      : std::filesystem::path(options.directory);
+
+    std::map<std::filesystem::path, std::unique_ptr<TelemetryPage>> pages;
+    History history;
+
+    // --once: one interval measured, one table
+    for (int refresh = 0;; ++refresh)
+    {
+        // Attach new pages, drop those of processes that are gone
+        const auto files = TelemetryPage::listPages(directory);
+        for (auto it = pages.begin(); it != pages.end();)
+        {
+            const bool listed = std::find(files.begin(), files.end(), it->first) != files.end();
+            it = (listed && TelemetryPage::isProcessAlive(it->second->getProcessId())) ? std::next(it) : pages.erase(it);
+        }
+        for (const auto& file : files)
+        {
+            if (pages.count(file) != 0)
+                continue;
+
+            auto page = std::make_unique<TelemetryPage>();
+            if (page->attach(file) && TelemetryPage::isProcessAlive(page->getProcessId()))
+                pages.emplace(file, std::move(page));
+        }
+
+        const uint64_t now = TelemetryPage::now();
+        std::vector<Row> rows;
+        History current;
+        for (const auto& [file, page] : pages)
+        {
+            for (const auto& reading : page->read())
+            {
+                const InstanceKey key { page->getProcessId(), reading.slot, reading.generation };
+                const auto previous = history.find(key);
+                rows.push_back(makeRow(*page, reading, previous != history.end() ? &previous->second : nullptr, now));
+                current[key] = reading.counters;
+            }
+        }
+        history = std::move(current);
+
+        if (!options.once || refresh > 0)
+        {
+            std::stable_sort(rows.begin(), rows.end(), [&](const Row& a, const Row& b)
+            {
+                return sortKey(a, options.sort) > sortKey(b, options.sort);
+            });
+
+            double totalLoad = 0.0;
+            int saturating = 0;
+            for (const Row& row : rows)
+            {
+                totalLoad += row.load;
+                saturating += std::string(row.state) == "sat" ? 1 : 0;
+            }
+
+            if (!options.once)
+                std::printf("\033[H\033[2J");
+            std::printf("lowthd-top - %zu hosts, %zu instances (%d saturating), total load %.1f%%   [%s, sort %s]\n\n",
+                        pages.size(), rows.size(), saturating, totalLoad, directory.string().c_str(), options.sort.c_str());
+            std::printf("%7s %-14s %4s  %-24s %6s %7s %6s %-6s %-10s %7s %5s\n",
+                        "PID", "HOST", "SLOT", "TRACK", "LOAD%", "MAXms", "NR/smp", "STATE", "TIER", "MEM", "NaN");
+
+            const int shown = std::min(static_cast<int>(rows.size()), std::max(0, options.rows));
+            for (int i = 0; i < shown; ++i)
+            {
+                const Row& row = rows[i];
+                std::printf("%7llu %-14.14s %4d  %-24.24s %6.2f %7.3f %6.2f %-6s %-10s %6.1fM %5llu\n",
+                            static_cast<unsigned long long>(row.pid), row.process.c_str(), row.slot, row.name.c_str(),
+                            row.load, row.maxBlockMs, row.newtonPerSample, row.state, row.tier.c_str(),
+                            row.memoryMiB, static_cast<unsigned long long>(row.nonFinite));
+            }
+            if (shown < static_cast<int>(rows.size()))
+                std::printf("... %zu more\n", rows.size() - shown);
+            std::fflush(stdout);
+
+            if (options.once)
+                break;
+        }
+
+        std::this_thread::sleep_for(std::chrono::duration<double>(options.interval));
+    }
+
+    return 0;
+}
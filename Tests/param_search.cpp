@@ -1,7 +1,26 @@
+/**
+ * param_search.cpp
+ *
+ * Calibration report: single-tone THD / E/O against TARGETS.md, plus
+ * SMPTE / CCIF IMD and 31-tone multitone distortion for both machines at
+ * all drive levels. The IMD / multitone cases run in parallel. The THD
+ * levels are cross-checked against the harmonic-balance steady state.
+ *
+ * Build (from repo root):
+ *   g++ -std=c++17 -O2 -pthread Tests/param_search.cpp Source/DSP/HybridTapeProcessor.cpp \
+ *       Source/DSP/BiasShielding.cpp Source/DSP/MachineEQ.cpp Source/DSP/MachineProfile.cpp \
+ *       Source/DSP/HarmonicBalance.cpp -o param_search
+ */
+
 #include <iostream>
 #include <cmath>
 #include <vector>
+#include <thread>
+#include <atomic>
+#include <chrono>
+#include "AudioAnalysis.h"
 #include "../Source/DSP/HybridTapeProcessor.h"
+#include "../Source/DSP/HarmonicBalance.h"
 
 #ifndef M_PI
 #define M_PI 3.14159265358979323846
@@ -9,23 +28,22 @@
 
 using namespace TapeHysteresis;
 
+// signal: whole cycles from a settled processor (HybridTapeProcessor::settle)
 double measureTHD(const std::vector<double>& signal, double sampleRate, double testFreq,
                    double* h2 = nullptr, double* h3 = nullptr) {
     int N = signal.size();
-    int warmup = N / 3;
-    int measureN = N - warmup;
 
     double harmonics[6] = {0};
     for (int h = 1; h <= 5; ++h) {
         double freq = testFreq * h;
         if (freq > sampleRate / 2.0) break;
         double sumCos = 0, sumSin = 0;
-        for (int i = warmup; i < N; ++i) {
+        for (int i = 0; i < N; ++i) {
             double t = i / sampleRate;
             sumCos += signal[i] * std::cos(2.0 * M_PI * freq * t);
             sumSin += signal[i] * std::sin(2.0 * M_PI * freq * t);
         }
-        harmonics[h] = 2.0 * std::sqrt(sumCos*sumCos + sumSin*sumSin) / measureN;
+        harmonics[h] = 2.0 * std::sqrt(sumCos*sumCos + sumSin*sumSin) / N;
     }
 
     if (h2) *h2 = harmonics[2];
@@ -55,14 +73,16 @@ THDResult measureMachine(bool isAmpex) {
     
     for (int i = 0; i < 5; ++i) {
         double amplitude = std::pow(10.0, levels[i] / 20.0);
-        int N = 300 * static_cast<int>(sampleRate / testFreq);
+        int period = static_cast<int>(sampleRate / testFreq);
+        int N = 100 * period;
         std::vector<double> output(N);
-        processor.reset();
         
         for (int j = 0; j < N; ++j) {
             double t = j / sampleRate;
-            output[j] = processor.processSample(amplitude * std::sin(2.0 * M_PI * testFreq * t));
+            output[j] = amplitude * std::sin(2.0 * M_PI * testFreq * t);
         }
+        processor.settle(output.data(), period);  // Steady state from sample 0
+        processor.processBlock(output.data(), N);  // Flush-to-zero held by the core
         
         double h2, h3;
         *results[i] = measureTHD(output, sampleRate, testFreq, &h2, &h3);
@@ -72,6 +92,165 @@ THDResult measureMachine(bool isAmpex) {
     return result;
 }
 
+// Same levels solved in the frequency domain (HarmonicBalance), next to the
+// simulated THD - no warm-up, no simulation
+void printHarmonicBalance(const char* name, bool isAmpex, const THDResult& simulated) {
+    HybridTapeProcessor processor;
+    processor.setSampleRate(96000.0);
+    processor.setParameters(isAmpex ? 0.5 : 0.8, 1.0);
+
+    const double levels[] = {-12.0, -6.0, 0.0, 3.0, 6.0};
+    const double thd[] = {simulated.thd_m12, simulated.thd_m6, simulated.thd_0, simulated.thd_3, simulated.thd_6};
+
+    printf("%s:\n", name);
+    printf("  Level     Simulated  Balance    Solve\n");
+    for (int i = 0; i < 5; ++i) {
+        auto start = std::chrono::steady_clock::now();
+        auto result = HarmonicBalance::solve(processor, 100.0, std::pow(10.0, levels[i] / 20.0));
+        auto end = std::chrono::steady_clock::now();
+        printf("  %+4.0fdB   %6.3f%%    %6.3f%%    %4.1f ms%s\n", levels[i], thd[i], result.thdPercent(),
+               std::chrono::duration<double, std::milli>(end - start).count(),
+               result.converged ? "" : "  (not converged)");
+    }
+}
+
+// ============================================================================
+// IMD / MULTITONE (FFT, coherent sampling - every tone sits on a bin)
+// ============================================================================
+static constexpr double IMD_SAMPLE_RATE = 96000.0;
+static constexpr int IMD_FFT_SIZE = 65536;
+static constexpr int NUM_LEVELS = 5;
+static const double imdLevels[NUM_LEVELS] = {-12.0, -6.0, 0.0, 3.0, 6.0};
+
+struct Tone { int bin; double amplitude; double phase; };
+
+// Renders the tones through a fresh processor and returns |X[k]| (peak amplitude per bin)
+std::vector<double> measureSpectrum(bool isAmpex, const std::vector<Tone>& tones) {
+    HybridTapeProcessor processor;
+    processor.setSampleRate(IMD_SAMPLE_RATE);
+    processor.setParameters(isAmpex ? 0.5 : 0.8, 1.0);
+
+    // Every tone sits on a bin, so one FFT frame is one period: settle on it
+    std::vector<double> signal(IMD_FFT_SIZE, 0.0);
+    for (int i = 0; i < IMD_FFT_SIZE; ++i)
+        for (const auto& tone : tones)
+            signal[i] += tone.amplitude * std::sin(2.0 * M_PI * tone.bin * i / IMD_FFT_SIZE + tone.phase);
+    processor.settle(signal.data(), IMD_FFT_SIZE);
+    processor.processBlock(signal.data(), static_cast<int>(signal.size()));
+
+    std::vector<std::complex<double>> buffer(signal.begin(), signal.end());
+
+    AudioAnalysis::fft(buffer);
+    std::vector<double> magnitude(IMD_FFT_SIZE / 2);
+    for (int k = 0; k < IMD_FFT_SIZE / 2; ++k)
+        magnitude[k] = 2.0 * std::abs(buffer[k]) / IMD_FFT_SIZE;
+    return magnitude;
+}
+
+int binOf(double freq) {
+    return static_cast<int>(std::lround(freq * IMD_FFT_SIZE / IMD_SAMPLE_RATE));
+}
+
+// SMPTE RP120: 60Hz + 7kHz, 4:1, peak-equivalent to a sine at the level.
+// IMD = RSS of the 7kHz +/- n*60Hz sidebands (n = 1..4) re the 7kHz carrier.
+double measureSMPTE(bool isAmpex, double levelDB) {
+    double peak = std::pow(10.0, levelDB / 20.0);
+    int low = binOf(60.0), high = binOf(7000.0);
+    auto spectrum = measureSpectrum(isAmpex, {{low, peak * 0.8, 0.0}, {high, peak * 0.2, 0.0}});
+
+    double sum = 0.0;
+    for (int n = 1; n <= 4; ++n)
+        sum += spectrum[high + n * low] * spectrum[high + n * low]
+             + spectrum[high - n * low] * spectrum[high - n * low];
+    return 100.0 * std::sqrt(sum) / spectrum[high];
+}
+
+// CCIF / IEC 60268 difference-frequency: 19kHz + 20kHz, 1:1.
+// IMD = RSS of d2 (f2-f1) and d3 (2f1-f2, 2f2-f1) re the sum of both tones.
+double measureCCIF(bool isAmpex, double levelDB) {
+    double peak = std::pow(10.0, levelDB / 20.0);
+    int f1 = binOf(19000.0), f2 = binOf(20000.0);
+    auto spectrum = measureSpectrum(isAmpex, {{f1, peak * 0.5, 0.0}, {f2, peak * 0.5, 0.0}});
+
+    double d2 = spectrum[f2 - f1];
+    double d3lo = spectrum[2 * f1 - f2];
+    double d3hi = spectrum[2 * f2 - f1];
+    return 100.0 * std::sqrt(d2 * d2 + d3lo * d3lo + d3hi * d3hi) / (spectrum[f1] + spectrum[f2]);
+}
+
+// 31-tone multitone (1/3-octave centres 20Hz-20kHz, Newman phases), RMS
+// equal to a sine at the level. Distortion = power in the non-tone bins
+// (20Hz-20kHz, +/-2 bins around each tone excluded) re the tone power, dB.
+double measureMultitone(bool isAmpex, double levelDB) {
+    const int numTones = 31;
+    double amplitude = std::pow(10.0, levelDB / 20.0) / std::sqrt(static_cast<double>(numTones));
+
+    std::vector<Tone> tones;
+    for (int k = 0; k < numTones; ++k) {
+        double freq = 20.0 * std::pow(2.0, k / 3.0);
+        tones.push_back({binOf(freq) | 1, amplitude, M_PI * k * k / numTones});
+    }
+
+    auto spectrum = measureSpectrum(isAmpex, tones);
+
+    std::vector<bool> excluded(spectrum.size(), false);
+    double tonePower = 0.0;
+    for (const auto& tone : tones) {
+        tonePower += spectrum[tone.bin] * spectrum[tone.bin];
+        for (int k = tone.bin - 2; k <= tone.bin + 2; ++k) excluded[k] = true;
+    }
+
+    double distortionPower = 0.0;
+    for (int k = binOf(20.0); k <= binOf(20000.0); ++k)
+        if (!excluded[k]) distortionPower += spectrum[k] * spectrum[k];
+
+    return 10.0 * std::log10(distortionPower / tonePower);
+}
+
+struct IMDResult {
+    double smpte[NUM_LEVELS];
+    double ccif[NUM_LEVELS];
+    double multitone[NUM_LEVELS];
+};
+
+// One job per machine x metric x level, spread over the available cores
+void measureIMD(IMDResult& ampex, IMDResult& studer) {
+    struct Job { bool isAmpex; int metric; int level; double* result; };
+    std::vector<Job> jobs;
+    for (int m = 0; m < 2; ++m) {
+        IMDResult& r = (m == 0) ? ampex : studer;
+        for (int l = 0; l < NUM_LEVELS; ++l) {
+            jobs.push_back({m == 0, 0, l, &r.smpte[l]});
+            jobs.push_back({m == 0, 1, l, &r.ccif[l]});
+            jobs.push_back({m == 0, 2, l, &r.multitone[l]});
+        }
+    }
+
+    std::atomic<size_t> next{0};
+    auto worker = [&]() {
+        for (size_t i = next++; i < jobs.size(); i = next++) {
+            const Job& job = jobs[i];
+            double level = imdLevels[job.level];
+            if (job.metric == 0)      *job.result = measureSMPTE(job.isAmpex, level);
+            else if (job.metric == 1) *job.result = measureCCIF(job.isAmpex, level);
+            else                      *job.result = measureMultitone(job.isAmpex, level);
+        }
+    };
+
+    std::vector<std::thread> workers;
+    unsigned numThreads = std::max(1u, std::thread::hardware_concurrency());
+    for (unsigned t = 0; t < numThreads; ++t) workers.emplace_back(worker);
+    for (auto& thread : workers) thread.join();
+}
+
+void printIMD(const char* name, const IMDResult& r) {
+    printf("%s:\n", name);
+    printf("  Level     SMPTE     CCIF      31-tone\n");
+    for (int l = 0; l < NUM_LEVELS; ++l)
+        printf("  %+4.0fdB   %6.3f%%   %6.4f%%   %6.1f dB\n",
+               imdLevels[l], r.smpte[l], r.ccif[l], r.multitone[l]);
+}
+
 int main() {
     std::cout << "=== Current Measurements ===\n\n";
     
@@ -106,6 +285,18 @@ int main() {
            ampex.thd_0/ampex.thd_m6, ampex.thd_3/ampex.thd_0, ampex.thd_6/ampex.thd_3);
     printf("STUDER: -6→0dB: %.1fx   0→+3dB: %.1fx   +3→+6dB: %.1fx\n", 
            studer.thd_0/studer.thd_m6, studer.thd_3/studer.thd_0, studer.thd_6/studer.thd_3);
-    
+
+    std::cout << "\n=== Harmonic Balance Cross-Check (100Hz steady state, solved directly) ===\n";
+    printHarmonicBalance("AMPEX", true, ampex);
+    printHarmonicBalance("STUDER", false, studer);
+
+    // Dense-material distortion - baselines recorded in TARGETS.md
+    std::cout << "\n=== Intermodulation & Multitone (96kHz, no oversampling) ===\n\n";
+    IMDResult ampexIMD, studerIMD;
+    measureIMD(ampexIMD, studerIMD);
+    printIMD("AMPEX ATR-102", ampexIMD);
+    std::cout << "\n";
+    printIMD("STUDER A820", studerIMD);
+
     return 0;
 }
@@ -0,0 +1,519 @@
+/**
+ * reference_match.cpp
+ *
+ * Calibrates the saturation tuning against real machine recordings.
+ *
+ * Each pair is a source file and the same material recorded through an
+ * ATR-102 / A820. The source is rendered through the core at the plugin's
+ * internal 2x rate, aligned to the tape recording by cross-correlation and
+ * scored on:
+ *   - Multi-resolution STFT distance (256/1024/4096) after least-squares gain match
+ *   - Harmonic distance: 1/3-octave dB difference of the nonlinear spectra
+ *     (output power not linearly predictable from the source, Welch
+ *     cross-spectra) - insensitive to EQ and phase, sensitive to distortion
+ *
+ * The score drives a (1+lambda) evolution strategy over the saturation
+ * tuning (HybridTapeProcessor::Tuning). Candidates are evaluated in parallel
+ * and cached by parameter hash. Only the core is rendered - the post stages
+ * (tolerance EQ, print-through, W&F) are not part of the match.
+ *
+ * Build (from repo root):
+ *   g++ -std=c++17 -O3 -pthread Tests/reference_match.cpp Source/DSP/HybridTapeProcessor.cpp \
+ *       Source/DSP/BiasShielding.cpp Source/DSP/MachineEQ.cpp Source/DSP/MachineProfile.cpp \
+ *       Source/DSP/TapeHiss.cpp -o reference_match
+ *
+ * Usage:
+ *   ./reference_match --machine ampex --pair source.wav atr102.wav [--pair ...]
+ *       [--drive dB] [--start s] [--seconds s] [--channel n] [--hiss]
+ *       [--generations n] [--threads n] [--render best.wav] [--write dir]
+ *
+ * The best tuning is printed as profile keys; --write saves the machine's
+ * whole profile with it (dir/ampex_atr102.profile or studer_a820.profile),
+ * ready to replace the copy in Profiles/ and the built-in values.
+ */
+
+#include <iostream>
+#include <fstream>
+#include <cstdio>
+#include <cstdlib>
+#include <atomic>
+#include <mutex>
+#include <random>
+#include <thread>
+#include <unordered_map>
+#include "AudioAnalysis.h"
+#include "../Source/DSP/HybridTapeProcessor.h"
+#include "../Source/DSP/TapeHiss.h"
+
+using namespace TapeHysteresis;
+using namespace AudioAnalysis;
+
+static constexpr double HARMONIC_WEIGHT = 0.1;   // Score per dB of harmonic distance
+static constexpr int NUM_TUNING_VALUES = 8;
+
+struct Options
+{
+    bool isAmpex = true;
+    std::vector<std::pair<std::string, std::string>> pairs;
+    double driveDB = 0.0;
+    double startSeconds = 0.0;
+    double seconds = 10.0;
+    int channel = 0;
+    bool hiss = false;
+    int generations = 40;
+    int threads = 0;
+    std::string renderPath;
+    std::string writeDir;
+};
+
+struct ReferencePair
+{
+    std::string name;
+    double sampleRate = 0.0;
+    std::vector<float> source;
+    std::vector<float> tape;              // Aligned to source
+    std::vector<double> tapeNonlinear;    // Nonlinear spectrum of tape vs source
+    int renderLag = 0;                    // Render latency (samples) vs source
+};
+
+// ============================================================================
+// TUNING <-> VECTOR
+// ============================================================================
+static void toArray(const HybridTapeProcessor::Tuning& t, double* v)
+{
+    v[0] = t.jaBlendMax;   v[1] = t.jaBlendThreshold; v[2] = t.jaBlendWidth;
+    v[3] = t.atanMix;      v[4] = t.atanThreshold;    v[5] = t.atanWidth;
+    v[6] = t.atanDrive;    v[7] = t.inputBias;
+}
+
+static HybridTapeProcessor::Tuning fromArray(const double* v)
+{
+    HybridTapeProcessor::Tuning t;
+    t.jaBlendMax = v[0];   t.jaBlendThreshold = v[1]; t.jaBlendWidth = v[2];
+    t.atanMix = v[3];      t.atanThreshold = v[4];    t.atanWidth = v[5];
+    t.atanDrive = v[6];    t.inputBias = v[7];
+    return t;
+}
+
+// FNV-1a over the quantized values - identical candidates share a cache entry
+static uint64_t hashTuning(const HybridTapeProcessor::Tuning& tuning, bool isAmpex)
+{
+    double v[NUM_TUNING_VALUES];
+    toArray(tuning, v);
+
+    uint64_t hash = 1469598103934665603ULL ^ (isAmpex ? 1u : 2u);
+    for (double value : v)
+    {
+        long long quantized = std::llround(value * 1e9);
+        for (int b = 0; b < 8; ++b)
+        {
+            hash ^= static_cast<uint64_t>((quantized >> (8 * b)) & 0xFF);
+            hash *= 1099511628211ULL;
+        }
+    }
+    return hash;
+}
+
+class ScoreCache
+{
+public:
+    bool find(uint64_t key, double& score)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto it = scores.find(key);
+        if (it == scores.end())
+            return false;
+        score = it->second;
+        ++hits;
+        return true;
+    }
+
+    void store(uint64_t key, double score)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        scores[key] = score;
+    }
+
+    int getHits() const { return hits; }
+    size_t size() const { return scores.size(); }
+
+private:
+    std::mutex mutex;
+    std::unordered_map<uint64_t, double> scores;
+    int hits = 0;
+};
+
+// ============================================================================
+// RENDER + SCORE
+// ============================================================================
+static std::vector<float> render(const std::vector<float>& source, double sampleRate, bool isAmpex,
+                                 double drive, const HybridTapeProcessor::Tuning* tuning, bool hiss)
+{
+    const Oversampler resampler(HybridTapeProcessor::getOversamplingFactor(sampleRate));
+
+    HybridTapeProcessor processor;
+    processor.setSampleRate(sampleRate * resampler.getFactor());
+    processor.setParameters(isAmpex ? 0.5 : 0.8, drive);
+    if (tuning != nullptr)
+        processor.setTuning(*tuning);
+    processor.reset();
+
+    std::vector<double> oversampled = resampler.upsample(source);
+    processor.processBlock(oversampled.data(), static_cast<int>(oversampled.size()));
+
+    std::vector<float> output = resampler.downsample(oversampled);
+
+    if (hiss)
+    {
+        TapeHiss tapeHiss(1u);
+        tapeHiss.setSampleRate(sampleRate);
+        tapeHiss.setMachineMode(isAmpex);
+        tapeHiss.setBreathing(0.5);
+        tapeHiss.reset();
+        tapeHiss.process(output.data(), nullptr, static_cast<int>(output.size()));
+    }
+
+    return output;
+}
+
+// Shifts by lag (output[i] = input[i + lag]), zero-filling outside
+static std::vector<float> shift(const std::vector<float>& input, int lag, size_t length)
+{
+    std::vector<float> output(length, 0.0f);
+    for (size_t i = 0; i < length; ++i)
+    {
+        long src = static_cast<long>(i) + lag;
+        if (src >= 0 && src < static_cast<long>(input.size()))
+            output[i] = input[src];
+    }
+    return output;
+}
+
+struct Score
+{
+    double stft = 0.0;
+    double harmonicDB = 0.0;
+    double total = 0.0;
+};
+
+static Score scorePair(const ReferencePair& pair, const std::vector<float>& rendered)
+{
+    std::vector<float> aligned = shift(rendered, pair.renderLag, pair.source.size());
+
+    // Least-squares gain match (recording level is arbitrary)
+    double cross = 0.0, power = 0.0;
+    for (size_t i = 0; i < aligned.size(); ++i)
+    {
+        cross += static_cast<double>(aligned[i]) * pair.tape[i];
+        power += static_cast<double>(aligned[i]) * aligned[i];
+    }
+    float gain = static_cast<float>(power > 0.0 ? cross / power : 1.0);
+    for (float& sample : aligned)
+        sample *= gain;
+
+    Score score;
+    score.stft = multiResolutionSTFTDistance(pair.tape, aligned);
+    score.harmonicDB = bandedDistanceDB(pair.tapeNonlinear, nonlinearSpectrum(pair.source, aligned), pair.sampleRate);
+    score.total = score.stft + HARMONIC_WEIGHT * score.harmonicDB;
+    return score;
+}
+
+static Score evaluate(const std::vector<ReferencePair>& pairs, const Options& options,
+                      const HybridTapeProcessor::Tuning& tuning)
+{
+    Score mean;
+    const double drive = std::pow(10.0, options.driveDB / 20.0);
+
+    for (const auto& pair : pairs)
+    {
+        Score score = scorePair(pair, render(pair.source, pair.sampleRate, options.isAmpex, drive, &tuning, options.hiss));
+        mean.stft += score.stft / pairs.size();
+        mean.harmonicDB += score.harmonicDB / pairs.size();
+        mean.total += score.total / pairs.size();
+    }
+
+    return mean;
+}
+
+// Evaluates all candidates on a pool of worker threads, consulting the cache first
+static std::vector<double> evaluateAll(const std::vector<HybridTapeProcessor::Tuning>& candidates,
+                                       const std::vector<ReferencePair>& pairs, const Options& options,
+                                       ScoreCache& cache, int numThreads)
+{
+    std::vector<double> scores(candidates.size());
+    std::atomic<size_t> next{0};
+
+    auto worker = [&]() {
+        for (size_t i = next++; i < candidates.size(); i = next++)
+        {
+            uint64_t key = hashTuning(candidates[i], options.isAmpex);
+            if (!cache.find(key, scores[i]))
+            {
+                scores[i] = evaluate(pairs, options, candidates[i]).total;
+                cache.store(key, scores[i]);
+            }
+        }
+    };
+
+    std::vector<std::thread> workers;
+    int count = std::min(numThreads, static_cast<int>(candidates.size()));
+    for (int t = 0; t < count; ++t)
+        workers.emplace_back(worker);
+    for (auto& thread : workers)
+        thread.join();
+
+    return scores;
+}
+
+// ============================================================================
+// SETUP
+// ============================================================================
+static bool parseArguments(int argc, char** argv, Options& options)
+{
+    for (int i = 1; i < argc; ++i)
+    {
+        std::string arg = argv[i];
+        auto hasValue = [&](int count) { return i + count < argc; };
+
+        if (arg == "--machine" && hasValue(1))
+            options.isAmpex = (std::string(argv[++i]) != "studer");
+        else if (arg == "--pair" && hasValue(2))
+        {
+            options.pairs.emplace_back(argv[i + 1], argv[i + 2]);
+            i += 2;
+        }
+        else if (arg == "--drive" && hasValue(1))       options.driveDB = std::atof(argv[++i]);
+        else if (arg == "--start" && hasValue(1))       options.startSeconds = std::atof(argv[++i]);
+        else if (arg == "--seconds" && hasValue(1))     options.seconds = std::atof(argv[++i]);
+        else if (arg == "--channel" && hasValue(1))     options.channel = std::atoi(argv[++i]);
+        else if (arg == "--generations" && hasValue(1)) options.generations = std::atoi(argv[++i]);
+        else if (arg == "--threads" && hasValue(1))     options.threads = std::atoi(argv[++i]);
+        else if (arg == "--render" && hasValue(1))      options.renderPath = argv[++i];
+        else if (arg == "--write" && hasValue(1))       options.writeDir = argv[++i];
+        else if (arg == "--hiss")                       options.hiss = true;
+        else
+        {
+            std::cerr << "Unknown or incomplete argument: " << arg << "\n";
+            return false;
+        }
+    }
+
+    return !options.pairs.empty();
+}
+
+static std::vector<float> extract(const WavFile& wav, int channel, double startSeconds, double seconds)
+{
+    const std::vector<float>& data = wav.channels[std::min(channel, wav.getNumChannels() - 1)];
+    size_t start = std::min(data.size(), static_cast<size_t>(startSeconds * wav.sampleRate));
+    size_t end = std::min(data.size(), start + static_cast<size_t>(seconds * wav.sampleRate));
+    return std::vector<float>(data.begin() + start, data.begin() + end);
+}
+
+static bool loadPair(const std::string& sourcePath, const std::string& tapePath, const Options& options,
+                     ReferencePair& pair)
+{
+    WavFile sourceWav, tapeWav;
+    std::string error;
+    if (!readWav(sourcePath, sourceWav, error) || !readWav(tapePath, tapeWav, error))
+    {
+        std::cerr << error << "\n";
+        return false;
+    }
+
+    if (sourceWav.sampleRate != tapeWav.sampleRate)
+    {
+        std::cerr << tapePath << ": sample rate differs from " << sourcePath << "\n";
+        return false;
+    }
+
+    pair.name = tapePath;
+    pair.sampleRate = sourceWav.sampleRate;
+    pair.source = extract(sourceWav, options.channel, options.startSeconds, options.seconds);
+    std::vector<float> tape = extract(tapeWav, options.channel, options.startSeconds, options.seconds + 1.0);
+
+    const int maxLag = static_cast<int>(0.5 * pair.sampleRate);
+    bool inverted = false;
+
+    // Tape vs source (transfer/capture offset)
+    int tapeLag = findLag(pair.source, tape, maxLag, &inverted);
+    pair.tape = shift(tape, tapeLag, pair.source.size());
+    if (inverted)
+        for (float& sample : pair.tape)
+            sample = -sample;
+
+    // Score only where both recordings have material
+    size_t validStart = static_cast<size_t>(std::max(0, -tapeLag));
+    size_t validEnd = std::min(pair.source.size(), static_cast<size_t>(std::max<long>(0, static_cast<long>(tape.size()) - tapeLag)));
+    if (validEnd <= validStart + static_cast<size_t>(pair.sampleRate))
+    {
+        std::cerr << tapePath << ": less than 1s of overlap with " << sourcePath << "\n";
+        return false;
+    }
+    pair.source = std::vector<float>(pair.source.begin() + validStart, pair.source.begin() + validEnd);
+    pair.tape = std::vector<float>(pair.tape.begin() + validStart, pair.tape.begin() + validEnd);
+
+    // Renderer vs source (resampler + core group delay) - constant across tunings
+    std::vector<float> rendered = render(pair.source, pair.sampleRate, options.isAmpex,
+                                         std::pow(10.0, options.driveDB / 20.0), nullptr, false);
+    pair.renderLag = findLag(pair.source, rendered, maxLag);
+
+    pair.tapeNonlinear = nonlinearSpectrum(pair.source, pair.tape);
+
+    std::printf("  %s: %.1fs @ %.1fkHz, tape lag %+d%s, render lag %+d\n",
+                tapePath.c_str(), pair.source.size() / pair.sampleRate, pair.sampleRate / 1000.0,
+                tapeLag, inverted ? " (inverted)" : "", pair.renderLag);
+    return true;
+}
+
+// The machine's built-in profile with the tuning in place
+static MachineProfile tunedProfile(bool isAmpex, const HybridTapeProcessor::Tuning& t)
+{
+    MachineProfile profile = isAmpex ? MachineProfile::ampexATR102() : MachineProfile::studerA820();
+    profile.jaBlendMax = t.jaBlendMax;
+    profile.jaBlendThreshold = t.jaBlendThreshold;
+    profile.jaBlendWidth = t.jaBlendWidth;
+    profile.atanMix = t.atanMix;
+    profile.atanThreshold = t.atanThreshold;
+    profile.atanWidth = t.atanWidth;
+    profile.atanDrive = t.atanDrive;
+    profile.inputBias = t.inputBias;
+    return profile;
+}
+
+// Profile keys (MachineProfile::toText)
+static void printTuning(const HybridTapeProcessor::Tuning& t)
+{
+    std::printf("    ja.blendMax = %.6g\n", t.jaBlendMax);
+    std::printf("    ja.blendThreshold = %.6g\n", t.jaBlendThreshold);
+    std::printf("    ja.blendWidth = %.6g\n", t.jaBlendWidth);
+    std::printf("    atan.mix = %.6g\n", t.atanMix);
+    std::printf("    atan.threshold = %.6g\n", t.atanThreshold);
+    std::printf("    atan.width = %.6g\n", t.atanWidth);
+    std::printf("    atan.drive = %.6g\n", t.atanDrive);
+    std::printf("    inputBias = %.6g\n", t.inputBias);
+}
+
+// ============================================================================
+// MAIN
+// ============================================================================
+int main(int argc, char** argv)
+{
+    Options options;
+    if (!parseArguments(argc, argv, options))
+    {
+        std::cerr << "Usage: reference_match --machine ampex|studer --pair source.wav tape.wav [--pair ...]\n"
+                  << "           [--drive dB] [--start s] [--seconds s] [--channel n] [--hiss]\n"
+                  << "           [--generations n] [--threads n] [--render best.wav] [--write dir]\n";
+        return 1;
+    }
+
+    int numThreads = options.threads > 0 ? options.threads
+                                         : std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+
+    std::cout << "=== Reference Match: " << (options.isAmpex ? "AMPEX ATR-102" : "STUDER A820") << " ===\n\n";
+
+    std::vector<ReferencePair> pairs;
+    for (const auto& files : options.pairs)
+    {
+        ReferencePair pair;
+        if (!loadPair(files.first, files.second, options, pair))
+            return 1;
+        pairs.push_back(std::move(pair));
+    }
+
+    // Start from the calibrated defaults
+    HybridTapeProcessor defaults;
+    defaults.setParameters(options.isAmpex ? 0.5 : 0.8, 1.0);
+    HybridTapeProcessor::Tuning best = defaults.getTuning();
+
+    Score initial = evaluate(pairs, options, best);
+    double bestScore = initial.total;
+    std::printf("\n  Defaults: score %.4f (STFT %.4f, harmonic %.2f dB)\n\n",
+                initial.total, initial.stft, initial.harmonicDB);
+
+    // (1+lambda) evolution strategy, 1/5th success rule on the step size.
+    // Positive values mutate in log space, inputBias additively.
+    ScoreCache cache;
+    std::mt19937 rng(1);
+    std::normal_distribution<double> normal(0.0, 1.0);
+    const int lambda = std::max(8, numThreads);
+    double sigma = 0.25;
+
+    for (int generation = 0; generation < options.generations; ++generation)
+    {
+        double base[NUM_TUNING_VALUES];
+        toArray(best, base);
+
+        std::vector<HybridTapeProcessor::Tuning> candidates;
+        for (int c = 0; c < lambda; ++c)
+        {
+            double v[NUM_TUNING_VALUES];
+            for (int k = 0; k < NUM_TUNING_VALUES; ++k)
+            {
+                if (k == NUM_TUNING_VALUES - 1)
+                    v[k] = std::clamp(base[k] + 0.1 * sigma * normal(rng), -0.5, 0.5);
+                else
+                    v[k] = base[k] * std::exp(sigma * normal(rng));
+            }
+            candidates.push_back(fromArray(v));
+        }
+
+        std::vector<double> scores = evaluateAll(candidates, pairs, options, cache, numThreads);
+
+        int successes = 0;
+        for (size_t c = 0; c < candidates.size(); ++c)
+        {
+            if (scores[c] < bestScore)
+            {
+                ++successes;
+                bestScore = scores[c];
+                best = candidates[c];
+            }
+        }
+
+        sigma *= (successes * 5 > lambda) ? 1.22 : 0.82;
+        std::printf("  Gen %3d: best %.4f  sigma %.3f  (%d improved, cache %zu / %d hits)\n",
+                    generation + 1, bestScore, sigma, successes, cache.size(), cache.getHits());
+
+        if (sigma < 1e-3)
+            break;
+    }
+
+    Score final = evaluate(pairs, options, best);
+    std::printf("\n  Best: score %.4f (STFT %.4f, harmonic %.2f dB), %.1f%% better than defaults\n\n",
+                final.total, final.stft, final.harmonicDB, 100.0 * (1.0 - final.total / initial.total));
+
+    std::cout << "  Tuning (" << (options.isAmpex ? "Profiles/ampex_atr102.profile" : "Profiles/studer_a820.profile")
+              << " keys, then re-check param_search):\n";
+    printTuning(best);
+
+    if (!options.writeDir.empty())
+    {
+        const std::string path = options.writeDir + (options.isAmpex ? "/ampex_atr102.profile" : "/studer_a820.profile");
+        std::ofstream file(path);
+        file << tunedProfile(options.isAmpex, best).toText();
+        if (!file)
+        {
+            std::cerr << "Cannot write " << path << "\n";
+            return 1;
+        }
+        std::cout << "\n  Wrote " << path << "\n";
+    }
+
+    if (!options.renderPath.empty())
+    {
+        WavFile out;
+        out.sampleRate = pairs[0].sampleRate;
+        out.channels.push_back(shift(render(pairs[0].source, pairs[0].sampleRate, options.isAmpex,
+                                            std::pow(10.0, options.driveDB / 20.0), &best, options.hiss),
+                                     pairs[0].renderLag, pairs[0].source.size()));
+        if (!writeWav(options.renderPath, out))
+        {
+            std::cerr << "Failed to write " << options.renderPath << "\n";
+            return 1;
+        }
+        std::cout << "\n  Rendered " << pairs[0].name << " with best tuning -> " << options.renderPath << "\n";
+    }
+
+    return 0;
+}
@@ -0,0 +1,476 @@
+/**
+ * target_fit.cpp
+ *
+ * Fits a machine profile's saturation constants to the THD / E/O targets
+ * of TARGETS.md by gradient descent (Levenberg-Marquardt).
+ *
+ * Every evaluation solves the -6 / 0 / +6 dB steady states at 100 Hz,
+ * 96 kHz (the param_search measurement) by harmonic balance, with the exact
+ * gradient of every harmonic with respect to the free parameters
+ * (HarmonicBalance::Gradient - dual numbers and implicit differentiation,
+ * no finite differences). An iteration costs three solves, not a sweep of
+ * renders. Residuals are log ratios to the targets: THD at each level and
+ * H2 / H3 at 0 dB. With more free parameters than targets, a small pull
+ * towards the starting values picks the nearest fit. The result is
+ * confirmed by the time-domain render param_search uses.
+ *
+ * Free parameters: the saturation tuning (HybridTapeProcessor::Tuning);
+ * with --ja also the J-A constants and scales.
+ *
+ * Build (from repo root):
+ *   g++ -std=c++17 -O2 Tests/target_fit.cpp Source/DSP/HybridTapeProcessor.cpp \
+ *       Source/DSP/BiasShielding.cpp Source/DSP/MachineEQ.cpp Source/DSP/MachineProfile.cpp \
+ *       Source/DSP/HarmonicBalance.cpp -o target_fit
+ *
+ * Usage:
+ *   ./target_fit [--machine ampex|studer] [--profile file] [--ja] [--perturb fraction]
+ *       [--iterations n] [--write dir]
+ */
+
+#include <iostream>
+#include <cstdio>
+#include <cstdlib>
+#include <chrono>
+#include <fstream>
+#include <random>
+#include <string>
+#include <vector>
+#include "../Source/DSP/HybridTapeProcessor.h"
+#include "../Source/DSP/HarmonicBalance.h"
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+using namespace TapeHysteresis;
+
+// ============================================================================
+// TARGETS (TARGETS.md, 30 IPS)
+// ============================================================================
+static constexpr double SAMPLE_RATE = 96000.0;
+static constexpr double TEST_FREQ = 100.0;
+static constexpr int NUM_LEVELS = 3;
+static const double levels[NUM_LEVELS] = { -6.0, 0.0, 6.0 };
+static constexpr int EO_LEVEL = 1;                     // E/O at 0 dB
+static constexpr int NUM_RESIDUALS = NUM_LEVELS + 1;
+
+struct Targets
+{
+    double thd[NUM_LEVELS];     // Percent
+    double evenOdd;             // H2 / H3
+};
+
+static const Targets ampexTargets = { { 0.02, 0.08, 0.40 }, 0.50 };
+static const Targets studerTargets = { { 0.07, 0.25, 1.25 }, 1.12 };
+
+static constexpr double PRIOR_WEIGHT = 1e-3;           // Pull towards the start, per unit relative change
+static constexpr double TOLERANCE = 1e-3;              // Every residual within 0.1%
+
+// Valid range per HarmonicBalance::Parameter (the core clamps or divides by these)
+struct Bounds { double low, high; };
+static const Bounds bounds[HarmonicBalance::NUM_PARAMETERS] = {
+    { 1e-6, 1e9 },      // ja.M_s
+    { 1e-6, 1e9 },      // ja.a
+    { 1e-6, 1e9 },      // ja.k
+    { 0.0, 0.999 },     // ja.c
+    { 0.0, 1.0 },       // ja.alpha
+    { 1e-6, 1e9 },      // jaInputScale
+    { 1e-6, 1e9 },      // jaOutputScale
+    { 0.0, 1.0 },       // jaBlendMax
+    { -10.0, 10.0 },    // jaBlendThreshold
+    { 1e-3, 10.0 },     // jaBlendWidth (0 = constant blend, a different curve)
+    { 0.0, 1.0 },       // atanMix
+    { -10.0, 10.0 },    // atanThreshold
+    { 1e-3, 10.0 },     // atanWidth
+    { 0.0, 20.0 },      // atanDrive
+    { -1.0, 1.0 },      // inputBias
+};
+
+// ============================================================================
+// EVALUATION
+// ============================================================================
+struct Evaluation
+{
+    bool converged = false;
+    double thd[NUM_LEVELS] = {};
+    double evenOdd = 0.0;
+    double residual[NUM_RESIDUALS] = {};
+    std::vector<double> jacobian;          // NUM_RESIDUALS x free, d residual / d (relative change)
+};
+
+static void configure(HybridTapeProcessor& processor, const MachineProfile& profile, bool isAmpex)
+{
+    processor.setSampleRate(SAMPLE_RATE);
+    processor.setParameters(isAmpex ? 0.5 : 0.8, 1.0);
+    processor.setMachineProfile(isAmpex ? HybridTapeProcessor::Slot::Master : HybridTapeProcessor::Slot::Tracks,
+                                profile);
+}
+
+static Evaluation evaluate(const MachineProfile& profile, bool isAmpex, const Targets& targets,
+                           const std::vector<int>& free, const std::vector<double>& scale)
+{
+    HybridTapeProcessor processor;
+    configure(processor, profile, isAmpex);
+
+    const int numFree = static_cast<int>(free.size());
+    Evaluation evaluation;
+    evaluation.converged = true;
+    evaluation.jacobian.assign(static_cast<size_t>(NUM_RESIDUALS * numFree), 0.0);
+
+    for (int i = 0; i < NUM_LEVELS; ++i)
+    {
+        HarmonicBalance::Gradient gradient;
+        const auto result = HarmonicBalance::solve(processor, TEST_FREQ, std::pow(10.0, levels[i] / 20.0),
+                                                   HarmonicBalance::Options(), gradient);
+        evaluation.converged = evaluation.converged && result.converged;
+
+        const double thd = result.thdPercent();
+        evaluation.thd[i] = thd;
+        evaluation.residual[i] = std::log(thd / targets.thd[i]);
+        for (int j = 0; j < numFree; ++j)
+            evaluation.jacobian[i * numFree + j] = gradient.thdPercent(result, free[j]) / thd * scale[j];
+
+        if (i != EO_LEVEL)
+            continue;
+
+        // log(H2 / H3): d = dH2 / H2 - dH3 / H3
+        const double h2 = result.amplitude[2], h3 = result.amplitude[3];
+        evaluation.evenOdd = h2 / h3;
+        evaluation.residual[NUM_LEVELS] = std::log(evaluation.evenOdd / targets.evenOdd);
+        for (int j = 0; j < numFree; ++j)
+            evaluation.jacobian[NUM_LEVELS * numFree + j] =
+                (gradient.amplitude[free[j]][2] / h2 - gradient.amplitude[free[j]][3] / h3) * scale[j];
+    }
+
+    return evaluation;
+}
+
+// Same levels rendered and measured as param_search does: settled, 100 cycles
+static void simulate(const MachineProfile& profile, bool isAmpex, double* thd, double& evenOdd)
+{
+    HybridTapeProcessor processor;
+    configure(processor, profile, isAmpex);
+
+    const int period = static_cast<int>(SAMPLE_RATE / TEST_FREQ);
+    const int n = 100 * period;
+
+    for (int i = 0; i < NUM_LEVELS; ++i)
+    {
+        const double amplitude = std::pow(10.0, levels[i] / 20.0);
+        std::vector<double> signal(n);
+        for (int j = 0; j < n; ++j)
+            signal[j] = amplitude * std::sin(2.0 * M_PI * TEST_FREQ * j / SAMPLE_RATE);
+        processor.settle(signal.data(), period);
+        processor.processBlock(signal.data(), n);
+
+        double harmonics[6] = {};
+        for (int h = 1; h <= 5; ++h)
+        {
+            double sumCos = 0.0, sumSin = 0.0;
+            for (int j = 0; j < n; ++j)
+            {
+                const double phase = 2.0 * M_PI * TEST_FREQ * h * j / SAMPLE_RATE;
+                sumCos += signal[j] * std::cos(phase);
+                sumSin += signal[j] * std::sin(phase);
+            }
+            harmonics[h] = 2.0 * std::sqrt(sumCos * sumCos + sumSin * sumSin) / n;
+        }
+
+        double sum = 0.0;
+        for (int h = 2; h <= 5; ++h)
+            sum += harmonics[h] * harmonics[h];
+        thd[i] = 100.0 * std::sqrt(sum) / harmonics[1];
+        if (i == EO_LEVEL)
+            evenOdd = harmonics[2] / harmonics[3];
+    }
+}
+
+// ============================================================================
+// LEVENBERG-MARQUARDT
+// ============================================================================
+// Gaussian elimination with partial pivoting (a: n x n row-major, b replaced)
+static bool solveLinear(std::vector<double> a, std::vector<double>& b, int n)
+{
+    for (int col = 0; col < n; ++col)
+    {
+        int pivot = col;
+        for (int row = col + 1; row < n; ++row)
+            if (std::abs(a[row * n + col]) > std::abs(a[pivot * n + col]))
+                pivot = row;
+        if (std::abs(a[pivot * n + col]) < 1e-300)
+            return false;
+
+        for (int j = 0; j < n; ++j)
+            std::swap(a[col * n + j], a[pivot * n + j]);
+        std::swap(b[col], b[pivot]);
+
+        for (int row = col + 1; row < n; ++row)
+        {
+            const double factor = a[row * n + col] / a[col * n + col];
+            for (int j = col; j < n; ++j)
+                a[row * n + j] -= factor * a[col * n + j];
+            b[row] -= factor * b[col];
+        }
+    }
+
+    for (int row = n - 1; row >= 0; --row)
+    {
+        double sum = b[row];
+        for (int j = row + 1; j < n; ++j)
+            sum -= a[row * n + j] * b[j];
+        b[row] = sum / a[row * n + row];
+    }
+    return true;
+}
+
+// |r|^2 + PRIOR_WEIGHT^2 |u|^2, u: relative change from the start
+static double cost(const Evaluation& evaluation, const std::vector<double>& u)
+{
+    double sum = 0.0;
+    for (double r : evaluation.residual)
+        sum += r * r;
+    for (double x : u)
+        sum += PRIOR_WEIGHT * PRIOR_WEIGHT * x * x;
+    return sum;
+}
+
+static double worstResidual(const Evaluation& evaluation)
+{
+    double worst = 0.0;
+    for (double r : evaluation.residual)
+        worst = std::max(worst, std::abs(r));
+    return worst;
+}
+
+static void printRow(int iteration, const Evaluation& evaluation, double currentCost, double lambda)
+{
+    std::printf("  %4d  %10.3e   %7.4f%%  %7.4f%%  %7.4f%%   %5.3f   %8.1e%s\n", iteration, currentCost,
+                evaluation.thd[0], evaluation.thd[1], evaluation.thd[2], evaluation.evenOdd, lambda,
+                evaluation.converged ? "" : "  (not converged)");
+}
+
+// ============================================================================
+// SETUP
+// ============================================================================
+struct Options
+{
+    bool ampex = true;
+    bool studer = true;
+    std::string profilePath;
+    bool fitJa = false;
+    double perturb = 0.0;
+    int iterations = 30;
+    std::string writeDir;
+};
+
+static bool parseArguments(int argc, char** argv, Options& options)
+{
+    for (int i = 1; i < argc; ++i)
+    {
+        std::string arg = argv[i];
+        auto hasValue = [&](int count) { return i + count < argc; };
+
+        if (arg == "--machine" && hasValue(1))
+        {
+            std::string machine = argv[++i];
+            if (machine != "ampex" && machine != "studer")
+            {
+                std::cerr << "Unknown machine: " << machine << "\n";
+                return false;
+            }
+            options.ampex = (machine == "ampex");
+            options.studer = !options.ampex;
+        }
+        else if (arg == "--profile" && hasValue(1))     options.profilePath = argv[++i];
+        else if (arg == "--ja")                         options.fitJa = true;
+        else if (arg == "--perturb" && hasValue(1))     options.perturb = std::atof(argv[++i]);
+        else if (arg == "--iterations" && hasValue(1))  options.iterations = std::atoi(argv[++i]);
+        else if (arg == "--write" && hasValue(1))       options.writeDir = argv[++i];
+        else
+        {
+            std::cerr << "Unknown or incomplete argument: " << arg << "\n";
+            return false;
+        }
+    }
+
+    if (!options.profilePath.empty() && options.ampex && options.studer)
+    {
+        std::cerr << "--profile needs --machine\n";
+        return false;
+    }
+    return true;
+}
+
+// ============================================================================
+// FIT
+// ============================================================================
+static bool fit(bool isAmpex, const Options& options)
+{
+    const Targets& targets = isAmpex ? ampexTargets : studerTargets;
+    MachineProfile start = isAmpex ? MachineProfile::ampexATR102() : MachineProfile::studerA820();
+
+    if (!options.profilePath.empty())
+    {
+        std::string error;
+        if (!MachineProfile::loadFile(options.profilePath, start, error))
+        {
+            std::cerr << options.profilePath << ": " << error << "\n";
+            return false;
+        }
+    }
+
+    std::vector<int> free;
+    for (int m = options.fitJa ? 0 : HarmonicBalance::JaBlendMax; m < HarmonicBalance::NUM_PARAMETERS; ++m)
+        free.push_back(m);
+    const int numFree = static_cast<int>(free.size());
+
+    // Optional scrambled start (fixed seed), to exercise the fit
+    std::mt19937 random(1);
+    std::uniform_real_distribution<double> unit(-1.0, 1.0);
+    for (int m : free)
+    {
+        double& value = HarmonicBalance::getParameter(start, m);
+        value = std::clamp(value * (1.0 + options.perturb * unit(random)), bounds[m].low, bounds[m].high);
+    }
+
+    // Steps are relative changes: p = p0 + scale u
+    std::vector<double> scale(numFree);
+    for (int j = 0; j < numFree; ++j)
+        scale[j] = std::max(std::abs(HarmonicBalance::getParameter(start, free[j])), 1e-3);
+
+    std::printf("\n=== Target Fit: %s (%d free parameters) ===\n\n", start.name.c_str(), numFree);
+    std::printf("  Targets: THD %.3f%% / %.3f%% / %.3f%% at -6 / 0 / +6 dB, E/O %.2f\n\n",
+                targets.thd[0], targets.thd[1], targets.thd[2], targets.evenOdd);
+    std::printf("  Iter  Cost         THD -6dB   0dB       +6dB      E/O     lambda\n");
+
+    auto clock = std::chrono::steady_clock::now();
+    MachineProfile current = start;
+    std::vector<double> u(numFree, 0.0);
+    Evaluation evaluation = evaluate(current, isAmpex, targets, free, scale);
+    double currentCost = cost(evaluation, u);
+    double lambda = 1e-3;
+    int solves = NUM_LEVELS;
+    int iteration = 0;
+
+    printRow(0, evaluation, currentCost, lambda);
+
+    while (iteration < options.iterations && worstResidual(evaluation) > TOLERANCE)
+    {
+        ++iteration;
+
+        // (J'J + w^2 I + lambda diag) du = -(J'r + w^2 u)
+        std::vector<double> normal(static_cast<size_t>(numFree * numFree), 0.0), rhs(numFree, 0.0);
+        for (int a = 0; a < numFree; ++a)
+        {
+            for (int b = 0; b < numFree; ++b)
+                for (int i = 0; i < NUM_RESIDUALS; ++i)
+                    normal[a * numFree + b] += evaluation.jacobian[i * numFree + a] * evaluation.jacobian[i * numFree + b];
+            normal[a * numFree + a] += PRIOR_WEIGHT * PRIOR_WEIGHT;
+            for (int i = 0; i < NUM_RESIDUALS; ++i)
+                rhs[a] -= evaluation.jacobian[i * numFree + a] * evaluation.residual[i];
+            rhs[a] -= PRIOR_WEIGHT * PRIOR_WEIGHT * u[a];
+        }
+
+        bool accepted = false;
+        for (int attempt = 0; attempt < 10 && !accepted; ++attempt)
+        {
+            std::vector<double> damped = normal, step = rhs;
+            for (int a = 0; a < numFree; ++a)
+                damped[a * numFree + a] *= 1.0 + lambda;
+            if (!solveLinear(damped, step, numFree))
+            {
+                lambda *= 10.0;
+                continue;
+            }
+
+            MachineProfile trial = start;
+            std::vector<double> trialU(numFree);
+            for (int j = 0; j < numFree; ++j)
+            {
+                const int m = free[j];
+                const double value = HarmonicBalance::getParameter(start, m) + scale[j] * (u[j] + step[j]);
+                HarmonicBalance::getParameter(trial, m) = std::clamp(value, bounds[m].low, bounds[m].high);
+                trialU[j] = (HarmonicBalance::getParameter(trial, m) - HarmonicBalance::getParameter(start, m)) / scale[j];
+            }
+
+            Evaluation trialEvaluation = evaluate(trial, isAmpex, targets, free, scale);
+            solves += NUM_LEVELS;
+            const double trialCost = cost(trialEvaluation, trialU);
+
+            if (trialEvaluation.converged && trialCost < currentCost)
+            {
+                current = trial;
+                u = trialU;
+                evaluation = trialEvaluation;
+                currentCost = trialCost;
+                lambda = std::max(lambda / 3.0, 1e-9);
+                accepted = true;
+            }
+            else
+            {
+                lambda *= 4.0;
+            }
+        }
+
+        printRow(iteration, evaluation, currentCost, lambda);
+        if (!accepted)
+            break;
+    }
+
+    const double elapsed = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - clock).count();
+    const bool reached = worstResidual(evaluation) <= TOLERANCE;
+    std::printf("\n  %s after %d iterations (%d steady-state solves, %.0f ms)\n",
+                reached ? "Targets met" : "Stopped", iteration, solves, elapsed);
+
+    std::printf("\n  Parameter          Start          Fitted\n");
+    for (int m : free)
+        std::printf("  %-16s %12.6g   %12.6g\n", HarmonicBalance::getParameterName(m),
+                    HarmonicBalance::getParameter(start, m), HarmonicBalance::getParameter(current, m));
+
+    // Confirm on the time-domain core
+    double simulatedTHD[NUM_LEVELS], simulatedEO = 0.0;
+    simulate(current, isAmpex, simulatedTHD, simulatedEO);
+
+    std::printf("\n  Level    Target    Balance   Simulated\n");
+    for (int i = 0; i < NUM_LEVELS; ++i)
+        std::printf("  %+3.0fdB   %6.3f%%   %6.3f%%   %6.3f%%\n", levels[i], targets.thd[i], evaluation.thd[i],
+                    simulatedTHD[i]);
+    std::printf("  E/O      %6.3f    %6.3f    %6.3f\n", targets.evenOdd, evaluation.evenOdd, simulatedEO);
+
+    if (!options.writeDir.empty())
+    {
+        const std::string path = options.writeDir + (isAmpex ? "/ampex_atr102.profile" : "/studer_a820.profile");
+        std::ofstream file(path);
+        file << current.toText();
+        if (!file)
+        {
+            std::cerr << "Cannot write " << path << "\n";
+            return false;
+        }
+        std::printf("\n  Wrote %s\n", path.c_str());
+    }
+
+    return reached;
+}
+
+// ============================================================================
+// MAIN
+// ============================================================================
+int main(int argc, char** argv)
+{
+    Options options;
+    if (!parseArguments(argc, argv, options))
+    {
+        std::cerr << "Usage: target_fit [--machine ampex|studer] [--profile file] [--ja] [--perturb fraction]\n"
+                     "                  [--iterations n] [--write dir]\n";
+        return 1;
+    }
+
+    bool reached = true;
+    if (options.ampex)
+        reached = fit(true, options) && reached;
+    if (options.studer)
+        reached = fit(false, options) && reached;
+
+    return reached ? 0 : 2;
+}